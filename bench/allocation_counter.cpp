@@ -0,0 +1,71 @@
+#include "allocation_counter.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<int64_t> allocation_count{0};
+std::atomic<int64_t> allocated_bytes{0};
+std::atomic<int64_t> live_bytes{0};
+std::atomic<int64_t> peak_bytes{0};
+
+// Chaque bloc commence par sa taille, pour que delete sache combien d'octets sont libérés même sans la taille en paramètre.
+// L'en-tête occupe un alignement complet, pour que le pointeur rendu reste aligné comme celui de malloc.
+constexpr std::size_t header_size = alignof(std::max_align_t);
+
+void* allocate(std::size_t size) noexcept
+{
+    void* block = std::malloc(size + header_size);
+    if (!block) return nullptr;
+    *static_cast<std::size_t*>(block) = size;
+
+    const int64_t bytes = static_cast<int64_t>(size);
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    const int64_t live = live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+
+    return static_cast<char*>(block) + header_size;
+}
+
+void* allocate_or_throw(std::size_t size)
+{
+    void* ptr = allocate(size);
+    if (!ptr) throw std::bad_alloc{};
+    return ptr;
+}
+
+void deallocate(void* ptr) noexcept
+{
+    if (!ptr) return;
+    void* block = static_cast<char*>(ptr) - header_size;
+    live_bytes.fetch_sub(static_cast<int64_t>(*static_cast<std::size_t*>(block)), std::memory_order_relaxed);
+    std::free(block);
+}
+
+} // namespace
+
+AllocationStats allocation_stats()
+{
+    return AllocationStats{allocation_count.load(), allocated_bytes.load(), live_bytes.load(), peak_bytes.load()};
+}
+
+void reset_allocation_peak()
+{
+    peak_bytes.store(live_bytes.load());
+}
+
+void* operator new(std::size_t size) { return allocate_or_throw(size); }
+void* operator new[](std::size_t size) { return allocate_or_throw(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void operator delete(void* ptr) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
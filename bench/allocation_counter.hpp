@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * Compteurs des allocations faites avec new / delete (et donc par std::vector, std::string, std::make_unique, ...) dans tout le programme.
+ * Ils ne sont disponibles que dans les programmes qui compilent allocation_counter.cpp, qui remplace les opérateurs new et delete globaux (bench).
+ * Les allocations faites directement avec malloc (décodeurs et encodeurs stb) ne sont pas comptées.
+ */
+struct AllocationStats
+{
+    int64_t count{0};      // Nombre d'allocations
+    int64_t bytes{0};      // Total des octets alloués
+    int64_t live_bytes{0}; // Octets alloués et pas encore libérés
+    int64_t peak_bytes{0}; // Plus grande valeur de live_bytes depuis le début du programme ou le dernier reset_allocation_peak()
+};
+
+AllocationStats allocation_stats();
+
+/// Ramène le pic aux octets actuellement alloués, pour mesurer le pic du code qui suit.
+void reset_allocation_peak();
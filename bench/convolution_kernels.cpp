@@ -0,0 +1,72 @@
+#include <static_convolution.hpp>
+#include <random.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Compare, pour chaque noyau de getKernel(), la boucle générique sur les 9 poids (convolution_runtime) et la version compilée (convolution_static)
+ * sur une image de 12 MP (4000 x 3000). Affiche aussi l'écart maximal entre les deux résultats (l'ordre des additions change).
+ */
+
+static sil::Image make_source_image(int width, int height)
+{
+    set_random_seed(0);
+    sil::Image img{width, height};
+    for (glm::vec3& color : img.pixels())
+    {
+        color = glm::vec3{random_float(0.f, 1.f), random_float(0.f, 1.f), random_float(0.f, 1.f)};
+    }
+    return img;
+}
+
+template<typename Func>
+static double median_time(const sil::Image& source, int repetitions, Func&& func, sil::Image& result)
+{
+    std::vector<double> timings;
+    for (int i{0}; i < repetitions; i++)
+    {
+        result = source;
+        const auto start = std::chrono::steady_clock::now();
+        func(result);
+        const auto end = std::chrono::steady_clock::now();
+        timings.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(timings.begin(), timings.end());
+    return timings[timings.size() / 2];
+}
+
+template<StaticKernel K>
+static void run(const std::string& name, const sil::Image& source, int repetitions)
+{
+    const std::vector<std::vector<float>> kernel = K.to_vector();
+    sil::Image loop_result{1, 1};
+    sil::Image static_result{1, 1};
+    const double loop_time = median_time(source, repetitions, [&](sil::Image& img) { convolution_runtime(img, kernel); }, loop_result);
+    const double static_time = median_time(source, repetitions, [](sil::Image& img) { convolution_static<K>(img); }, static_result);
+
+    float max_error = 0.f;
+    for (size_t i{0}; i < source.pixels().size(); i++)
+    {
+        const glm::vec3 error = glm::abs(loop_result.pixels()[i] - static_result.pixels()[i]);
+        max_error = std::max({max_error, error.r, error.g, error.b});
+    }
+
+    std::cout << name << ": loop " << loop_time << " ms, static " << static_time << " ms (x" << loop_time / static_time << "), max error " << max_error << "\n";
+}
+
+int main()
+{
+    const sil::Image source = make_source_image(4000, 3000);
+    const int repetitions = 5;
+
+    run<kernels::identity>("Identity", source, repetitions);
+    run<kernels::blur>("Blur", source, repetitions);
+    run<kernels::sharpen>("Sharpen", source, repetitions);
+    run<kernels::edge_detection>("EdgeDetection", source, repetitions);
+
+    return 0;
+}
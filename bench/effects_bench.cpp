@@ -0,0 +1,499 @@
+#include "allocation_counter.hpp"
+#include <effects.hpp>
+#include <image_u8.hpp>
+#include <random.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Mesure chaque effet de effects.hpp et chaque chemin de chargement / enregistrement d'image sur des images synthétiques de 256² à 8K.
+ * Les images et les effets aléatoires utilisent toujours la même graine (set_random_seed(0)) ; chaque mesure est précédée de tours d'échauffement.
+ * Pour chaque cas, le nombre d'allocations, les octets alloués et le pic de mémoire pendant la partie mesurée sont relevés par allocation_counter.cpp,
+ * ainsi que le pic de mémoire des sil::Image si sil est compilée avec SIL_MEMORY_STATS (cmake -DSIL_MEMORY_STATS=ON).
+ * Les résultats (médiane, 95e centile, pixels/s, octets/s et mémoire) sont écrits en JSON, un cas par ligne, sur la sortie standard ou dans le fichier --output ;
+ * la progression et la comparaison sont affichées sur la sortie d'erreur.
+ * Avec --compare, les médianes sont comparées à celles d'un fichier JSON enregistré auparavant et le programme échoue si l'une d'elles a ralenti de plus du seuil.
+ *
+ * Usage : bench [--sizes 256,1024,4K,8K] [--filter texte] [--warmup 1] [--repetitions 10] [--max-time 2]
+ *               [--output resultats.json] [--compare reference.json] [--threshold 10]
+ */
+
+namespace {
+
+struct Size
+{
+    std::string name;
+    int width;
+    int height;
+};
+
+const std::vector<Size> all_sizes = {
+    {"256", 256, 256},
+    {"1024", 1024, 1024},
+    {"4K", 3840, 2160},
+    {"8K", 7680, 4320},
+};
+
+/**
+ * Cas mesuré : `run` renvoie la durée en millisecondes de la partie mesurée (la copie de l'image source n'en fait pas partie),
+ * et le nombre d'octets traités (image en mémoire ou fichier).
+ */
+struct Measure
+{
+    double ms;
+    std::uintmax_t bytes;
+    struct Memory
+    {
+        int64_t allocations{0};
+        int64_t allocated_bytes{0};
+        int64_t peak_heap_bytes{0};  // Pic des octets alloués en plus de ceux qui l'étaient au début (l'image d'entrée n'est donc pas comptée)
+        int64_t peak_image_bytes{0}; // Même chose pour les pixels des sil::Image (0 sans SIL_MEMORY_STATS)
+    } memory;
+};
+
+/**
+ * Relève les compteurs d'allocations à sa construction, juste avant la partie mesurée, et renvoie avec result() ce qui a été alloué depuis.
+ */
+class MemoryProbe
+{
+public:
+    MemoryProbe()
+    {
+        reset_allocation_peak();
+        sil::reset_image_memory_peak();
+        _heap = allocation_stats();
+        _images = sil::image_memory_stats();
+    }
+
+    Measure::Memory result() const
+    {
+        const AllocationStats heap = allocation_stats();
+        const sil::ImageMemoryStats images = sil::image_memory_stats();
+        return Measure::Memory{heap.count - _heap.count, heap.bytes - _heap.bytes, heap.peak_bytes - _heap.live_bytes, images.peak_bytes - _images.live_bytes};
+    }
+
+private:
+    AllocationStats _heap;
+    sil::ImageMemoryStats _images;
+};
+
+struct BenchCase
+{
+    std::string name;
+    std::function<Measure(const sil::Image& source)> run;
+    int max_pixels{0}; // Taille d'image au-delà de laquelle le cas est ignoré (0 = pas de limite)
+};
+
+struct Result
+{
+    std::string name;
+    std::string size;
+    int width{0};
+    int height{0};
+    int repetitions{0};
+    double median_ms{0.};
+    double p95_ms{0.};
+    double pixels_per_second{0.};
+    double bytes_per_second{0.};
+    Measure::Memory memory;
+};
+
+struct Options
+{
+    std::vector<std::string> sizes{"256", "1024", "4K", "8K"};
+    std::string filter;
+    int warmup{1};
+    int repetitions{10};
+    double max_time{2.};
+    std::string output;
+    std::string compare;
+    double threshold{10.};
+};
+
+sil::Image make_source_image(int width, int height)
+{
+    set_random_seed(0);
+    sil::Image img{width, height};
+    for (int y{0}; y < height; y++)
+    {
+        for (int x{0}; x < width; x++)
+        {
+            // Dégradé + bruit : les tris, le tramage et les convolutions ont quelque chose à faire
+            const float t = static_cast<float>(x + y) / static_cast<float>(width + height);
+            img.pixel(x, y) = glm::clamp(glm::vec3{t, 1.f - t, 0.5f} + glm::vec3{random_float(-0.1f, 0.1f)}, 0.f, 1.f);
+        }
+    }
+    return img;
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// Effet sur une copie de l'image source ; la graine est remise à zéro avant chaque appel pour que les effets aléatoires fassent toujours le même travail.
+BenchCase effect(std::string name, std::function<void(sil::Image&)> func, int max_pixels = 0)
+{
+    return BenchCase{std::move(name), [func](const sil::Image& source) {
+        sil::Image img = source;
+        set_random_seed(0);
+        const MemoryProbe probe;
+        const auto start = std::chrono::steady_clock::now();
+        func(img);
+        const double ms = elapsed_ms(start);
+        return Measure{ms, source.pixels().size() * sizeof(glm::vec3), probe.result()};
+    }, max_pixels};
+}
+
+/// Effet sur les octets de l'image (ImageU8).
+BenchCase effect_u8(std::string name, std::function<void(ImageU8&)> func)
+{
+    return BenchCase{std::move(name), [func](const sil::Image& source) {
+        ImageU8 img{source};
+        const MemoryProbe probe;
+        const auto start = std::chrono::steady_clock::now();
+        func(img);
+        const double ms = elapsed_ms(start);
+        return Measure{ms, img.data().size(), probe.result()};
+    }};
+}
+
+std::filesystem::path temporary_file(const std::string& extension)
+{
+    return std::filesystem::temp_directory_path() / ("image_editor_bench" + extension);
+}
+
+BenchCase save_case(std::string name, const std::string& extension)
+{
+    return BenchCase{std::move(name), [extension](const sil::Image& source) {
+        sil::Image img = source;
+        const std::filesystem::path path = temporary_file(extension);
+        const MemoryProbe probe;
+        const auto start = std::chrono::steady_clock::now();
+        img.save(path);
+        const double ms = elapsed_ms(start);
+        return Measure{ms, std::filesystem::file_size(path), probe.result()};
+    }};
+}
+
+BenchCase save_u8_case(std::string name, const std::string& extension)
+{
+    return BenchCase{std::move(name), [extension](const sil::Image& source) {
+        const ImageU8 img{source};
+        const std::filesystem::path path = temporary_file(extension);
+        const MemoryProbe probe;
+        const auto start = std::chrono::steady_clock::now();
+        img.save(path);
+        const double ms = elapsed_ms(start);
+        return Measure{ms, std::filesystem::file_size(path), probe.result()};
+    }};
+}
+
+/// Chargement d'un fichier écrit (hors mesure) à partir de l'image source, réécrit seulement quand la taille de l'image change.
+BenchCase load_case(std::string name, const std::string& extension)
+{
+    auto written = std::make_shared<std::pair<int, int>>(0, 0);
+    return BenchCase{std::move(name), [extension, written](const sil::Image& source) {
+        const std::filesystem::path path = temporary_file(extension);
+        if (*written != std::pair{source.width(), source.height()})
+        {
+            sil::Image{source}.save(path);
+            *written = {source.width(), source.height()};
+        }
+        const MemoryProbe probe;
+        const auto start = std::chrono::steady_clock::now();
+        const sil::Image img{path};
+        const double ms = elapsed_ms(start);
+        return Measure{ms, std::filesystem::file_size(path), probe.result()};
+    }};
+}
+
+std::vector<BenchCase> make_cases()
+{
+    const int mosaic_limit = 1024 * 1024; // La mosaïque est 25 fois plus grande que l'image source
+
+    return {
+        effect("keep_green_only", [](sil::Image& img) { keep_green_only(img); }),
+        effect("channels_swap", [](sil::Image& img) { channels_swap(img); }),
+        effect("black_and_white", [](sil::Image& img) { black_and_white(img); }),
+        effect("negative", [](sil::Image& img) { negative(img); }),
+        effect("gradient", [](sil::Image& img) { gradient(img); }),
+        effect("mirror_horizontal", [](sil::Image& img) { mirror(img, Mirror::Horizontal); }),
+        effect("mirror_vertical", [](sil::Image& img) { mirror(img, Mirror::Vertical); }),
+        effect("mirror_both", [](sil::Image& img) { mirror(img, Mirror::Both); }),
+        effect("noisy", [](sil::Image& img) { noisy(img); }),
+        effect("rotate90", [](sil::Image& img) { rotate90(img); }),
+        effect("splitRGB", [](sil::Image& img) { splitRGB(img); }),
+        effect("brightness_darker", [](sil::Image& img) { brightness(img, Brightness::Darker); }),
+        effect("brightness_brighter", [](sil::Image& img) { brightness(img, Brightness::Brighter); }),
+        effect("disk", [](sil::Image& img) { disk(img); }),
+        effect("circle", [](sil::Image& img) { circle(img); }),
+        effect("rosette", [](sil::Image& img) { rosette(img); }),
+        effect("mosaic", [](sil::Image& img) { mosaic(img); }, mosaic_limit),
+        effect("mosaic_mirror", [](sil::Image& img) { mosaic_mirror(img); }, mosaic_limit),
+        effect("glitch", [](sil::Image& img) { glitch(img); }),
+        effect("pixelSort", [](sil::Image& img) { pixelSort(img); }),
+        effect("mandelbrotFractal", [](sil::Image& img) { mandelbrotFractal(img); }),
+        effect("convolution_identity", [](sil::Image& img) { convolution(img, Kernel::Identity); }),
+        effect("convolution_blur", [](sil::Image& img) { convolution(img, Kernel::Blur); }),
+        effect("convolution_sharpen", [](sil::Image& img) { convolution(img, Kernel::Sharpen); }),
+        effect("convolution_edge_detection", [](sil::Image& img) { convolution(img, Kernel::EdgeDetection); }),
+        effect("convolution_box_blur", [](sil::Image& img) { convolution(img, Kernel::BoxBlur); }),
+        effect_u8("convolution_sharpen_u8", [](ImageU8& img) { convolution(img, Kernel::Sharpen); }),
+        effect("gaussienne_difference", [](sil::Image& img) { gaussienne_difference(img); }),
+        effect("kuwahara", [](sil::Image& img) { kuwahara(img); }),
+        effect("dithering_color", [](sil::Image& img) { dithering(img, true); }),
+        effect("dithering_gray", [](sil::Image& img) { dithering(img, false); }),
+        effect("pixelated", [](sil::Image& img) { pixelated(img); }),
+        effect("differential", [](sil::Image& img) { differential(img, false); }),
+        save_case("save_png", ".png"),
+        save_case("save_jpg", ".jpg"),
+        save_u8_case("save_u8_png", ".png"),
+        save_u8_case("save_u8_jpg", ".jpg"),
+        load_case("load_png", ".png"),
+        load_case("load_jpg", ".jpg"),
+    };
+}
+
+/// Centile par la méthode du rang le plus proche, sur des durées triées.
+double percentile(const std::vector<double>& sorted, double p)
+{
+    const int rank = static_cast<int>(std::ceil(p / 100. * static_cast<double>(sorted.size())));
+    return sorted[std::clamp(rank - 1, 0, static_cast<int>(sorted.size()) - 1)];
+}
+
+Result measure(const BenchCase& bench_case, const Size& size, const sil::Image& source, const Options& options)
+{
+    for (int i{0}; i < options.warmup; i++) bench_case.run(source);
+
+    // Au moins 3 mesures, puis on s'arrête à `repetitions` mesures ou quand le temps mesuré dépasse max_time secondes
+    std::vector<double> timings;
+    std::uintmax_t bytes = 0;
+    Measure::Memory memory;
+    double total_ms = 0.;
+    while (static_cast<int>(timings.size()) < std::max(options.repetitions, 1))
+    {
+        const Measure m = bench_case.run(source);
+        timings.push_back(m.ms);
+        bytes = m.bytes;
+        memory = m.memory;
+        total_ms += m.ms;
+        if (timings.size() >= 3 && total_ms > options.max_time * 1000.) break;
+    }
+    std::sort(timings.begin(), timings.end());
+
+    Result result;
+    result.name = bench_case.name;
+    result.size = size.name;
+    result.width = size.width;
+    result.height = size.height;
+    result.repetitions = static_cast<int>(timings.size());
+    result.median_ms = percentile(timings, 50.);
+    result.p95_ms = percentile(timings, 95.);
+    const double seconds = std::max(result.median_ms, 1e-6) / 1000.;
+    result.pixels_per_second = static_cast<double>(size.width) * size.height / seconds;
+    result.bytes_per_second = static_cast<double>(bytes) / seconds;
+    result.memory = memory;
+    return result;
+}
+
+std::string key(const std::string& name, const std::string& size)
+{
+    return name + "@" + size;
+}
+
+void write_json(std::ostream& out, const std::vector<Result>& results, const Options& options)
+{
+    out << "{\n";
+    out << "  \"seed\": 0,\n";
+    out << "  \"warmup\": " << options.warmup << ",\n";
+    out << "  \"results\": [\n";
+    out << std::setprecision(6);
+    for (size_t i{0}; i < results.size(); i++)
+    {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"size\": \"" << r.size << "\", \"width\": " << r.width << ", \"height\": " << r.height
+            << ", \"repetitions\": " << r.repetitions << ", \"median_ms\": " << r.median_ms << ", \"p95_ms\": " << r.p95_ms
+            << ", \"pixels_per_second\": " << r.pixels_per_second << ", \"bytes_per_second\": " << r.bytes_per_second
+            << ", \"allocations\": " << r.memory.allocations << ", \"allocated_bytes\": " << r.memory.allocated_bytes
+            << ", \"peak_heap_bytes\": " << r.memory.peak_heap_bytes;
+#if defined(SIL_MEMORY_STATS)
+        out << ", \"peak_image_bytes\": " << r.memory.peak_image_bytes;
+#endif
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+/// Valeur du champ `field` dans une ligne écrite par write_json() (chaîne sans guillemets, ou nombre).
+std::string json_field(const std::string& line, const std::string& field)
+{
+    const std::string pattern = "\"" + field + "\": ";
+    const size_t start = line.find(pattern);
+    if (start == std::string::npos) return {};
+    size_t begin = start + pattern.size();
+    if (line[begin] == '"')
+    {
+        begin++;
+        return line.substr(begin, line.find('"', begin) - begin);
+    }
+    return line.substr(begin, line.find_first_of(",}", begin) - begin);
+}
+
+/// Médianes d'un fichier écrit par write_json(), indexées par key(nom, taille). Seul ce format (un cas par ligne) est reconnu.
+std::map<std::string, double> read_baseline(const std::string& filename)
+{
+    std::map<std::string, double> medians;
+    std::ifstream file{filename};
+    if (!file)
+    {
+        std::cerr << "Impossible d'ouvrir " << filename << "\n";
+        return medians;
+    }
+    std::string line;
+    while (std::getline(file, line))
+    {
+        const std::string name = json_field(line, "name");
+        const std::string median = json_field(line, "median_ms");
+        if (name.empty() || median.empty()) continue;
+        medians[key(name, json_field(line, "size"))] = std::stod(median);
+    }
+    return medians;
+}
+
+/// Affiche l'évolution de chaque médiane et renvoie le nombre de cas ralentis de plus de `threshold` pour cent.
+int compare(const std::vector<Result>& results, const std::map<std::string, double>& baseline, double threshold)
+{
+    int regressions = 0;
+    std::cerr << std::fixed << std::setprecision(3);
+    for (const Result& r : results)
+    {
+        const auto it = baseline.find(key(r.name, r.size));
+        if (it == baseline.end())
+        {
+            std::cerr << key(r.name, r.size) << ": " << r.median_ms << " ms (absent de la référence)\n";
+            continue;
+        }
+        const double change = (r.median_ms / std::max(it->second, 1e-6) - 1.) * 100.;
+        const bool regression = change > threshold;
+        if (regression) regressions++;
+        std::cerr << key(r.name, r.size) << ": " << it->second << " ms -> " << r.median_ms << " ms (" << std::showpos << std::setprecision(1) << change
+                  << std::noshowpos << std::setprecision(3) << " %)" << (regression ? "  REGRESSION" : "") << "\n";
+    }
+    std::cerr << regressions << " régression(s) au-delà de " << std::setprecision(1) << threshold << " %\n";
+    return regressions;
+}
+
+std::vector<std::string> split(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream stream{list};
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+bool parse_options(int argc, char** argv, Options& options)
+{
+    for (int i{1}; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Valeur manquante après " << arg << "\n";
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--sizes") options.sizes = split(value);
+        else if (arg == "--filter") options.filter = value;
+        else if (arg == "--warmup") options.warmup = std::stoi(value);
+        else if (arg == "--repetitions") options.repetitions = std::stoi(value);
+        else if (arg == "--max-time") options.max_time = std::stod(value);
+        else if (arg == "--output") options.output = value;
+        else if (arg == "--compare") options.compare = value;
+        else if (arg == "--threshold") options.threshold = std::stod(value);
+        else
+        {
+            std::cerr << "Option inconnue : " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options)) return 2;
+
+    const std::vector<BenchCase> cases = make_cases();
+    std::vector<Result> results;
+
+    for (const std::string& size_name : options.sizes)
+    {
+        const auto size = std::find_if(all_sizes.begin(), all_sizes.end(), [&](const Size& s) { return s.name == size_name; });
+        if (size == all_sizes.end())
+        {
+            std::cerr << "Taille inconnue : " << size_name << " (256, 1024, 4K ou 8K)\n";
+            return 2;
+        }
+
+        const sil::Image source = make_source_image(size->width, size->height);
+        for (const BenchCase& bench_case : cases)
+        {
+            if (!options.filter.empty() && bench_case.name.find(options.filter) == std::string::npos) continue;
+            if (bench_case.max_pixels > 0 && size->width * size->height > bench_case.max_pixels) continue;
+
+            const Result result = measure(bench_case, *size, source, options);
+            std::cerr << std::left << std::setw(28) << result.name << std::setw(6) << result.size << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(12) << result.median_ms << " ms  p95 " << std::setw(12) << result.p95_ms << " ms  "
+                      << std::setprecision(1) << std::setw(10) << result.pixels_per_second / 1e6 << " Mpixels/s  " << std::setw(7) << result.memory.allocations
+                      << " allocations, pic " << std::setw(8) << static_cast<double>(result.memory.peak_heap_bytes) / (1024. * 1024.) << " Mo\n";
+            results.push_back(result);
+        }
+    }
+
+    for (const char* extension : {".png", ".jpg"})
+    {
+        std::error_code error;
+        std::filesystem::remove(temporary_file(extension), error);
+    }
+
+    if (options.output.empty())
+    {
+        write_json(std::cout, results, options);
+    }
+    else
+    {
+        std::ofstream file{options.output};
+        write_json(file, results, options);
+    }
+
+    if (!options.compare.empty())
+    {
+        const std::map<std::string, double> baseline = read_baseline(options.compare);
+        if (baseline.empty()) return 2;
+        if (compare(results, baseline, options.threshold) > 0) return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <resize.hpp>
+#include <random.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Mesure le temps de création d'une miniature 256 px à partir d'une image de 24 MP (6000 x 4000) pour chaque filtre.
+ * L'image source est reconstruite avant chaque mesure puisque resize() la modifie en place.
+ */
+
+static sil::Image make_source_image(int width, int height)
+{
+    set_random_seed(0);
+    sil::Image img{width, height};
+    for (int y{0}; y < height; y++)
+    {
+        for (int x{0}; x < width; x++)
+        {
+            // Dégradé + bruit, pour que les poids négatifs des filtres aient quelque chose à faire
+            const float t = static_cast<float>(x + y) / static_cast<float>(width + height);
+            img.pixel(x, y) = glm::vec3{t, 1.f - t, 0.5f} + glm::vec3{random_float(-0.1f, 0.1f)};
+        }
+    }
+    return img;
+}
+
+int main()
+{
+    const int width = 6000;
+    const int height = 4000;
+    const int repetitions = 3;
+    const sil::Image source = make_source_image(width, height);
+
+    const std::vector<std::pair<std::string, ResizeFilter>> filters = {
+        {"Lanczos3", ResizeFilter::Lanczos3},
+        {"Mitchell", ResizeFilter::Mitchell},
+        {"CatmullRom", ResizeFilter::CatmullRom},
+        {"Area", ResizeFilter::Area},
+    };
+
+    for (const auto& [name, filter] : filters)
+    {
+        std::vector<double> timings;
+        for (int i{0}; i < repetitions; i++)
+        {
+            sil::Image img = source;
+            const auto start = std::chrono::steady_clock::now();
+            resize(img, 256, 171, filter);
+            const auto end = std::chrono::steady_clock::now();
+            timings.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        std::sort(timings.begin(), timings.end());
+        const double median = timings[timings.size() / 2];
+        std::cout << name << ": " << median << " ms (" << width * static_cast<double>(height) / (median * 1000.) << " Mpixels/s)\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,310 @@
+#include <effects.hpp>
+#include <image_compare.hpp>
+#include <image_u8.hpp>
+#include <resize.hpp>
+#include <pyramid.hpp>
+#include <remap.hpp>
+#include <median.hpp>
+#include <bilateral.hpp>
+#include <guided.hpp>
+#include <morphology.hpp>
+#include <edges.hpp>
+#include <convolve.hpp>
+#include <convolution_u8.hpp>
+#include <stencil_pipeline.hpp>
+#include <effect_graph.hpp>
+#include <random.hpp>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Compare le résultat de chaque effet, sur des images d'entrée et une graine fixes, à une image de référence enregistrée dans golden/reference.
+ * Chaque effet a sa tolérance : identique au bit près pour les effets sans calcul flottant sensible à l'ordre des opérations,
+ * écart maximal, PSNR et SSIM minimaux pour ceux qu'une optimisation (SIMD, virgule fixe, FFT, ...) peut légèrement changer.
+ * Les comparaisons se font sur les images 8 bits, c'est-à-dire sur ce qu'enregistre Image::save().
+ * Quelques cas comparent plutôt un effet optimisé à son implémentation de référence (directe et lente), recalculée à chaque exécution.
+ *
+ * Usage : golden [--filter texte]   compare et renvoie 1 si un effet sort de sa tolérance
+ *         golden --update [--filter texte]   réécrit les images de référence
+ */
+
+namespace {
+
+const std::filesystem::path reference_directory = "golden/reference"; // Relatif au dossier du CMakeLists.txt, comme les chemins de sil::Image
+
+/**
+ * Écart toléré par rapport à l'image de référence. Avec max_abs_error = 0, l'image doit être identique au bit près.
+ */
+struct Tolerance
+{
+    int max_abs_error{0};
+    double min_psnr{0.};
+    double min_ssim{0.};
+};
+
+constexpr Tolerance exact{};
+constexpr Tolerance close{2, 45., 0.995};  // Arrondis différents (ordre des additions, virgule fixe)
+constexpr Tolerance approx{8, 35., 0.98}; // Approximations plus fortes (FFT, grille sous-échantillonnée)
+constexpr Tolerance bilateral_grid{24, 38., 0.98}; // Grille bilatérale comparée au filtre direct : quelques pixels de contours s'écartent nettement
+
+struct GoldenCase
+{
+    std::string name;
+    std::function<sil::Image()> render;
+    Tolerance tolerance;
+    std::function<sil::Image()> expected; // Si présent, l'image attendue est calculée (implémentation de référence) au lieu d'être lue dans golden/reference
+};
+
+/// Logo entier (300 x 345, aplats de couleur).
+sil::Image logo()
+{
+    return sil::Image{"images/logo.png"};
+}
+
+/// Visage de la photo, recadré en 128 x 128 pour que les images de référence restent petites.
+sil::Image photo()
+{
+    const sil::Image full{"images/photo.jpg"};
+    sil::Image crop{128, 128};
+    for (int y{0}; y < crop.height(); y++)
+    {
+        for (int x{0}; x < crop.width(); x++) crop.pixel(x, y) = full.pixel(356 + x, 266 + y);
+    }
+    return crop;
+}
+
+/// Image de départ, effet appliqué en place avec la graine remise à zéro.
+GoldenCase effect(std::string name, std::function<sil::Image()> input, std::function<void(sil::Image&)> func, Tolerance tolerance = exact)
+{
+    return GoldenCase{std::move(name), [input, func]() {
+        sil::Image img = input();
+        set_random_seed(0);
+        func(img);
+        return img;
+    }, tolerance, {}};
+}
+
+/// Comme effect(), mais comparé au résultat de `reference` sur la même image (une version directe et lente du même calcul), sans image enregistrée.
+GoldenCase cross_check(std::string name, std::function<sil::Image()> input, std::function<void(sil::Image&)> func, std::function<void(sil::Image&)> reference,
+                       Tolerance tolerance = exact)
+{
+    GoldenCase golden_case = effect(std::move(name), input, std::move(func), tolerance);
+    golden_case.expected = [input, reference]() {
+        sil::Image img = input();
+        set_random_seed(0);
+        reference(img);
+        return img;
+    };
+    return golden_case;
+}
+
+/// Convolution 8 bits d'un noyau de getKernel() (qui doit passer par la virgule fixe), comparée octet par octet à convolution_reference().
+GoldenCase convolution_u8_check(std::string name, std::function<sil::Image()> input, Kernel type)
+{
+    return cross_check(std::move(name), std::move(input), [type](sil::Image& img) {
+        FixedPointKernel fixed;
+        if (!to_fixed_point(getKernel(type), fixed)) throw std::logic_error{"Ce noyau n'est plus exact en virgule fixe"};
+        ImageU8 bytes{img};
+        convolution(bytes, getKernel(type));
+        img = bytes.to_image();
+    }, [type](sil::Image& img) {
+        ImageU8 bytes{img};
+        convolution_reference(bytes, getKernel(type));
+        img = bytes.to_image();
+    });
+}
+
+std::vector<GoldenCase> make_cases()
+{
+    const auto canvas = []() { return sil::Image{200, 200}; };
+
+    return {
+        effect("keep_green_only", logo, [](sil::Image& img) { keep_green_only(img); }),
+        effect("channels_swap", logo, [](sil::Image& img) { channels_swap(img); }),
+        effect("black_and_white", logo, [](sil::Image& img) { black_and_white(img); }),
+        effect("negative", logo, [](sil::Image& img) { negative(img); }),
+        effect("gradient", canvas, [](sil::Image& img) { gradient(img); }),
+        effect("mirror_horizontal", logo, [](sil::Image& img) { mirror(img, Mirror::Horizontal); }),
+        effect("mirror_vertical", logo, [](sil::Image& img) { mirror(img, Mirror::Vertical); }),
+        effect("mirror_both", logo, [](sil::Image& img) { mirror(img, Mirror::Both); }),
+        effect("noisy", logo, [](sil::Image& img) { noisy(img); }),
+        effect("rotate90", logo, [](sil::Image& img) { rotate90(img); }),
+        effect("splitRGB", logo, [](sil::Image& img) { splitRGB(img); }),
+        effect("brightness_darker", photo, [](sil::Image& img) { brightness(img, Brightness::Darker); }),
+        effect("brightness_brighter", photo, [](sil::Image& img) { brightness(img, Brightness::Brighter); }),
+        effect("disk", canvas, [](sil::Image& img) { disk(img, 80.f); }),
+        effect("circle", canvas, [](sil::Image& img) { circle(img, 80.f); }),
+        effect("rosette", canvas, [](sil::Image& img) { rosette(img, 6, 0.5f, 50.f); }),
+        effect("mosaic", logo, [](sil::Image& img) { mosaic(img, 2); }),
+        effect("mosaic_mirror", logo, [](sil::Image& img) { mosaic_mirror(img, 2); }),
+        effect("glitch", logo, [](sil::Image& img) { glitch(img); }),
+        effect("pixelSort", logo, [](sil::Image& img) { pixelSort(img); }),
+        effect("mandelbrotFractal", canvas, [](sil::Image& img) { mandelbrotFractal(img); }, close),
+        effect("convolution_identity", photo, [](sil::Image& img) { convolution(img, Kernel::Identity); }),
+        effect("convolution_blur", photo, [](sil::Image& img) { convolution(img, Kernel::Blur); }, close),
+        effect("convolution_sharpen", photo, [](sil::Image& img) { convolution(img, Kernel::Sharpen); }, close),
+        effect("convolution_edge_detection", photo, [](sil::Image& img) { convolution(img, Kernel::EdgeDetection); }, close),
+        effect("convolution_box_blur", photo, [](sil::Image& img) { convolution(img, Kernel::BoxBlur); }, close),
+        effect("convolution_sharpen_u8", photo, [](sil::Image& img) {
+            ImageU8 bytes{img};
+            convolution(bytes, Kernel::Sharpen);
+            img = bytes.to_image();
+        }),
+        // Le logo a une largeur qui n'est pas multiple de la largeur des registres SIMD
+        convolution_u8_check("fixed_point_blur", logo, Kernel::Blur),
+        convolution_u8_check("fixed_point_sharpen", logo, Kernel::Sharpen),
+        convolution_u8_check("fixed_point_edge_detection", logo, Kernel::EdgeDetection),
+        effect("convolution_chain", photo, [](sil::Image& img) {
+            StencilPipeline chain;
+            box_blur(chain, 5).then(kernel_stage<kernels::sharpen>()).then(kernel_stage<kernels::edge_detection>());
+            chain.run(img);
+        }, close),
+        effect("gaussienne_difference", photo, [](sil::Image& img) { gaussienne_difference(img); }, close),
+        effect("kuwahara", photo, [](sil::Image& img) { kuwahara(img); }, close),
+        effect("dithering_color", photo, [](sil::Image& img) { dithering(img, true); }, close),
+        effect("dithering_gray", photo, [](sil::Image& img) { dithering(img, false); }, close),
+        effect("pixelated", logo, [](sil::Image& img) { pixelated(img); }),
+        effect("differential", logo, [](sil::Image& img) { differential(img, false); }),
+        effect("thumbnail", photo, [](sil::Image& img) { thumbnail(img, 64); }, close),
+        effect("resize_mitchell", photo, [](sil::Image& img) { resize(img, 200, 150, ResizeFilter::Mitchell); }, close),
+        effect("resize_area", photo, [](sil::Image& img) { resize(img, 50, 50, ResizeFilter::Area); }, close),
+        effect("pyramid_blur", photo, [](sil::Image& img) { pyramid_blur(img, 2); }, close),
+        effect("pyramid_blend", photo, [](sil::Image& img) {
+            sil::Image mask{img.width(), img.height()};
+            disk(mask, 40.f);
+            sil::Image other = img;
+            negative(other);
+            pyramid_blend(img, other, mask, 4);
+        }, close),
+        effect("lens_barrel", photo, [](sil::Image& img) { lens_distortion_remap(img.width(), img.height(), 0.3f).apply(img); }, close),
+        cross_check("lens_single_pixel", [] { // Le centre est sur l'unique pixel : la distorsion ne le déplace pas
+            sil::Image pixel{1, 1};
+            pixel.pixel(0, 0) = glm::vec3{0.2f, 0.5f, 0.8f};
+            return pixel;
+        }, [](sil::Image& img) { lens_distortion_remap(1, 1, 0.3f).apply(img); }, [](sil::Image&) {}),
+        effect("chromatic_aberration", photo, [](sil::Image& img) { chromatic_aberration_remap(img.width(), img.height(), 0.02f).apply(img); }, close),
+        effect("graph_crop", photo, [](sil::Image& img) {
+            EffectGraph graph{32};
+            const EffectGraph::Node source = graph.source(img);
+            const EffectGraph::Node darker = graph.pointwise(source, [](sil::Image& region) { brightness(region, Brightness::Darker); });
+            const EffectGraph::Node sharpen = graph.neighborhood(darker, 1, [](sil::Image& region) { convolution(region, Kernel::Sharpen); });
+            img = graph.compute(sharpen, Rect{20, 30, 100, 90});
+        }, close),
+        effect("median_3x3", logo, [](sil::Image& img) {
+            noisy(img);
+            median_filter(img, 1);
+        }),
+        effect("median_5x5", logo, [](sil::Image& img) {
+            noisy(img);
+            median_filter(img, 2);
+        }),
+        effect("median_radius_5", photo, [](sil::Image& img) { median_filter(img, 5); }),
+        effect("bilateral", photo, [](sil::Image& img) { bilateral_filter(img, 8.f, 0.1f); }, approx),
+        cross_check("bilateral_vs_reference", photo, [](sil::Image& img) { bilateral_filter(img, 4.f, 0.1f); },
+                    [](sil::Image& img) { bilateral_filter_reference(img, 4.f, 0.1f); }, bilateral_grid),
+        effect("detail_enhance", photo, [](sil::Image& img) { detail_enhance(img, 3.f); }, close),
+        effect("guided_mask", photo, [](sil::Image& img) {
+            const sil::Image guide = img;
+            img = sil::Image{guide.width(), guide.height()};
+            disk(img, 30.f);
+            guided_filter(img, guide, 8, 1e-4f, GuideMode::Color, 2);
+        }, approx),
+        effect("morphological_gradient", photo, [](sil::Image& img) { morphological_gradient(img, 3, 3); }),
+        effect("opening", photo, [](sil::Image& img) { opening(img, 5, 3); }),
+        effect("dithering_cleaned", photo, [](sil::Image& img) {
+            dithering(img, false);
+            BitImage bits = BitImage::from_image(img);
+            opening(bits, 2, 2);
+            closing(bits, 2, 2);
+            img = bits.to_image();
+        }),
+        effect("sobel", photo, [](sil::Image& img) { sobel(img, GradientOperator::Scharr); }, close),
+        effect("canny", photo, [](sil::Image& img) { canny(img); }, close),
+        effect("gaussian_blur", photo, [](sil::Image& img) { convolve(img, gaussian_kernel(3.f)); }, close),
+        effect("bokeh", photo, [](sil::Image& img) { convolve(img, disk_kernel(12.f)); }, approx),
+        effect("motion_blur", photo, [](sil::Image& img) { convolve(img, motion_blur_kernel(20.f, 30.f)); }, approx),
+    };
+}
+
+bool passes(const ImageDifference& difference, const Tolerance& tolerance)
+{
+    if (difference.identical()) return true;
+    if (!difference.same_size || tolerance.max_abs_error == 0) return false;
+    return difference.max_abs_error <= tolerance.max_abs_error && difference.psnr >= tolerance.min_psnr && difference.ssim >= tolerance.min_ssim;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bool update = false;
+    std::string filter;
+    for (int i{1}; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--update") update = true;
+        else if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+        else
+        {
+            std::cerr << "Usage : golden [--update] [--filter texte]\n";
+            return 2;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    int failures = 0;
+    int checked = 0;
+
+    for (const GoldenCase& golden_case : make_cases())
+    {
+        if (!filter.empty() && golden_case.name.find(filter) == std::string::npos) continue;
+
+        const ImageU8 result{golden_case.render()};
+        const std::filesystem::path path = reference_directory / (golden_case.name + ".png");
+        checked++;
+
+        if (update && !golden_case.expected) // Les comparaisons à une implémentation de référence n'ont rien à enregistrer
+        {
+            result.save(path);
+            std::cout << golden_case.name << ": référence enregistrée\n";
+            continue;
+        }
+
+        std::unique_ptr<ImageU8> reference;
+        try
+        {
+            reference = std::make_unique<ImageU8>(golden_case.expected ? golden_case.expected() : sil::Image{path});
+        }
+        catch (const std::exception&)
+        {
+            std::cout << std::left << std::setw(28) << golden_case.name << "ÉCHEC  pas d'image de référence (golden --update)\n";
+            failures++;
+            continue;
+        }
+
+        const ImageDifference difference = compare_images(result, *reference);
+        const bool ok = passes(difference, golden_case.tolerance);
+        if (!ok) failures++;
+
+        std::cout << std::left << std::setw(28) << golden_case.name << (ok ? "ok     " : "ÉCHEC  ");
+        if (!difference.same_size) std::cout << "taille différente de la référence";
+        else if (difference.identical()) std::cout << "identique";
+        else
+        {
+            std::cout << std::fixed << std::setprecision(2) << difference.differing_values << " valeurs différentes, écart max " << difference.max_abs_error
+                      << ", PSNR " << difference.psnr << " dB, SSIM " << std::setprecision(5) << difference.ssim;
+        }
+        std::cout << "\n";
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << checked << " effets " << (update ? "enregistrés" : "vérifiés") << ", " << failures << " échec(s), " << std::fixed << std::setprecision(2) << seconds << " s\n";
+    return failures > 0 ? 1 : 0;
+}
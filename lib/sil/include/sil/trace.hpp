@@ -0,0 +1,3 @@
+#pragma once
+
+#include "../../src/trace.hpp"
\ No newline at end of file
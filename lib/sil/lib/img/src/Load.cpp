@@ -1,5 +1,6 @@
 #include "Load.h"
 #include <stb_image/stb_image.h>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 
@@ -9,11 +10,16 @@ Image load(std::filesystem::path file_path, int desired_channels_count, bool fli
 {
     stbi_set_flip_vertically_on_load(flip_vertically ? 1 : 0);
     int      w, h; // NOLINT
-    uint8_t* data = stbi_load(file_path.string().c_str(), &w, &h, nullptr, desired_channels_count);
-    if (!data)
+    uint8_t* stb_data = stbi_load(file_path.string().c_str(), &w, &h, nullptr, desired_channels_count);
+    if (!stb_data)
     {
         throw std::runtime_error{"[img::load] Couldn't load image from \"" + file_path.string() + "\":\n" + stbi_failure_reason()};
     }
+    // stb allocates with malloc but Image frees its data with delete[], so the pixels are moved to a buffer allocated with new[]
+    size_t const size = static_cast<size_t>(w) * static_cast<size_t>(h) * static_cast<size_t>(desired_channels_count);
+    auto*        data = new uint8_t[size];
+    std::memcpy(data, stb_data, size);
+    stbi_image_free(stb_data);
     return Image{{
                      static_cast<Size::DataType>(w),
                      static_cast<Size::DataType>(h),
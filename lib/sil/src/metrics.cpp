@@ -0,0 +1,420 @@
+#include "metrics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace sil {
+
+namespace {
+
+using Key = std::pair<std::string, std::string>; // Name, labels
+
+/// Owns every metric. The maps only grow, so the references handed out stay valid; the values themselves are updated without this lock.
+struct MetricsRegistry {
+    std::mutex                                            mutex;
+    std::map<Key, std::unique_ptr<Counter>>               counters;
+    std::map<Key, std::unique_ptr<Gauge>>                 gauges;
+    std::map<Key, std::unique_ptr<LatencyHistogram>>      histograms;
+    std::map<std::string, std::unique_ptr<EffectMetrics>> effects;
+    std::chrono::steady_clock::time_point const           start = std::chrono::steady_clock::now();
+};
+
+MetricsRegistry& registry()
+{
+    static MetricsRegistry instance{}; // Never destroyed before the threads that use it (see trace.cpp)
+    return instance;
+}
+
+template<typename Metric>
+Metric& find_or_create(std::map<Key, std::unique_ptr<Metric>>& metrics, std::string const& name, std::string const& labels)
+{
+    std::lock_guard<std::mutex> lock{registry().mutex};
+    std::unique_ptr<Metric>&    metric = metrics[{name, labels}];
+    if (!metric)
+        metric = std::make_unique<Metric>();
+    return *metric;
+}
+
+/// Upper bounds (in seconds) of the cumulative buckets written for Prometheus: the 608 buckets of a LatencyHistogram would be too many per series.
+constexpr std::array<double, 14> prometheus_bounds{0.00001, 0.0001, 0.0005, 0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1., 5., 30.};
+
+double to_seconds(int64_t nanoseconds)
+{
+    return static_cast<double>(nanoseconds) / 1e9;
+}
+
+std::string with_label(std::string const& labels, std::string const& extra)
+{
+    if (labels.empty())
+        return "{" + extra + "}";
+    return "{" + labels + "," + extra + "}";
+}
+
+std::string braces(std::string const& labels)
+{
+    return labels.empty() ? std::string{} : "{" + labels + "}";
+}
+
+void write_escaped(std::ostream& out, std::string const& text)
+{
+    for (char const c : text)
+    {
+        if (c == '"' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+}
+
+/// Writes labels such as `effect="kuwahara",queue="batch"` as a JSON object.
+void write_labels_json(std::ostream& out, std::string const& labels)
+{
+    out << "{";
+    size_t position = 0;
+    bool   first    = true;
+    while (position < labels.size())
+    {
+        size_t const equal = labels.find('=', position);
+        if (equal == std::string::npos || equal + 1 >= labels.size() || labels[equal + 1] != '"')
+            break;
+        std::string value;
+        size_t      i = equal + 2;
+        for (; i < labels.size() && labels[i] != '"'; ++i)
+        {
+            if (labels[i] == '\\' && i + 1 < labels.size())
+                ++i;
+            value += labels[i];
+        }
+        out << (first ? "" : ", ") << "\"";
+        write_escaped(out, labels.substr(position, equal - position));
+        out << "\": \"";
+        write_escaped(out, value);
+        out << "\"";
+        first    = false;
+        position = i + 2; // Skips the closing quote and the comma
+    }
+    out << "}";
+}
+
+/// Opens a temporary file next to `path`. `commit()` renames it to `path` once everything is written.
+struct AtomicFile {
+    std::filesystem::path path;
+    std::filesystem::path temporary;
+    std::ofstream         out;
+
+    explicit AtomicFile(std::filesystem::path destination)
+        : path{destination.is_relative() ? SIL_CMAKE_SOURCE_DIR / destination : std::move(destination)}
+    {
+        if (path.has_parent_path())
+            std::filesystem::create_directories(path.parent_path());
+        temporary = path;
+        temporary += ".tmp";
+        out.open(temporary);
+        if (!out)
+            throw std::runtime_error{"Could not write the metrics to \"" + temporary.string() + "\""};
+    }
+
+    void commit()
+    {
+        out.close();
+        std::filesystem::rename(temporary, path);
+    }
+};
+
+template<typename Entry>
+Entry const* find_previous(std::vector<Entry> const& previous, Entry const& entry)
+{
+    auto const it = std::find_if(previous.begin(), previous.end(), [&](Entry const& other) { return other.name == entry.name && other.labels == entry.labels; });
+    return it == previous.end() ? nullptr : &*it;
+}
+
+} // namespace
+
+int LatencyHistogram::bucket_index(int64_t nanoseconds)
+{
+    if (nanoseconds < sub_buckets)
+        return nanoseconds < 0 ? 0 : static_cast<int>(nanoseconds);
+    auto const value    = static_cast<uint64_t>(nanoseconds);
+    int        exponent = sub_bucket_bits; // Position of the highest set bit
+    while (exponent < 63 && (value >> (exponent + 1)) != 0)
+        ++exponent;
+    if (exponent > max_exponent)
+        return bucket_count - 1;
+    auto const sub_bucket = static_cast<int>((value >> (exponent - sub_bucket_bits)) & (sub_buckets - 1));
+    return (exponent - sub_bucket_bits + 1) * sub_buckets + sub_bucket;
+}
+
+int64_t LatencyHistogram::bucket_lower_bound(int index)
+{
+    if (index < sub_buckets)
+        return index;
+    int const shift = index / sub_buckets - 1;
+    return static_cast<int64_t>(sub_buckets + index % sub_buckets) << shift;
+}
+
+int64_t LatencyHistogram::bucket_upper_bound(int index)
+{
+    if (index < sub_buckets)
+        return index + 1;
+    int const shift = index / sub_buckets - 1;
+    return static_cast<int64_t>(sub_buckets + index % sub_buckets + 1) << shift;
+}
+
+void LatencyHistogram::record(int64_t nanoseconds)
+{
+    _buckets[static_cast<size_t>(bucket_index(nanoseconds))].fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+    int64_t max = _max.load(std::memory_order_relaxed);
+    while (nanoseconds > max && !_max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+    Snapshot snapshot{};
+    for (size_t i = 0; i < _buckets.size(); ++i)
+    {
+        snapshot.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[i];
+    }
+    snapshot.sum = _sum.load(std::memory_order_relaxed);
+    snapshot.max = _max.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+int64_t LatencyHistogram::Snapshot::quantile(double q) const
+{
+    if (count == 0)
+        return 0;
+    auto const target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(q, 0., 1.) * static_cast<double>(count))));
+    uint64_t   seen   = 0;
+    for (int i = 0; i < bucket_count; ++i)
+    {
+        seen += buckets[static_cast<size_t>(i)];
+        if (seen >= target)
+            return std::min(bucket_upper_bound(i), max);
+    }
+    return max;
+}
+
+uint64_t LatencyHistogram::Snapshot::count_at_most(int64_t nanoseconds) const
+{
+    uint64_t result = 0;
+    for (int i = 0; i < bucket_count; ++i)
+    {
+        int64_t const lower = bucket_lower_bound(i);
+        if (lower + (bucket_upper_bound(i) - lower) / 2 > nanoseconds)
+            break;
+        result += buckets[static_cast<size_t>(i)];
+    }
+    return result;
+}
+
+Counter& metrics_counter(std::string const& name, std::string const& labels)
+{
+    return find_or_create(registry().counters, name, labels);
+}
+
+Gauge& metrics_gauge(std::string const& name, std::string const& labels)
+{
+    return find_or_create(registry().gauges, name, labels);
+}
+
+LatencyHistogram& metrics_histogram(std::string const& name, std::string const& labels)
+{
+    return find_or_create(registry().histograms, name, labels);
+}
+
+EffectMetrics& effect_metrics(std::string const& name)
+{
+    std::string const labels = "effect=\"" + name + "\"";
+    Counter&          runs    = metrics_counter("sil_effect_runs_total", labels);
+    Counter&          pixels  = metrics_counter("sil_effect_pixels_total", labels);
+    LatencyHistogram& seconds = metrics_histogram("sil_effect_seconds", labels);
+
+    std::lock_guard<std::mutex>     lock{registry().mutex};
+    std::unique_ptr<EffectMetrics>& metrics = registry().effects[name];
+    if (!metrics)
+        metrics = std::make_unique<EffectMetrics>(EffectMetrics{runs, pixels, seconds});
+    return *metrics;
+}
+
+MetricsSnapshot take_metrics_snapshot()
+{
+    MetricsRegistry&            reg = registry();
+    std::lock_guard<std::mutex> lock{reg.mutex};
+    MetricsSnapshot             snapshot{};
+    snapshot.time           = std::chrono::steady_clock::now();
+    snapshot.uptime_seconds = std::chrono::duration<double>(snapshot.time - reg.start).count();
+    for (auto const& [key, counter] : reg.counters)
+        snapshot.counters.push_back({key.first, key.second, static_cast<int64_t>(counter->value())});
+    for (auto const& [key, gauge] : reg.gauges)
+        snapshot.gauges.push_back({key.first, key.second, gauge->value()});
+    for (auto const& [key, histogram] : reg.histograms)
+        snapshot.histograms.push_back({key.first, key.second, histogram->snapshot()});
+    return snapshot;
+}
+
+void write_metrics_prometheus(std::filesystem::path path, MetricsSnapshot const& snapshot)
+{
+    AtomicFile    file{std::move(path)};
+    std::ostream& out = file.out;
+    out << std::setprecision(10);
+
+    // The snapshot is sorted by name, so each family is written in one block under its TYPE line
+    auto const write_values = [&](std::vector<MetricsSnapshot::Value> const& values, const char* type) {
+        std::string const* family = nullptr;
+        for (MetricsSnapshot::Value const& value : values)
+        {
+            if (!family || *family != value.name)
+                out << "# TYPE " << value.name << ' ' << type << '\n';
+            family = &value.name;
+            out << value.name << braces(value.labels) << ' ' << value.value << '\n';
+        }
+    };
+    write_values(snapshot.counters, "counter");
+    write_values(snapshot.gauges, "gauge");
+
+    std::string const* family = nullptr;
+    for (MetricsSnapshot::Histogram const& histogram : snapshot.histograms)
+    {
+        if (!family || *family != histogram.name)
+            out << "# TYPE " << histogram.name << " histogram\n";
+        family = &histogram.name;
+        for (double const bound : prometheus_bounds)
+        {
+            std::ostringstream le;
+            le << "le=\"" << bound << "\"";
+            out << histogram.name << "_bucket" << with_label(histogram.labels, le.str()) << ' '
+                << histogram.counts.count_at_most(static_cast<int64_t>(bound * 1e9)) << '\n';
+        }
+        out << histogram.name << "_bucket" << with_label(histogram.labels, "le=\"+Inf\"") << ' ' << histogram.counts.count << '\n';
+        out << histogram.name << "_sum" << braces(histogram.labels) << ' ' << to_seconds(histogram.counts.sum) << '\n';
+        out << histogram.name << "_count" << braces(histogram.labels) << ' ' << histogram.counts.count << '\n';
+    }
+    file.commit();
+}
+
+void write_metrics_json(std::filesystem::path path, MetricsSnapshot const& snapshot, MetricsSnapshot const* previous)
+{
+    AtomicFile    file{std::move(path)};
+    std::ostream& out = file.out;
+    out << std::setprecision(10);
+
+    double const interval = previous ? std::chrono::duration<double>(snapshot.time - previous->time).count() : 0.;
+    auto const   rate     = [&](double now, double before) { return interval > 0. ? (now - before) / interval : 0.; };
+    auto const   header   = [&](std::string const& name, std::string const& labels) {
+        out << "    {\"name\": \"";
+        write_escaped(out, name);
+        out << "\", \"labels\": ";
+        write_labels_json(out, labels);
+    };
+
+    out << "{\n  \"uptime_seconds\": " << snapshot.uptime_seconds << ",\n  \"interval_seconds\": " << interval << ",\n  \"counters\": [\n";
+    for (size_t i = 0; i < snapshot.counters.size(); ++i)
+    {
+        MetricsSnapshot::Value const& counter = snapshot.counters[i];
+        MetricsSnapshot::Value const* before  = previous ? find_previous(previous->counters, counter) : nullptr;
+        header(counter.name, counter.labels);
+        out << ", \"value\": " << counter.value
+            << ", \"per_second\": " << rate(static_cast<double>(counter.value), before ? static_cast<double>(before->value) : 0.) << "}"
+            << (i + 1 < snapshot.counters.size() ? ",\n" : "\n");
+    }
+
+    out << "  ],\n  \"gauges\": [\n";
+    for (size_t i = 0; i < snapshot.gauges.size(); ++i)
+    {
+        MetricsSnapshot::Value const& gauge = snapshot.gauges[i];
+        header(gauge.name, gauge.labels);
+        out << ", \"value\": " << gauge.value << "}" << (i + 1 < snapshot.gauges.size() ? ",\n" : "\n");
+    }
+
+    out << "  ],\n  \"histograms\": [\n";
+    for (size_t i = 0; i < snapshot.histograms.size(); ++i)
+    {
+        MetricsSnapshot::Histogram const& histogram = snapshot.histograms[i];
+        MetricsSnapshot::Histogram const* before    = previous ? find_previous(previous->histograms, histogram) : nullptr;
+        LatencyHistogram::Snapshot const& counts    = histogram.counts;
+        header(histogram.name, histogram.labels);
+        out << ", \"count\": " << counts.count
+            << ", \"per_second\": " << rate(static_cast<double>(counts.count), before ? static_cast<double>(before->counts.count) : 0.)
+            << ", \"mean_seconds\": " << (counts.count > 0 ? to_seconds(counts.sum) / static_cast<double>(counts.count) : 0.)
+            << ", \"p50_seconds\": " << to_seconds(counts.quantile(0.5))
+            << ", \"p90_seconds\": " << to_seconds(counts.quantile(0.9))
+            << ", \"p99_seconds\": " << to_seconds(counts.quantile(0.99))
+            << ", \"max_seconds\": " << to_seconds(counts.max) << "}"
+            << (i + 1 < snapshot.histograms.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    file.commit();
+}
+
+struct MetricsExporter::State {
+    std::filesystem::path            directory;
+    std::chrono::milliseconds        period;
+    std::mutex                       mutex; // Protects `stopping` and `previous`, and serializes the writes
+    std::condition_variable          stop_requested;
+    bool                             stopping = false;
+    std::unique_ptr<MetricsSnapshot> previous;
+    std::thread                      thread;
+};
+
+MetricsExporter::MetricsExporter(std::filesystem::path directory, std::chrono::milliseconds period)
+    : _state{std::make_unique<State>()}
+{
+    _state->directory = std::move(directory);
+    _state->period    = std::max(period, std::chrono::milliseconds{1});
+    _state->thread    = std::thread{[this]() {
+        std::unique_lock<std::mutex> lock{_state->mutex};
+        while (!_state->stop_requested.wait_for(lock, _state->period, [this]() { return _state->stopping; }))
+        {
+            lock.unlock();
+            try
+            {
+                write_now();
+            }
+            catch (std::exception const& error) // The next period tries again (for example once the disk has some space left)
+            {
+                std::cerr << error.what() << '\n';
+            }
+            lock.lock();
+        }
+    }};
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    {
+        std::lock_guard<std::mutex> lock{_state->mutex};
+        _state->stopping = true;
+    }
+    _state->stop_requested.notify_all();
+    _state->thread.join();
+    try
+    {
+        write_now();
+    }
+    catch (std::exception const&) // A destructor must not throw: the last snapshot is lost, like the ones the thread could not write
+    {
+    }
+}
+
+void MetricsExporter::write_now()
+{
+    std::lock_guard<std::mutex> lock{_state->mutex};
+    auto snapshot = std::make_unique<MetricsSnapshot>(take_metrics_snapshot());
+    write_metrics_prometheus(_state->directory / "metrics.prom", *snapshot);
+    write_metrics_json(_state->directory / "metrics.json", *snapshot, _state->previous.get());
+    _state->previous = std::move(snapshot);
+}
+
+} // namespace sil
@@ -0,0 +1,177 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sil {
+
+/// Monotonic count (images, pixels, bytes...). Adding is a single relaxed atomic operation, without lock.
+class Counter {
+public:
+    void     add(uint64_t n = 1) { _value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> _value{0};
+};
+
+/// Current value that can go up and down (queue depth, cache size...).
+class Gauge {
+public:
+    void    set(int64_t value) { _value.store(value, std::memory_order_relaxed); }
+    void    add(int64_t n) { _value.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> _value{0};
+};
+
+/// Distribution of durations, with log-linear buckets like HdrHistogram: values below 16 ns are exact,
+/// then each power of two is split into 16 buckets, so every quantile is known within 1/16 (6 %) from 1 ns to 2^40 ns (18 minutes).
+/// Recording is a few relaxed atomic operations, without lock; the buckets take 5 KB.
+class LatencyHistogram {
+public:
+    static constexpr int sub_bucket_bits = 4;
+    static constexpr int sub_buckets     = 1 << sub_bucket_bits;
+    static constexpr int max_exponent    = 40; // Longer durations go in the last bucket
+    static constexpr int bucket_count    = (max_exponent - sub_bucket_bits + 2) * sub_buckets;
+
+    /// Counts read at one point in time (each bucket is read atomically, but not all of them at once).
+    struct Snapshot {
+        std::array<uint64_t, bucket_count> buckets{};
+        uint64_t                           count = 0;
+        int64_t                            sum   = 0; // Nanoseconds
+        int64_t                            max   = 0; // Nanoseconds
+
+        /// Upper bound, in nanoseconds, of the bucket that contains the quantile `q` (between 0 and 1). 0 if nothing was recorded.
+        int64_t quantile(double q) const;
+        /// Number of recorded durations of at most `nanoseconds` (a bucket that straddles it is counted if its middle is below it).
+        uint64_t count_at_most(int64_t nanoseconds) const;
+    };
+
+    void     record(int64_t nanoseconds);
+    void     record(std::chrono::nanoseconds duration) { record(static_cast<int64_t>(duration.count())); }
+    Snapshot snapshot() const;
+
+    static int     bucket_index(int64_t nanoseconds);
+    static int64_t bucket_lower_bound(int index);
+    /// Exclusive.
+    static int64_t bucket_upper_bound(int index);
+
+private:
+    std::array<std::atomic<uint64_t>, bucket_count> _buckets{};
+    std::atomic<int64_t>                            _sum{0};
+    std::atomic<int64_t>                            _max{0};
+};
+
+/// Returns the counter with this name and these labels, creating it on first use.
+/// The name and labels follow the Prometheus syntax, for example `metrics_counter("sil_effect_runs_total", "effect=\"kuwahara\"")`.
+/// The lookup takes a lock: keep the returned reference (it stays valid until the end of the program) rather than looking it up for each update.
+Counter& metrics_counter(std::string const& name, std::string const& labels = {});
+/// Same as `metrics_counter()`, for a gauge.
+Gauge& metrics_gauge(std::string const& name, std::string const& labels = {});
+/// Same as `metrics_counter()`, for a histogram of durations (exported in seconds).
+LatencyHistogram& metrics_histogram(std::string const& name, std::string const& labels = {});
+
+/// Values of every metric at one point in time.
+struct MetricsSnapshot {
+    struct Value {
+        std::string name;
+        std::string labels;
+        int64_t     value;
+    };
+    struct Histogram {
+        std::string                 name;
+        std::string                 labels;
+        LatencyHistogram::Snapshot counts;
+    };
+
+    std::chrono::steady_clock::time_point time;
+    double                                uptime_seconds; // Since the first metric was created
+    std::vector<Value>                    counters;
+    std::vector<Value>                    gauges;
+    std::vector<Histogram>                histograms;
+};
+
+MetricsSnapshot take_metrics_snapshot();
+
+/// Writes the snapshot in the Prometheus text format (for example for the textfile collector of node_exporter).
+/// The file is written next to its destination then renamed, so that a reader never sees half of it.
+/// The path can either be absolute or relative (in which case it will be relative to the directory containing your CMakeLists.txt file).
+void write_metrics_prometheus(std::filesystem::path path, MetricsSnapshot const& snapshot);
+
+/// Writes the snapshot as JSON, with the 50th, 90th and 99th percentiles of each histogram.
+/// With a `previous` snapshot, each counter also gets its rate per second since that snapshot (images/s, pixels/s, bytes/s...), and each histogram the number of durations per second.
+/// Same path rules as `write_metrics_prometheus()`.
+void write_metrics_json(std::filesystem::path path, MetricsSnapshot const& snapshot, MetricsSnapshot const* previous = nullptr);
+
+/// Writes `metrics.prom` and `metrics.json` in a directory, every `period`, from a background thread, while the program works.
+/// The destructor writes a last snapshot.
+class MetricsExporter {
+public:
+    explicit MetricsExporter(std::filesystem::path directory, std::chrono::milliseconds period = std::chrono::seconds{1});
+    ~MetricsExporter();
+    MetricsExporter(MetricsExporter const&)            = delete;
+    MetricsExporter& operator=(MetricsExporter const&) = delete;
+
+    /// Writes both files now (the rates are computed since the previous write).
+    void write_now();
+
+private:
+    struct State;
+    std::unique_ptr<State> _state;
+};
+
+/// Metrics of one effect: number of calls, pixels processed and duration of each call.
+struct EffectMetrics {
+    Counter&          runs;
+    Counter&          pixels;
+    LatencyHistogram& seconds;
+};
+
+/// Metrics of the effect with this name (`sil_effect_runs_total`, `sil_effect_pixels_total` and `sil_effect_seconds`, with the label effect="name").
+EffectMetrics& effect_metrics(std::string const& name);
+
+/// Records one call of an effect when the enclosing scope ends. Prefer the `SIL_EFFECT_METRICS` macro, which looks the metrics up only once.
+/// A call interrupted by an exception (for example a cancelled job) is not recorded.
+class EffectMetricsScope {
+public:
+    EffectMetricsScope(EffectMetrics& metrics, uint64_t pixels)
+        : _metrics{metrics}
+        , _pixels{pixels}
+        , _exceptions{std::uncaught_exceptions()}
+        , _start{std::chrono::steady_clock::now()}
+    {}
+    ~EffectMetricsScope()
+    {
+        if (std::uncaught_exceptions() > _exceptions)
+            return;
+        _metrics.seconds.record(std::chrono::steady_clock::now() - _start);
+        _metrics.pixels.add(_pixels);
+        _metrics.runs.add();
+    }
+    EffectMetricsScope(EffectMetricsScope const&)            = delete;
+    EffectMetricsScope& operator=(EffectMetricsScope const&) = delete;
+
+private:
+    EffectMetrics&                        _metrics;
+    uint64_t                              _pixels;
+    int                                   _exceptions;
+    std::chrono::steady_clock::time_point _start;
+};
+
+} // namespace sil
+
+#define SIL_METRICS_CONCAT_IMPL(a, b) a##b
+#define SIL_METRICS_CONCAT(a, b)      SIL_METRICS_CONCAT_IMPL(a, b)
+
+/// Counts one call of the effect `name` (a string literal) on `pixels` pixels, and records its duration when the enclosing scope ends.
+#define SIL_EFFECT_METRICS(name, pixels)                                                                        \
+    static ::sil::EffectMetrics& SIL_METRICS_CONCAT(sil_effect_metrics_, __LINE__) = ::sil::effect_metrics(name); \
+    ::sil::EffectMetricsScope SIL_METRICS_CONCAT(sil_effect_metrics_scope_, __LINE__){SIL_METRICS_CONCAT(sil_effect_metrics_, __LINE__), static_cast<uint64_t>(pixels)}
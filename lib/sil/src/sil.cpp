@@ -1,5 +1,8 @@
 #include "sil.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
 #include <algorithm>
+#include <atomic>
 #include <img/img.hpp>
 #include <iostream>
 
@@ -34,29 +37,185 @@ static void make_directories_if_necessary(std::filesystem::path path)
     }
 }
 
+namespace {
+std::atomic<int64_t> live_image_bytes{0};
+std::atomic<int64_t> peak_image_bytes{0};
+std::atomic<int64_t> images_created{0};
+
+[[maybe_unused]] void add_image_bytes(int64_t bytes)
+{
+    int64_t const live = live_image_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t       peak = peak_image_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_image_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+} // namespace
+
+ImageMemoryStats image_memory_stats()
+{
+    return {live_image_bytes.load(), peak_image_bytes.load(), images_created.load()};
+}
+
+void reset_image_memory_peak()
+{
+    peak_image_bytes.store(live_image_bytes.load());
+}
+
 Image::Image(int width, int height)
     : _pixels(static_cast<size_t>(width) * static_cast<size_t>(height))
     , _width{width}
     , _height{height}
 {
+#if defined(SIL_MEMORY_STATS)
+    account();
+#endif
+}
+
+#if defined(SIL_MEMORY_STATS)
+void Image::account()
+{
+    images_created.fetch_add(1, std::memory_order_relaxed);
+    int64_t const bytes = static_cast<int64_t>(_pixels.size() * sizeof(glm::vec3));
+    add_image_bytes(bytes - _accounted_bytes);
+    _accounted_bytes = bytes;
+}
+
+Image::Image(Image const& other)
+    : _pixels{other._pixels}
+    , _width{other._width}
+    , _height{other._height}
+{
+    account();
+}
+
+Image::Image(Image&& other) noexcept
+    : _pixels{std::move(other._pixels)}
+    , _width{other._width}
+    , _height{other._height}
+    , _accounted_bytes{other._accounted_bytes}
+{
+    other._accounted_bytes = 0;
+}
+
+Image& Image::operator=(Image const& other)
+{
+    if (this != &other)
+    {
+        _pixels = other._pixels;
+        _width  = other._width;
+        _height = other._height;
+        account();
+    }
+    return *this;
+}
+
+Image& Image::operator=(Image&& other) noexcept
+{
+    if (this != &other)
+    {
+        add_image_bytes(-_accounted_bytes);
+        _pixels                = std::move(other._pixels);
+        _width                 = other._width;
+        _height                = other._height;
+        _accounted_bytes       = other._accounted_bytes;
+        other._accounted_bytes = 0;
+    }
+    return *this;
+}
+
+Image::~Image()
+{
+    add_image_bytes(-_accounted_bytes);
+}
+#endif
+
+namespace {
+
+/// Throughput of the loads or of the saves in one format.
+struct IoMetrics {
+    Counter&          images;
+    Counter&          pixels;
+    Counter&          bytes; // Size of the files (compressed)
+    LatencyHistogram& seconds;
+
+    void record(std::chrono::steady_clock::time_point start, int width, int height, std::filesystem::path const& file)
+    {
+        seconds.record(std::chrono::steady_clock::now() - start);
+        std::error_code error;
+        auto const      size = std::filesystem::file_size(file, error);
+        if (!error)
+            bytes.add(size);
+        pixels.add(static_cast<uint64_t>(width) * static_cast<uint64_t>(height));
+        images.add();
+    }
+};
+
+IoMetrics make_io_metrics(std::string const& operation, std::string const& labels)
+{
+    return IoMetrics{metrics_counter("sil_" + operation + "_images_total", labels), metrics_counter("sil_" + operation + "_pixels_total", labels),
+                     metrics_counter("sil_" + operation + "_bytes_total", labels), metrics_histogram("sil_" + operation + "_seconds", labels)};
+}
+
+IoMetrics& load_metrics()
+{
+    static IoMetrics metrics = make_io_metrics("load", {});
+    return metrics;
+}
+
+/// Encoding is much slower in png than in jpeg, so they are counted apart.
+IoMetrics& save_metrics(bool is_png)
+{
+    static IoMetrics png  = make_io_metrics("save", "format=\"png\"");
+    static IoMetrics jpeg = make_io_metrics("save", "format=\"jpeg\"");
+    return is_png ? png : jpeg;
 }
 
+} // namespace
+
 Image::Image(std::filesystem::path const& path)
 {
-    auto const image = img::load(make_absolute_path(path, true /*check_path_exists*/), 3);
+    SIL_TRACE_SCOPE("Image::Image");
+    auto const start    = std::chrono::steady_clock::now();
+    auto const absolute = make_absolute_path(path, true /*check_path_exists*/);
+    auto const image    = [&]() {
+        SIL_TRACE_SCOPE("img::load");
+        return img::load(absolute, 3);
+    }();
+    SIL_TRACE_SCOPE("convert 8 bits to float");
     _width           = static_cast<int>(image.width());
     _height          = static_cast<int>(image.height());
     _pixels.resize(static_cast<size_t>(_width) * static_cast<size_t>(_height));
+#if defined(SIL_MEMORY_STATS)
+    account();
+#endif
     for (size_t i = 0; i < _pixels.size(); ++i)
     {
         _pixels[i].r = static_cast<float>(image.data()[3 * i + 0]) / 255.f; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
         _pixels[i].g = static_cast<float>(image.data()[3 * i + 1]) / 255.f; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
         _pixels[i].b = static_cast<float>(image.data()[3 * i + 2]) / 255.f; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
     }
+    load_metrics().record(start, _width, _height, absolute);
 }
 
 void Image::save(std::filesystem::path path)
 {
+    SIL_TRACE_SCOPE("Image::save");
+    auto data = std::make_unique<uint8_t[]>(static_cast<size_t>(_width) * static_cast<size_t>(_height) * 3);
+    {
+        SIL_TRACE_SCOPE("quantize to 8 bits");
+        for (size_t i = 0; i < _pixels.size(); ++i)
+        {
+            data[3 * i + 0] = to_8bit(_pixels[i].r);
+            data[3 * i + 1] = to_8bit(_pixels[i].g);
+            data[3 * i + 2] = to_8bit(_pixels[i].b);
+        }
+    }
+    save_rgb8(std::move(path), _width, _height, std::move(data));
+}
+
+void save_rgb8(std::filesystem::path path, int width, int height, std::unique_ptr<uint8_t[]> data)
+{
+    SIL_TRACE_SCOPE("save_rgb8");
+    auto const start     = std::chrono::steady_clock::now();
     auto const extension = path.extension();
     bool const is_png    = extension == ".png";
     bool const is_jpeg   = extension == ".jpeg"
@@ -69,21 +228,17 @@ void Image::save(std::filesystem::path path)
         throw std::runtime_error{msg};
     }
 
-    auto* data = new uint8_t[static_cast<size_t>(_width) * static_cast<size_t>(_height) * 3]; // NOLINT(cppcoreguidelines-owning-memory)
-    for (size_t i = 0; i < _pixels.size(); ++i)
-    {
-        data[3 * i + 0] = static_cast<uint8_t>(std::clamp(std::floor(_pixels[i].r * 256.f), 0.f, 255.f)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-        data[3 * i + 1] = static_cast<uint8_t>(std::clamp(std::floor(_pixels[i].g * 256.f), 0.f, 255.f)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-        data[3 * i + 2] = static_cast<uint8_t>(std::clamp(std::floor(_pixels[i].b * 256.f), 0.f, 255.f)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-    }
-    auto const image = img::Image{{static_cast<unsigned int>(_width), static_cast<unsigned int>(_height)}, 3, data};
+    auto const image = img::Image{{static_cast<unsigned int>(width), static_cast<unsigned int>(height)}, 3, data.release()};
 
     path = make_absolute_path(path, false /*check_path_exists*/);
     make_directories_if_necessary(path);
+    // stb encodes and writes the file in the same call
+    SIL_TRACE_SCOPE(is_png ? "encode + write png" : "encode + write jpeg");
     if (is_png)
         img::save_png(path, image);
     else
         img::save_jpeg(path, image);
+    save_metrics(is_png).record(start, width, height, path);
 }
 
 glm::vec3& Image::pixel(int x, int y)
@@ -1,6 +1,10 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <filesystem>
 #include <glm/glm.hpp>
+#include <memory>
 #include <vector>
 
 namespace sil {
@@ -12,6 +16,15 @@ public:
     /// Creates a black image with the given size.
     Image(int width, int height);
 
+#if defined(SIL_MEMORY_STATS)
+    // Same as the defaults, plus the bookkeeping of `image_memory_stats()`
+    Image(Image const& other);
+    Image(Image&& other) noexcept;
+    Image& operator=(Image const& other);
+    Image& operator=(Image&& other) noexcept;
+    ~Image();
+#endif
+
     int width() const { return _width; }
     int height() const { return _height; }
     /// Returns the color of the pixel (expressed in sRGB space).
@@ -38,6 +51,31 @@ private:
     std::vector<glm::vec3> _pixels;
     int                    _width;
     int                    _height;
+#if defined(SIL_MEMORY_STATS)
+    int64_t _accounted_bytes{0}; // Size of `_pixels` when it was last counted (resizing `pixels()` yourself is not tracked)
+    void    account(); // Counts a new pixel buffer
+#endif
+};
+
+/// Memory held by the pixels of every live `Image`. Only counted when the library is built with `SIL_MEMORY_STATS` (otherwise everything stays at 0).
+struct ImageMemoryStats {
+    int64_t live_bytes;     // Pixel bytes of the images that currently exist
+    int64_t peak_bytes;     // Highest `live_bytes` since the start of the program or the last `reset_image_memory_peak()`
+    int64_t images_created; // Number of pixel buffers created (constructions and copies, not moves)
 };
 
+ImageMemoryStats image_memory_stats();
+/// Sets the peak back to the current live bytes, to measure the peak of the code that follows.
+void reset_image_memory_peak();
+
+/// Converts a color channel (expressed in sRGB space, between 0 and 1) to the 8-bit value written by `Image::save()`.
+inline uint8_t to_8bit(float channel)
+{
+    return static_cast<uint8_t>(std::clamp(std::floor(channel * 256.f), 0.f, 255.f));
+}
+
+/// Saves 8-bit RGB data (3 bytes per pixel, stored row by row, from left to right and from bottom to top) as either jpeg or png based on the extension you put in the `path`.
+/// This is what `Image::save()` uses after converting its pixels, and lets you fill the encoder buffer yourself without building a full `Image` first.
+void save_rgb8(std::filesystem::path path, int width, int height, std::unique_ptr<uint8_t[]> data);
+
 } // namespace sil
\ No newline at end of file
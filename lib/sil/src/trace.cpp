@@ -0,0 +1,131 @@
+#include "trace.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sil {
+
+namespace {
+
+struct ThreadEvents {
+    int                     track; // Chrome trace "tid"
+    std::vector<TraceEvent> events;
+};
+
+/// Owns the buffers of every thread that recorded something, so that the events outlive short-lived worker threads.
+/// The buffer of a finished thread is handed to the next new thread, so that successive thread pools share the same tracks.
+struct TraceRegistry {
+    std::mutex                                 mutex;
+    std::vector<std::unique_ptr<ThreadEvents>> buffers;
+    std::vector<ThreadEvents*>                 free_buffers;
+
+    ThreadEvents* acquire()
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (!free_buffers.empty())
+        {
+            ThreadEvents* buffer = free_buffers.back();
+            free_buffers.pop_back();
+            return buffer;
+        }
+        buffers.push_back(std::make_unique<ThreadEvents>(ThreadEvents{static_cast<int>(buffers.size()) + 1, {}}));
+        buffers.back()->events.reserve(1024);
+        return buffers.back().get();
+    }
+
+    void release(ThreadEvents* buffer)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        free_buffers.push_back(buffer);
+    }
+};
+
+TraceRegistry& registry()
+{
+    static TraceRegistry instance{}; // Never destroyed before the threads that use it: function-local statics outlive thread_local objects of the main thread
+    return instance;
+}
+
+/// Buffer of the calling thread, acquired on its first event and released when the thread ends.
+struct ThreadSlot {
+    ThreadEvents* buffer = nullptr;
+    ~ThreadSlot()
+    {
+        if (buffer)
+            registry().release(buffer);
+    }
+};
+
+thread_local ThreadSlot slot{};
+
+void write_escaped(std::ostream& out, const char* text)
+{
+    for (const char* c = text; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+            out << '\\';
+        out << *c;
+    }
+}
+
+} // namespace
+
+int64_t trace_now()
+{
+    static auto const start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void record_trace_event(TraceEvent const& event)
+{
+    if (!slot.buffer)
+        slot.buffer = registry().acquire();
+    slot.buffer->events.push_back(event);
+}
+
+bool write_trace(std::filesystem::path path)
+{
+    TraceRegistry&              reg = registry();
+    std::lock_guard<std::mutex> lock{reg.mutex};
+    bool const                  empty = std::all_of(reg.buffers.begin(), reg.buffers.end(), [](auto const& buffer) { return buffer->events.empty(); });
+    if (empty)
+        return false;
+
+    if (path.is_relative())
+        path = SIL_CMAKE_SOURCE_DIR / path;
+    if (path.has_parent_path())
+        std::filesystem::create_directories(path.parent_path());
+
+    std::ofstream out{path};
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    bool first = true;
+    for (auto const& buffer : reg.buffers)
+    {
+        for (TraceEvent const& event : buffer->events)
+        {
+            out << (first ? "" : ",\n") << "{\"name\": \"";
+            write_escaped(out, event.name);
+            // Chrome traces are in microseconds
+            out << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->track
+                << ", \"ts\": " << static_cast<double>(event.start) / 1000.
+                << ", \"dur\": " << static_cast<double>(event.duration) / 1000. << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return true;
+}
+
+void clear_trace()
+{
+    TraceRegistry&              reg = registry();
+    std::lock_guard<std::mutex> lock{reg.mutex};
+    for (auto const& buffer : reg.buffers)
+        buffer->events.clear();
+}
+
+} // namespace sil
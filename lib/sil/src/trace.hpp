@@ -0,0 +1,55 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+namespace sil {
+
+/// A timed section of code, recorded by `TraceScope`.
+struct TraceEvent {
+    const char* name;   // Must outlive the trace (string literal)
+    int64_t     start;  // Nanoseconds since the first traced event of the program
+    int64_t     duration;
+};
+
+/// Nanoseconds elapsed since the trace clock started (the first time this function was called).
+int64_t trace_now();
+
+/// Appends an event to the buffer of the calling thread. Each thread has its own buffer, so recording takes no lock.
+void record_trace_event(TraceEvent const& event);
+
+/// Times the enclosing scope. Prefer the `SIL_TRACE_SCOPE` macro, which compiles to nothing unless `SIL_TRACE` is defined.
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : _name{name}
+        , _start{trace_now()}
+    {}
+    ~TraceScope() { record_trace_event({_name, _start, trace_now() - _start}); }
+    TraceScope(TraceScope const&)            = delete;
+    TraceScope& operator=(TraceScope const&) = delete;
+
+private:
+    const char* _name;
+    int64_t     _start;
+};
+
+/// Writes every recorded event as a Chrome trace (JSON "complete" events, one track per thread), that can be opened with chrome://tracing or https://ui.perfetto.dev.
+/// Must not be called while other threads are still recording. Returns false (and writes nothing) if no event was recorded, for example when `SIL_TRACE` is not defined.
+/// The path can either be absolute or relative (in which case it will be relative to the directory containing your CMakeLists.txt file).
+bool write_trace(std::filesystem::path path);
+
+/// Forgets every recorded event.
+void clear_trace();
+
+} // namespace sil
+
+#define SIL_TRACE_CONCAT_IMPL(a, b) a##b
+#define SIL_TRACE_CONCAT(a, b)      SIL_TRACE_CONCAT_IMPL(a, b)
+
+#if defined(SIL_TRACE)
+/// Times the enclosing scope under the given name (a string literal).
+#define SIL_TRACE_SCOPE(name) ::sil::TraceScope SIL_TRACE_CONCAT(sil_trace_scope_, __LINE__){name}
+#else
+#define SIL_TRACE_SCOPE(name) ((void)0)
+#endif
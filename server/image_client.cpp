@@ -0,0 +1,58 @@
+#include "job_client.hpp"
+#include "line_socket.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Envoie un traitement à image_server et attend sa fin, ou affiche les compteurs du serveur.
+ * Renvoie 1 si le traitement a échoué (le message du serveur est affiché) et 2 si le serveur est injoignable ou si les arguments sont invalides.
+ *
+ * Usage : image_client [--socket /tmp/image_editor.sock] <entrée> <chaîne d'effets> <sortie>
+ *         image_client [--socket /tmp/image_editor.sock] --stats
+ * Exemple : image_client images/photo.jpg "black_and_white,convolution:sharpen" output/photo_net.png
+ */
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path socket_path = default_socket_path;
+    bool stats = false;
+    std::vector<std::string> arguments;
+    for (int i{1}; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) socket_path = argv[++i];
+        else if (arg == "--stats") stats = true;
+        else arguments.push_back(arg);
+    }
+    if (stats ? !arguments.empty() : arguments.size() != 3)
+    {
+        std::cerr << "Usage : image_client [--socket chemin] <entrée> <chaîne d'effets> <sortie>\n"
+                  << "        image_client [--socket chemin] --stats\n";
+        return 2;
+    }
+
+    try
+    {
+        JobClient client{socket_path};
+        if (stats)
+        {
+            std::cout << client.stats() << "\n";
+            return 0;
+        }
+
+        const JobClient::Result result = client.run(arguments[0], arguments[1], arguments[2]);
+        if (!result.ok)
+        {
+            std::cerr << result.error << "\n";
+            return 1;
+        }
+        std::cout << result.width << "x" << result.height << " en " << result.milliseconds << " ms\n";
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << error.what() << "\n";
+        return 2;
+    }
+    return 0;
+}
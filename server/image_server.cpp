@@ -0,0 +1,115 @@
+#include "job_server.hpp"
+#include <sil/metrics.hpp>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Lance un JobServer et le garde en marche jusqu'à Ctrl+C (SIGINT) ou SIGTERM : les traitements en cours sont terminés avant l'arrêt.
+ * Les images sont envoyées avec image_client, ou par n'importe quel programme qui parle le protocole décrit dans job_server.hpp.
+ *
+ * Avec --metrics, les compteurs et histogrammes de sil/metrics.hpp (images chargées et enregistrées, durée et pixels de chaque effet,
+ * files d'attente, durée des traitements) sont écrits dans dossier/metrics.prom et dossier/metrics.json toutes les --metrics-period millisecondes.
+ *
+ * Usage : image_server [--socket /tmp/image_editor.sock] [--workers nombre] [--cache-mb 512] [--metrics dossier] [--metrics-period 1000]
+ */
+
+namespace {
+
+struct MetricsOptions
+{
+    std::filesystem::path directory; // Vide : pas d'export
+    std::chrono::milliseconds period{1000};
+};
+
+JobServer* running_server = nullptr;
+
+void stop_server(int)
+{
+    if (running_server != nullptr) running_server->stop();
+}
+
+const char* const usage = "Usage : image_server [--socket /tmp/image_editor.sock] [--workers nombre] [--cache-mb 512] [--metrics dossier] [--metrics-period 1000]";
+
+/// Taille, durée ou nombre positif ou nul. Lance std::invalid_argument ou std::out_of_range si la valeur n'en est pas un.
+long long non_negative(const std::string& value, long long max = std::numeric_limits<long long>::max())
+{
+    size_t used = 0;
+    const long long number = std::stoll(value, &used);
+    if (used != value.size()) throw std::invalid_argument{value};
+    if (number < 0 || number > max) throw std::out_of_range{value};
+    return number;
+}
+
+bool parse_options(int argc, char** argv, JobServerOptions& options, MetricsOptions& metrics)
+{
+    for (int i{1}; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Valeur manquante après " << arg << "\n" << usage << "\n";
+            return false;
+        }
+        const std::string value = argv[++i];
+        try
+        {
+            if (arg == "--socket") options.socket_path = value;
+            else if (arg == "--workers") options.workers = static_cast<int>(non_negative(value, std::numeric_limits<int>::max()));
+            else if (arg == "--cache-mb") options.cache_bytes = non_negative(value, std::numeric_limits<long long>::max() >> 20) << 20;
+            else if (arg == "--metrics") metrics.directory = value;
+            else if (arg == "--metrics-period") metrics.period = std::chrono::milliseconds{non_negative(value)};
+            else
+            {
+                std::cerr << "Option inconnue : " << arg << "\n" << usage << "\n";
+                return false;
+            }
+        }
+        catch (const std::logic_error&) // std::invalid_argument et std::out_of_range de std::stoll
+        {
+            std::cerr << "Valeur invalide pour " << arg << " : " << value << "\n" << usage << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    JobServerOptions options;
+    MetricsOptions metrics;
+    if (!parse_options(argc, argv, options, metrics)) return 2;
+
+    try
+    {
+        // Créé avant le serveur : la dernière écriture, à la destruction, compte tous les traitements
+        std::optional<sil::MetricsExporter> exporter;
+        if (!metrics.directory.empty()) exporter.emplace(metrics.directory, metrics.period);
+
+        JobServer server{options};
+        running_server = &server;
+        std::signal(SIGINT, stop_server);
+        std::signal(SIGTERM, stop_server);
+
+        std::cerr << "En écoute sur " << options.socket_path.string() << "\n";
+        server.run();
+        running_server = nullptr;
+
+        const JobServer::Stats stats = server.stats();
+        std::cerr << stats.jobs << " traitement(s), dont " << stats.failed << " en erreur, pour " << stats.connections << " connexion(s) ; cache : "
+                  << stats.cache.hits << " image(s) déjà décodée(s), " << stats.cache.misses << " décodage(s)\n";
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << error.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include "job_client.hpp"
+#include "line_socket.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+/// Les segments partagés ("shm:...") gardent leur nom, les chemins relatifs deviennent absolus.
+std::string absolute_location(const std::string& location)
+{
+    if (location.rfind("shm:", 0) == 0) return location;
+    return std::filesystem::absolute(location).string();
+}
+
+} // namespace
+
+JobClient::JobClient(const std::filesystem::path& socket_path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string path = socket_path.string();
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error{"Chemin de socket invalide ou trop long : " + path};
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    _fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_fd < 0 || connect(_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        const std::string reason = std::strerror(errno);
+        if (_fd >= 0) close(_fd);
+        throw std::runtime_error{"Impossible de se connecter au serveur sur " + path + " : " + reason};
+    }
+}
+
+JobClient::~JobClient()
+{
+    close(_fd);
+}
+
+std::string JobClient::request(const std::string& line)
+{
+    std::string reply;
+    if (!send_all(_fd, line + "\n") || !read_line(_fd, _buffer, reply))
+    {
+        throw std::runtime_error{"Connexion au serveur perdue"};
+    }
+    return reply;
+}
+
+JobClient::Result JobClient::run(const std::string& input, const std::string& chain, const std::string& output)
+{
+    const std::vector<std::string> fields = split_fields(request("run\t" + absolute_location(input) + "\t" + chain + "\t" + absolute_location(output)));
+
+    Result result;
+    if (fields[0] == "ok" && fields.size() == 4)
+    {
+        result.ok = true;
+        result.width = std::stoi(fields[1]);
+        result.height = std::stoi(fields[2]);
+        result.milliseconds = std::stod(fields[3]);
+    }
+    else
+    {
+        result.error = fields.size() > 1 ? fields[1] : "Réponse invalide du serveur";
+    }
+    return result;
+}
+
+std::string JobClient::stats()
+{
+    const std::string reply = request("stats");
+    if (reply.rfind("ok\t", 0) != 0) throw std::runtime_error{"Réponse invalide du serveur : " + reply};
+
+    std::string counters = reply.substr(3);
+    for (char& c : counters)
+    {
+        if (c == '\t') c = ' ';
+    }
+    return counters;
+}
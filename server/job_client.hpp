@@ -0,0 +1,47 @@
+#pragma once
+#include <filesystem>
+#include <string>
+
+/**
+ * Connexion à un JobServer (voir job_server.hpp pour le protocole).
+ * Une connexion envoie ses demandes une par une : pour traiter plusieurs images en même temps, on ouvre plusieurs connexions.
+ */
+class JobClient
+{
+public:
+    struct Result
+    {
+        bool ok{false};
+        std::string error; // Message du serveur si ok est false
+        int width{0};
+        int height{0};
+        double milliseconds{0.}; // Durée du traitement côté serveur (chargement, effets et enregistrement)
+    };
+
+    /// Se connecte au serveur. Lance std::runtime_error si aucun serveur n'écoute sur la socket.
+    explicit JobClient(const std::filesystem::path& socket_path);
+    ~JobClient();
+
+    JobClient(const JobClient&) = delete;
+    JobClient& operator=(const JobClient&) = delete;
+
+    /**
+     * Demande un traitement et attend sa fin.
+     * Les chemins relatifs sont convertis en chemins absolus depuis le dossier courant du client. Lance std::runtime_error si la connexion est perdue.
+     *
+     * @param input Chemin de l'image d'entrée, ou "shm:<nom>" pour un segment SharedImage.
+     * @param chain Chaîne d'effets (voir effect_chain.hpp).
+     * @param output Chemin de l'image à écrire (png ou jpeg), ou "shm:<nom>".
+     */
+    Result run(const std::string& input, const std::string& chain, const std::string& output);
+
+    /// Compteurs du serveur, tels qu'il les envoie ("jobs=... failed=... ..."). Lance std::runtime_error en cas d'erreur.
+    std::string stats();
+
+private:
+    /// Envoie une ligne et renvoie la réponse.
+    std::string request(const std::string& line);
+
+    int _fd{-1};
+    std::string _buffer;
+};
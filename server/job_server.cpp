@@ -0,0 +1,290 @@
+#include "job_server.hpp"
+#include "line_socket.hpp"
+#include "shared_image.hpp"
+#include "parallel.hpp"
+#include <sil/metrics.hpp>
+#include <sil/trace.hpp>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+const std::string shm_prefix = "shm:";
+
+/// Métriques exportées par sil::MetricsExporter (voir image_server --metrics), communes à tous les JobServer du processus.
+struct ServerMetrics
+{
+    sil::Gauge& queue_depth;            // Traitements reçus qui attendent un thread de travail
+    sil::LatencyHistogram& job_seconds; // Durée de chaque traitement (chargement, effets et enregistrement), sans l'attente dans la file
+    sil::Counter& failed;
+};
+
+ServerMetrics& server_metrics()
+{
+    static ServerMetrics metrics{sil::metrics_gauge("image_editor_server_queue_depth"), sil::metrics_histogram("image_editor_server_job_seconds"),
+                                 sil::metrics_counter("image_editor_server_jobs_failed_total")};
+    return metrics;
+}
+
+bool is_shared(const std::string& name)
+{
+    return name.compare(0, shm_prefix.size(), shm_prefix) == 0;
+}
+
+[[noreturn]] void fail(const std::string& what)
+{
+    throw std::runtime_error{what + " : " + std::strerror(errno)};
+}
+
+/// Une erreur ne doit pas couper le protocole : les tabulations et retours à la ligne du message sont remplacés par des espaces.
+std::string error_line(std::string message)
+{
+    for (char& c : message)
+    {
+        if (c == '\t' || c == '\n' || c == '\r') c = ' ';
+    }
+    return "error\t" + message;
+}
+
+} // namespace
+
+JobServer::JobServer(JobServerOptions options)
+    : _options{std::move(options)}
+    , _cache{_options.cache_bytes}
+{
+    if (_options.workers <= 0) _options.workers = thread_count();
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string path = _options.socket_path.string();
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error{"Chemin de socket invalide ou trop long : " + path};
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    if (pipe(_wake_fds) != 0) fail("Impossible de créer le tube de réveil");
+    _listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_listen_fd < 0) fail("Impossible de créer la socket");
+
+    // Une socket laissée par un serveur arrêté brutalement empêcherait bind() ; on ne retire que si personne n'y répond
+    const int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe >= 0)
+    {
+        const bool alive = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        close(probe);
+        if (alive) throw std::runtime_error{"Un serveur écoute déjà sur " + path};
+        unlink(path.c_str());
+    }
+
+    if (bind(_listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) fail("Impossible d'utiliser la socket " + path);
+    if (listen(_listen_fd, 64) != 0) fail("Impossible d'écouter sur " + path);
+}
+
+JobServer::~JobServer()
+{
+    stop();
+    reap_connections(true);
+    {
+        std::lock_guard lock{_queue_mutex};
+        _closing = true;
+    }
+    _queue_changed.notify_all();
+    for (std::thread& worker : _workers)
+    {
+        if (worker.joinable()) worker.join();
+    }
+
+    if (_listen_fd >= 0)
+    {
+        close(_listen_fd);
+        unlink(_options.socket_path.c_str());
+    }
+    for (int fd : _wake_fds)
+    {
+        if (fd >= 0) close(fd);
+    }
+}
+
+void JobServer::stop()
+{
+    // Seulement une écriture atomique et un write() : utilisable depuis un gestionnaire de signal
+    _stopping.store(true);
+    if (_wake_fds[1] >= 0)
+    {
+        const char byte = 0;
+        [[maybe_unused]] const ssize_t written = write(_wake_fds[1], &byte, 1);
+    }
+}
+
+void JobServer::run()
+{
+    for (int i{0}; i < _options.workers; i++)
+    {
+        _workers.emplace_back([this]() { work(); });
+    }
+
+    while (!_stopping.load())
+    {
+        pollfd fds[2]{{_listen_fd, POLLIN, 0}, {_wake_fds[0], POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR) continue;
+            fail("Erreur en attendant les clients");
+        }
+        if (fds[1].revents != 0 || _stopping.load()) break;
+
+        const int fd = accept(_listen_fd, nullptr, nullptr);
+        if (fd < 0) continue; // Client parti avant d'être accepté, ou interruption
+
+        reap_connections(false);
+        _connection_count++;
+        std::lock_guard lock{_connections_mutex};
+        Connection& connection = _connections.emplace_back();
+        connection.fd = fd;
+        connection.thread = std::thread{[this, &connection]() { serve(connection); }};
+    }
+
+    // Les connexions sont coupées, mais les traitements déjà dans la file sont terminés avant le retour
+    reap_connections(true);
+    {
+        std::lock_guard lock{_queue_mutex};
+        _closing = true;
+    }
+    _queue_changed.notify_all();
+    for (std::thread& worker : _workers)
+    {
+        worker.join();
+    }
+    _workers.clear();
+}
+
+void JobServer::reap_connections(bool all)
+{
+    std::list<Connection> finished;
+    {
+        std::lock_guard lock{_connections_mutex};
+        for (auto it = _connections.begin(); it != _connections.end();)
+        {
+            if (all && !it->finished) shutdown(it->fd, SHUT_RDWR); // Débloque le recv() du thread de connexion
+            if (all || it->finished)
+                finished.splice(finished.end(), _connections, it++);
+            else
+                ++it;
+        }
+    }
+    for (Connection& connection : finished)
+    {
+        connection.thread.join();
+        close(connection.fd);
+    }
+}
+
+void JobServer::serve(Connection& connection)
+{
+    std::string buffer;
+    std::string line;
+    while (read_line(connection.fd, buffer, line))
+    {
+        if (!send_all(connection.fd, answer(line) + "\n")) break;
+    }
+    // Le client voit la fermeture tout de suite (ligne trop longue par exemple), sans attendre que la connexion soit retirée de la liste
+    shutdown(connection.fd, SHUT_RDWR);
+    std::lock_guard lock{_connections_mutex};
+    connection.finished = true;
+}
+
+std::string JobServer::answer(const std::string& line)
+{
+    const std::vector<std::string> fields = split_fields(line);
+    if (fields[0] == "stats" && fields.size() == 1)
+    {
+        const Stats s = stats();
+        std::ostringstream out;
+        out << "ok\tjobs=" << s.jobs << "\tfailed=" << s.failed << "\tconnections=" << s.connections << "\tcache_hits=" << s.cache.hits
+            << "\tcache_misses=" << s.cache.misses << "\tcache_bytes=" << s.cache.bytes;
+        return out.str();
+    }
+    if (fields[0] != "run") return error_line("Demande inconnue : " + fields[0]);
+    if (fields.size() != 4) return error_line("run attend 3 champs : entrée, chaîne d'effets, sortie");
+
+    Job job{fields[1], {}, fields[3], {}};
+    try
+    {
+        job.chain = EffectChain::parse(fields[2]);
+    }
+    catch (const std::invalid_argument& error)
+    {
+        return error_line(error.what());
+    }
+
+    std::future<std::string> reply = job.reply.get_future();
+    {
+        std::lock_guard lock{_queue_mutex};
+        _queue.push_back(std::move(job));
+        server_metrics().queue_depth.add(1);
+    }
+    _queue_changed.notify_one();
+    return reply.get();
+}
+
+void JobServer::work()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock lock{_queue_mutex};
+            _queue_changed.wait(lock, [this]() { return _closing || !_queue.empty(); });
+            if (_queue.empty()) return;
+            job = std::move(_queue.front());
+            _queue.pop_front();
+            server_metrics().queue_depth.add(-1);
+        }
+        job.reply.set_value(execute(job));
+    }
+}
+
+std::string JobServer::execute(const Job& job)
+{
+    SIL_TRACE_SCOPE("JobServer::execute");
+    const auto start = std::chrono::steady_clock::now();
+    std::string reply;
+    try
+    {
+        // L'image du cache est partagée : l'effet travaille sur une copie
+        sil::Image img = is_shared(job.input) ? SharedImage::open(job.input.substr(shm_prefix.size())).to_image() : sil::Image{*_cache.get(job.input)};
+        job.chain.apply(img);
+
+        if (is_shared(job.output))
+            SharedImage::create(job.output.substr(shm_prefix.size()), img.width(), img.height()).assign(img);
+        else
+            img.save(job.output);
+
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::ostringstream out;
+        out << "ok\t" << img.width() << "\t" << img.height() << "\t" << elapsed.count();
+        reply = out.str();
+    }
+    catch (const std::exception& error)
+    {
+        _failed++;
+        server_metrics().failed.add();
+        reply = error_line(error.what());
+    }
+    server_metrics().job_seconds.record(std::chrono::steady_clock::now() - start);
+    _jobs++;
+    return reply;
+}
+
+JobServer::Stats JobServer::stats() const
+{
+    return Stats{_jobs.load(), _failed.load(), _connection_count.load(), _cache.stats()};
+}
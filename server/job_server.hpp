@@ -0,0 +1,108 @@
+#pragma once
+#include "effect_chain.hpp"
+#include "image_cache.hpp"
+#include "line_socket.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct JobServerOptions
+{
+    std::filesystem::path socket_path{default_socket_path};
+    int workers{0};                           // Threads qui exécutent les traitements (0 : thread_count())
+    int64_t cache_bytes{int64_t{512} << 20};  // Capacité du cache des images décodées
+};
+
+/**
+ * Serveur de traitements d'images qui reste lancé entre les demandes, sur une socket Unix locale.
+ * Lancer ImageEditor pour chaque image coûte le démarrage du processus, le décodage des images d'entrée et des caches froids :
+ * ici les threads de travail restent prêts, et les images d'entrée décodées sont gardées dans un ImageCache partagé par tous les clients.
+ * Chaque client a son propre thread de connexion, qui lit ses demandes une par une et les confie aux threads de travail.
+ *
+ * Protocole (une ligne par message, champs séparés par des tabulations) :
+ *   run <entrée> <chaîne d'effets> <sortie>   ->   ok <largeur> <hauteur> <millisecondes>   ou   error <message>
+ *   stats                                      ->   ok jobs=<n> failed=<n> connections=<n> cache_hits=<n> cache_misses=<n> cache_bytes=<n>
+ * L'entrée est un chemin d'image ou "shm:<nom>" (segment SharedImage écrit par le client), la chaîne d'effets est décrite dans effect_chain.hpp,
+ * et la sortie est un chemin d'image (png ou jpeg) ou "shm:<nom>" (segment créé ou remplacé par le serveur, que le client ouvre ensuite).
+ * Les chemins relatifs sont relatifs au dossier du CMakeLists.txt, comme pour sil::Image : le client envoie des chemins absolus.
+ */
+class JobServer
+{
+public:
+    struct Stats
+    {
+        int64_t jobs{0};        // Traitements terminés, réussis ou non
+        int64_t failed{0};      // Traitements terminés par une erreur
+        int64_t connections{0}; // Clients connectés depuis le démarrage
+        ImageCache::Stats cache;
+    };
+
+    /// Crée la socket et commence à écouter : les clients peuvent se connecter dès le retour du constructeur. Lance std::runtime_error en cas d'échec.
+    explicit JobServer(JobServerOptions options = {});
+    ~JobServer();
+
+    JobServer(const JobServer&) = delete;
+    JobServer& operator=(const JobServer&) = delete;
+
+    /// Accepte les clients jusqu'à l'appel de stop(), puis termine les traitements en attente et ferme les connexions.
+    void run();
+
+    /// Demande l'arrêt de run(). Utilisable depuis un gestionnaire de signal.
+    void stop();
+
+    Stats stats() const;
+
+private:
+    struct Job
+    {
+        std::string input;
+        EffectChain chain;
+        std::string output;
+        std::promise<std::string> reply; // Ligne de réponse
+    };
+
+    struct Connection
+    {
+        int fd{-1};
+        std::thread thread;
+        bool finished{false};
+    };
+
+    /// Lit et traite les demandes d'un client jusqu'à ce qu'il se déconnecte.
+    void serve(Connection& connection);
+    /// Réponse à une ligne de demande.
+    std::string answer(const std::string& line);
+    /// Boucle des threads de travail.
+    void work();
+    /// Exécute un traitement et renvoie la ligne de réponse.
+    std::string execute(const Job& job);
+    /// Attend la fin des connexions terminées et ferme leur socket (toutes si `all`, après avoir coupé celles encore ouvertes).
+    void reap_connections(bool all);
+
+    JobServerOptions _options;
+    ImageCache _cache;
+    int _listen_fd{-1};
+    int _wake_fds[2]{-1, -1}; // stop() écrit dans _wake_fds[1] pour réveiller la boucle d'acceptation
+    std::atomic<bool> _stopping{false};
+
+    std::mutex _queue_mutex;
+    std::condition_variable _queue_changed;
+    std::deque<Job> _queue;
+    bool _closing{false}; // Plus de nouveaux traitements : les threads de travail s'arrêtent quand la file est vide
+    std::vector<std::thread> _workers;
+
+    std::mutex _connections_mutex;
+    std::list<Connection> _connections;
+
+    std::atomic<int64_t> _jobs{0};
+    std::atomic<int64_t> _failed{0};
+    std::atomic<int64_t> _connection_count{0};
+};
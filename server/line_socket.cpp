@@ -0,0 +1,50 @@
+#include "line_socket.hpp"
+#include <cerrno>
+#include <sys/socket.h>
+
+bool read_line(int fd, std::string& buffer, std::string& line)
+{
+    size_t end = buffer.find('\n');
+    while (end == std::string::npos)
+    {
+        if (buffer.size() > max_line_length) return false;
+        char chunk[4096];
+        const ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return false;
+        const size_t searched = buffer.size();
+        buffer.append(chunk, static_cast<size_t>(received));
+        end = buffer.find('\n', searched);
+    }
+    if (end > max_line_length) return false;
+    line = buffer.substr(0, end);
+    buffer.erase(0, end + 1);
+    return true;
+}
+
+bool send_all(int fd, const std::string& text)
+{
+    size_t sent = 0;
+    while (sent < text.size())
+    {
+        const ssize_t count = send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return false;
+        sent += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+std::vector<std::string> split_fields(const std::string& line)
+{
+    std::vector<std::string> fields;
+    size_t begin = 0;
+    while (true)
+    {
+        const size_t end = line.find('\t', begin);
+        fields.push_back(line.substr(begin, end - begin));
+        if (end == std::string::npos) break;
+        begin = end + 1;
+    }
+    return fields;
+}
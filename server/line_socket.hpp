@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * Lecture et écriture de messages d'une ligne sur une socket, pour le protocole texte du serveur de traitements (job_server.hpp).
+ * Les champs d'une ligne sont séparés par des tabulations, pour que les chemins puissent contenir des espaces.
+ */
+
+/// Socket utilisée par défaut par image_server et image_client.
+inline const std::filesystem::path default_socket_path = "/tmp/image_editor.sock";
+
+/// Longueur maximale d'une ligne : au-delà, l'autre côté ne respecte pas le protocole et la connexion doit être fermée.
+constexpr size_t max_line_length = 64 * 1024;
+
+/**
+ * Lit la ligne suivante (sans le '\n') dans `line`.
+ * Renvoie false si la connexion est fermée (ou en erreur) avant la fin de la ligne, ou si la ligne dépasse max_line_length octets :
+ * un client qui n'envoie jamais de '\n' ne peut pas faire grossir `buffer` sans limite.
+ *
+ * @param buffer Octets déjà reçus mais pas encore lus, à garder d'un appel à l'autre pour la même socket.
+ */
+bool read_line(int fd, std::string& buffer, std::string& line);
+
+/// Envoie tout le texte (sans déclencher SIGPIPE si l'autre côté a fermé la connexion). Renvoie false en cas d'erreur.
+bool send_all(int fd, const std::string& text);
+
+/// Découpe une ligne en champs séparés par des tabulations.
+std::vector<std::string> split_fields(const std::string& line);
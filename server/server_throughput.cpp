@@ -0,0 +1,169 @@
+#include "job_client.hpp"
+#include "job_server.hpp"
+#include "line_socket.hpp"
+#include "shared_image.hpp"
+#include <test_helpers.hpp>
+#include <effect_chain.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Test de débit du serveur de traitements : les mêmes traitements (quelques images d'entrée, chaînes d'effets sans aléatoire) sont faits
+ * une fois un par un comme le ferait un processus lancé par image (décodage, effets, enregistrement), puis par un JobServer lancé dans ce processus,
+ * avec plusieurs clients en même temps. Chaque fichier produit par le serveur doit être identique au fichier produit sans serveur,
+ * chaque image d'entrée ne doit être décodée qu'une fois, et un aller-retour par mémoire partagée doit redonner l'image attendue.
+ * Affiche les deux débits en traitements par seconde et renvoie 1 si une vérification échoue.
+ *
+ * Usage : server_throughput [--jobs 48] [--clients 4] [--size 512]
+ */
+
+namespace {
+
+struct Options
+{
+    int jobs{48};
+    int clients{4};
+    int size{512};
+};
+
+const std::vector<std::string> chains{
+    "black_and_white",
+    "convolution:sharpen",
+    "mirror:vertical,brightness:darker",
+    "pixelated:8,channels_swap",
+};
+
+constexpr int input_count = 3;
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, {{"--jobs", int_option(options.jobs)}, {"--clients", int_option(options.clients)}, {"--size", int_option(options.size)}})) return 2;
+    options.clients = std::min(options.clients, options.jobs);
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / ("image_editor_server_" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory / "direct");
+    std::filesystem::create_directories(directory / "server");
+    std::vector<std::filesystem::path> inputs;
+    for (int i{0}; i < input_count; i++)
+    {
+        inputs.push_back(directory / ("input_" + std::to_string(i) + ".png"));
+        make_input(options.size, options.size, i).save(inputs.back());
+    }
+    auto input_of = [&](int job) { return inputs[job % input_count]; };
+    auto chain_of = [&](int job) { return chains[job % chains.size()]; };
+    auto output_name = [](int job) { return std::to_string(job) + ".png"; };
+
+    // Sans serveur : chaque traitement décode son entrée
+    const auto direct_start = std::chrono::steady_clock::now();
+    for (int job{0}; job < options.jobs; job++)
+    {
+        sil::Image img{input_of(job)};
+        EffectChain::parse(chain_of(job)).apply(img);
+        img.save(directory / "direct" / output_name(job));
+    }
+    const std::chrono::duration<double> direct_time = std::chrono::steady_clock::now() - direct_start;
+
+    // Avec le serveur, plusieurs clients en même temps
+    JobServerOptions server_options;
+    server_options.socket_path = directory / "server.sock";
+    JobServer server{server_options};
+    std::thread server_thread{[&]() { server.run(); }};
+
+    std::atomic<int> next_job{0};
+    std::atomic<int> failed_jobs{0};
+    const auto server_start = std::chrono::steady_clock::now();
+    std::vector<std::thread> clients;
+    for (int c{0}; c < options.clients; c++)
+    {
+        clients.emplace_back([&]() {
+            JobClient client{server_options.socket_path};
+            for (int job = next_job++; job < options.jobs; job = next_job++)
+            {
+                const JobClient::Result result = client.run(input_of(job).string(), chain_of(job), (directory / "server" / output_name(job)).string());
+                if (!result.ok)
+                {
+                    std::cerr << "Traitement " << job << " : " << result.error << "\n";
+                    failed_jobs++;
+                }
+            }
+        });
+    }
+    for (std::thread& client : clients)
+    {
+        client.join();
+    }
+    const std::chrono::duration<double> server_time = std::chrono::steady_clock::now() - server_start;
+    failures += failed_jobs;
+
+    for (int job{0}; job < options.jobs; job++)
+    {
+        check(read_file(directory / "direct" / output_name(job)) == read_file(directory / "server" / output_name(job)),
+              "traitement " + std::to_string(job) + " (" + chain_of(job) + ") : le serveur n'a pas produit le même fichier");
+    }
+
+    // Aller-retour par mémoire partagée, sans fichier
+    const std::string shared_input = "/image_editor_test_in_" + std::to_string(getpid());
+    const std::string shared_output = "/image_editor_test_out_" + std::to_string(getpid());
+    {
+        const sil::Image source = make_input(options.size, options.size);
+        SharedImage::create(shared_input, source.width(), source.height()).assign(source);
+        JobClient client{server_options.socket_path};
+        const JobClient::Result result = client.run("shm:" + shared_input, chains[2], "shm:" + shared_output);
+
+        sil::Image expected = source;
+        EffectChain::parse(chains[2]).apply(expected);
+        check(result.ok && SharedImage::open(shared_output).to_image().pixels() == expected.pixels(),
+              "mémoire partagée : l'image renvoyée n'est pas celle attendue " + result.error);
+        SharedImage::remove(shared_input);
+        SharedImage::remove(shared_output);
+    }
+
+    // Une chaîne d'effets mal formée est refusée et signalée au client, au lieu d'exécuter une autre chaîne
+    {
+        JobClient client{server_options.socket_path};
+        for (const std::string chain : {"negative,", "blur_convolution:"})
+        {
+            const JobClient::Result result = client.run(input_of(0).string(), chain, (directory / "server" / "malformed.png").string());
+            check(!result.ok && !std::filesystem::exists(directory / "server" / "malformed.png"), "la chaîne \"" + chain + "\" doit être refusée");
+        }
+    }
+
+    // Une ligne trop longue ferme la connexion au lieu de remplir la mémoire du serveur
+    {
+        JobClient client{server_options.socket_path};
+        bool closed = false;
+        try
+        {
+            client.run(input_of(0).string(), std::string(max_line_length, 'a'), (directory / "server" / "too_long.png").string());
+        }
+        catch (const std::runtime_error&)
+        {
+            closed = true;
+        }
+        check(closed, "une ligne de plus de max_line_length octets doit fermer la connexion");
+    }
+
+    server.stop();
+    server_thread.join();
+    const JobServer::Stats stats = server.stats();
+    check(stats.cache.misses == input_count, "le serveur a décodé " + std::to_string(stats.cache.misses) + " image(s) au lieu de " + std::to_string(input_count));
+
+    std::cout << options.jobs << " traitements de " << options.size << "x" << options.size << "\n"
+              << "  sans serveur : " << options.jobs / direct_time.count() << " traitements/s\n"
+              << "  serveur, " << options.clients << " client(s) : " << options.jobs / server_time.count() << " traitements/s ("
+              << stats.cache.hits << " image(s) lue(s) dans le cache, " << stats.cache.misses << " décodage(s))\n";
+
+    std::filesystem::remove_all(directory);
+    return test_result();
+}
@@ -0,0 +1,164 @@
+#include "shared_image.hpp"
+#include "shared_memory.hpp"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+sil::Image PixelView::to_image() const
+{
+    sil::Image img{width, height};
+    std::copy_n(data, size(), img.pixels().data());
+    return img;
+}
+
+void PixelView::assign(const sil::Image& img) const
+{
+    if (img.width() != width || img.height() != height)
+    {
+        throw std::invalid_argument{"L'image n'a pas la taille de la vue"};
+    }
+    std::copy(img.pixels().begin(), img.pixels().end(), data);
+}
+
+void PixelView::save(std::filesystem::path path) const
+{
+    auto bytes = std::make_unique<uint8_t[]>(size() * 3);
+    for (size_t i{0}; i < size(); i++)
+    {
+        bytes[3 * i + 0] = sil::to_8bit(data[i].r);
+        bytes[3 * i + 1] = sil::to_8bit(data[i].g);
+        bytes[3 * i + 2] = sil::to_8bit(data[i].b);
+    }
+    sil::save_rgb8(std::move(path), width, height, std::move(bytes));
+}
+
+namespace {
+
+/// Taille et position des plans d'un segment de la taille donnée.
+SharedImage::Header layout(int width, int height, uint32_t planes)
+{
+    SharedImage::Header header{SharedImage::magic, SharedImage::version, width, height, planes, 0, {0, 0}, {0, 0}};
+    const uint64_t pixels = static_cast<uint64_t>(width) * height;
+    uint64_t offset = shared_memory::align(sizeof(SharedImage::Header));
+    if (planes & SharedImage::Float)
+    {
+        header.float_plane = {offset, pixels * sizeof(glm::vec3)};
+        offset = shared_memory::align(offset + header.float_plane.bytes);
+    }
+    if (planes & SharedImage::Bytes)
+    {
+        header.bytes_plane = {offset, pixels * 3};
+    }
+    return header;
+}
+
+uint64_t segment_size(const SharedImage::Header& header)
+{
+    return std::max({uint64_t{sizeof(SharedImage::Header)}, header.float_plane.offset + header.float_plane.bytes, header.bytes_plane.offset + header.bytes_plane.bytes});
+}
+
+} // namespace
+
+SharedImage SharedImage::create(const std::string& name, int width, int height, uint32_t planes)
+{
+    if (width < 0 || height < 0) throw std::invalid_argument{"Taille d'image négative pour le segment " + name};
+    if ((planes & (Float | Bytes)) == 0 || (planes & ~uint32_t{Float | Bytes}) != 0) throw std::invalid_argument{"Plans invalides pour le segment " + name};
+
+    const Header header = layout(width, height, planes);
+    const size_t size = segment_size(header);
+    SharedImage image{shared_memory::create(name, size), size};
+    *image._header = header; // Le segment est rempli de zéros à sa création : les pixels sont déjà noirs
+    return image;
+}
+
+SharedImage SharedImage::open(const std::string& name)
+{
+    size_t size = 0;
+    SharedImage image{shared_memory::open(name, size), size};
+    const Header& header = *image._header;
+    if (size < sizeof(Header) || header.magic != magic || header.version != version || header.width < 0 || header.height < 0)
+    {
+        throw std::runtime_error{"Le segment " + name + " ne contient pas une image valide"};
+    }
+    const Header expected = layout(header.width, header.height, header.planes);
+    if ((header.planes & (Float | Bytes)) == 0 || header.float_plane.offset != expected.float_plane.offset || header.bytes_plane.offset != expected.bytes_plane.offset
+        || segment_size(expected) > size)
+    {
+        throw std::runtime_error{"Le segment " + name + " ne contient pas une image valide"};
+    }
+    return image;
+}
+
+bool SharedImage::remove(const std::string& name)
+{
+    return shared_memory::remove(name);
+}
+
+SharedImage::SharedImage(void* mapping, size_t size)
+    : _header{static_cast<Header*>(mapping)}
+    , _size{size}
+{
+}
+
+SharedImage::SharedImage(SharedImage&& other) noexcept
+    : _header{std::exchange(other._header, nullptr)}
+    , _size{std::exchange(other._size, 0)}
+{
+}
+
+SharedImage& SharedImage::operator=(SharedImage&& other) noexcept
+{
+    std::swap(_header, other._header);
+    std::swap(_size, other._size);
+    return *this;
+}
+
+SharedImage::~SharedImage()
+{
+    if (_header != nullptr) shared_memory::unmap(_header, _size);
+}
+
+PixelView SharedImage::pixels() const
+{
+    if (!has(Float)) return PixelView{};
+    return PixelView{reinterpret_cast<glm::vec3*>(reinterpret_cast<char*>(_header) + _header->float_plane.offset), width(), height()};
+}
+
+uint8_t* SharedImage::bytes() const
+{
+    if (!has(Bytes)) return nullptr;
+    return reinterpret_cast<uint8_t*>(_header) + _header->bytes_plane.offset;
+}
+
+sil::Image SharedImage::to_image() const
+{
+    if (has(Float)) return pixels().to_image();
+
+    sil::Image img{width(), height()};
+    const uint8_t* data = bytes();
+    for (size_t i{0}; i < img.pixels().size(); i++)
+    {
+        img.pixels()[i] = glm::vec3{data[3 * i + 0], data[3 * i + 1], data[3 * i + 2]} / 255.f;
+    }
+    return img;
+}
+
+void SharedImage::assign(const sil::Image& img)
+{
+    if (img.width() != width() || img.height() != height())
+    {
+        throw std::invalid_argument{"L'image n'a pas la taille du segment"};
+    }
+    if (has(Float)) pixels().assign(img);
+    if (has(Bytes))
+    {
+        uint8_t* data = bytes();
+        for (size_t i{0}; i < img.pixels().size(); i++)
+        {
+            data[3 * i + 0] = sil::to_8bit(img.pixels()[i].r);
+            data[3 * i + 1] = sil::to_8bit(img.pixels()[i].g);
+            data[3 * i + 2] = sil::to_8bit(img.pixels()[i].b);
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <sil/sil.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+/**
+ * Vue sur des pixels rangés comme ceux de sil::Image (glm::vec3 ligne par ligne, de gauche à droite et de bas en haut), sans les posséder :
+ * plan d'un segment SharedImage ou emplacement d'un SharedImageRing. Les pixels restent valides tant que le segment est projeté.
+ */
+struct PixelView
+{
+    glm::vec3* data{nullptr};
+    int width{0};
+    int height{0};
+
+    glm::vec3& pixel(int x, int y) const { return data[x + static_cast<size_t>(y) * width]; }
+    size_t size() const { return static_cast<size_t>(width) * height; }
+
+    /// Copie les pixels dans une nouvelle sil::Image.
+    sil::Image to_image() const;
+
+    /// Copie les pixels d'une image de la même taille. Lance std::invalid_argument si la taille est différente.
+    void assign(const sil::Image& img) const;
+
+    /// Enregistre les pixels en png ou jpeg directement depuis la mémoire projetée, sans construire de sil::Image (même quantification que Image::save()).
+    void save(std::filesystem::path path) const;
+};
+
+/**
+ * Image rangée dans un segment de mémoire partagée POSIX (shm_open), que plusieurs processus projettent en même temps :
+ * une image décodée ou un résultat passe d'un processus à l'autre sans fichier ni sérialisation.
+ *
+ * Le segment commence par un en-tête (Header) qui décrit un ou deux plans de pixels, chacun aligné sur 64 octets :
+ *   - Float : width * height glm::vec3, exactement la disposition de sil::Image::pixels(), lisible et modifiable en place par une PixelView ;
+ *   - Bytes : width * height * 3 octets RGB, la disposition de ImageU8 et de ce qu'enregistre Image::save() (quatre fois plus compact).
+ * Le segment reste projeté tant que l'objet existe ; il n'est supprimé du système que par SharedImage::remove().
+ */
+class SharedImage
+{
+public:
+    /// Valeur de Header::magic ("SILI").
+    static constexpr uint32_t magic = 0x494C4953;
+    static constexpr uint32_t version = 2;
+
+    /// Plans présents dans le segment (combinables avec |).
+    enum Planes : uint32_t
+    {
+        Float = 1,
+        Bytes = 2,
+    };
+
+    struct Plane
+    {
+        uint64_t offset; // Depuis le début du segment (0 : plan absent)
+        uint64_t bytes;
+    };
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        int32_t width;
+        int32_t height;
+        uint32_t planes; // Combinaison de Planes
+        uint32_t reserved;
+        Plane float_plane;
+        Plane bytes_plane;
+    };
+
+    /**
+     * Crée (ou remplace) le segment `name` pour une image de la taille donnée, initialisée en noir.
+     * Lance std::runtime_error si le segment ne peut pas être créé.
+     *
+     * @param name Nom du segment, qui commence par '/' (par exemple "/image_editor_input").
+     * @param planes Plans à réserver (par défaut Float seulement).
+     */
+    static SharedImage create(const std::string& name, int width, int height, uint32_t planes = Float);
+
+    /// Ouvre un segment existant, en lecture et écriture. Lance std::runtime_error s'il n'existe pas ou si son en-tête est invalide.
+    static SharedImage open(const std::string& name);
+
+    /// Supprime le segment du système (les processus qui l'ont déjà ouvert gardent leur projection). Renvoie false s'il n'existait pas.
+    static bool remove(const std::string& name);
+
+    SharedImage(SharedImage&& other) noexcept;
+    SharedImage& operator=(SharedImage&& other) noexcept;
+    SharedImage(const SharedImage&) = delete;
+    SharedImage& operator=(const SharedImage&) = delete;
+    ~SharedImage();
+
+    int width() const { return _header->width; }
+    int height() const { return _header->height; }
+    bool has(Planes plane) const { return (_header->planes & plane) != 0; }
+
+    /// Plan Float, lu et modifié en place (vue vide si le segment n'a pas ce plan).
+    PixelView pixels() const;
+
+    /// Plan Bytes (3 octets par pixel), ou nullptr si le segment n'a pas ce plan.
+    uint8_t* bytes() const;
+
+    /// Image flottante : copie du plan Float, sinon conversion du plan Bytes (chaque canal divisé par 255, comme au chargement d'un fichier).
+    sil::Image to_image() const;
+
+    /// Écrit une image de la même taille dans tous les plans du segment (le plan Bytes avec la quantification de Image::save()).
+    void assign(const sil::Image& img);
+
+private:
+    SharedImage(void* mapping, size_t size);
+
+    Header* _header{nullptr};
+    size_t _size{0};
+};
@@ -0,0 +1,67 @@
+#include "shared_memory.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace shared_memory {
+
+namespace {
+
+/// Ferme `fd` s'il est ouvert et lance l'erreur système courante.
+[[noreturn]] void fail(const std::string& what, const std::string& name, int fd = -1)
+{
+    const int error = errno;
+    if (fd >= 0) close(fd);
+    throw std::runtime_error{what + " " + name + " : " + std::strerror(error)};
+}
+
+/// Projette tout le segment ouvert `fd`, puis le ferme (la projection garde le segment).
+void* map(int fd, size_t size, const std::string& name)
+{
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) fail("Impossible de projeter le segment", name, fd);
+    close(fd);
+    return mapping;
+}
+
+} // namespace
+
+void* create(const std::string& name, size_t size)
+{
+    const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+    if (fd < 0) fail("Impossible de créer le segment", name);
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) fail("Impossible de dimensionner le segment", name, fd);
+    return map(fd, size, name);
+}
+
+void* open(const std::string& name, size_t& size)
+{
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) fail("Impossible d'ouvrir le segment", name);
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0) fail("Impossible de lire la taille du segment", name, fd);
+    size = static_cast<size_t>(info.st_size);
+    if (size == 0)
+    {
+        close(fd);
+        throw std::runtime_error{"Le segment " + name + " est vide"};
+    }
+    return map(fd, size, name);
+}
+
+void unmap(void* mapping, size_t size)
+{
+    munmap(mapping, size);
+}
+
+bool remove(const std::string& name)
+{
+    return shm_unlink(name.c_str()) == 0;
+}
+
+} // namespace shared_memory
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Segments de mémoire partagée POSIX (shm_open + mmap), utilisés par SharedImage et SharedImageRing.
+ * Les fonctions lancent std::runtime_error avec le message du système en cas d'échec.
+ */
+namespace shared_memory {
+
+/// Arrondit au multiple de 64 octets supérieur (une ligne de cache), pour que deux plans ou deux emplacements ne partagent pas de ligne.
+constexpr uint64_t align(uint64_t bytes)
+{
+    return (bytes + 63) / 64 * 64;
+}
+
+/// Crée (ou remplace) le segment `name` de `size` octets, rempli de zéros, et le projette en lecture et écriture.
+void* create(const std::string& name, size_t size);
+
+/// Projette un segment existant en lecture et écriture, et renvoie sa taille dans `size`.
+void* open(const std::string& name, size_t& size);
+
+/// Retire la projection.
+void unmap(void* mapping, size_t size);
+
+/// Supprime le segment du système. Renvoie false s'il n'existait pas.
+bool remove(const std::string& name);
+
+} // namespace shared_memory
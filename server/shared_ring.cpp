@@ -0,0 +1,227 @@
+#include "shared_ring.hpp"
+#include "shared_memory.hpp"
+#include <atomic>
+#include <cerrno>
+#include <ctime>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <semaphore.h>
+
+// Les compteurs sont partagés entre processus : ils ne doivent pas dépendre d'un verrou propre à un processus
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+struct SharedImageRing::Header
+{
+    uint32_t magic;
+    uint32_t version;
+    int32_t slots;
+    int32_t max_width;
+    int32_t max_height;
+    int32_t reserved;
+    uint64_t slot_bytes;        // Taille d'un emplacement (en-tête et pixels), multiple de 64
+    uint64_t first_slot;        // Position du premier emplacement depuis le début du segment
+    std::atomic<uint64_t> head; // Nombre d'images publiées (modifié par le producteur)
+    std::atomic<uint64_t> tail; // Nombre d'images lues et rendues (modifié par le consommateur)
+    std::atomic<uint32_t> closed;
+    sem_t free_slots;   // Emplacements que le producteur peut remplir
+    sem_t filled_slots; // Images à lire, plus un jeton ajouté par close()
+};
+
+struct SharedImageRing::SlotHeader
+{
+    int32_t width;
+    int32_t height;
+    uint64_t sequence;
+};
+
+namespace {
+
+constexpr uint64_t slot_pixels_offset = 64; // Les pixels suivent l'en-tête de l'emplacement, sur une ligne de cache à part
+
+/// Attend un jeton du sémaphore, au plus `timeout`. Renvoie false si le délai est dépassé.
+bool wait(sem_t* semaphore, std::chrono::milliseconds timeout)
+{
+    if (timeout == std::chrono::milliseconds::max())
+    {
+        while (sem_wait(semaphore) != 0)
+        {
+            if (errno != EINTR) throw std::runtime_error{"Erreur en attendant la file d'images"};
+        }
+        return true;
+    }
+
+    timespec deadline{};
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count() + deadline.tv_nsec;
+    deadline.tv_sec += static_cast<time_t>(nanoseconds / 1'000'000'000);
+    deadline.tv_nsec = static_cast<long>(nanoseconds % 1'000'000'000);
+    while (sem_timedwait(semaphore, &deadline) != 0)
+    {
+        if (errno == ETIMEDOUT) return false;
+        if (errno != EINTR) throw std::runtime_error{"Erreur en attendant la file d'images"};
+    }
+    return true;
+}
+
+} // namespace
+
+SharedImageRing SharedImageRing::create(const std::string& name, int slots, int max_width, int max_height)
+{
+    if (slots < 1 || max_width < 0 || max_height < 0) throw std::invalid_argument{"Taille invalide pour la file " + name};
+
+    const uint64_t slot_bytes = shared_memory::align(slot_pixels_offset + static_cast<uint64_t>(max_width) * max_height * sizeof(glm::vec3));
+    const uint64_t first_slot = shared_memory::align(sizeof(Header));
+    const size_t size = first_slot + slot_bytes * slots;
+
+    SharedImageRing ring{shared_memory::create(name, size), size};
+    Header* header = new (ring._header) Header{magic, version, slots, max_width, max_height, 0, slot_bytes, first_slot, {0}, {0}, {0}, {}, {}};
+    if (sem_init(&header->free_slots, 1, static_cast<unsigned>(slots)) != 0 || sem_init(&header->filled_slots, 1, 0) != 0)
+    {
+        throw std::runtime_error{"Impossible de créer les sémaphores de la file " + name};
+    }
+    return ring;
+}
+
+SharedImageRing SharedImageRing::open(const std::string& name)
+{
+    size_t size = 0;
+    SharedImageRing ring{shared_memory::open(name, size), size};
+    const Header& header = *ring._header;
+    if (size < sizeof(Header) || header.magic != magic || header.version != version || header.slots < 1
+        || header.first_slot + header.slot_bytes * static_cast<uint64_t>(header.slots) > size)
+    {
+        throw std::runtime_error{"Le segment " + name + " ne contient pas une file d'images valide"};
+    }
+    return ring;
+}
+
+bool SharedImageRing::remove(const std::string& name)
+{
+    return shared_memory::remove(name);
+}
+
+SharedImageRing::SharedImageRing(void* mapping, size_t size)
+    : _header{static_cast<Header*>(mapping)}
+    , _size{size}
+{
+}
+
+SharedImageRing::SharedImageRing(SharedImageRing&& other) noexcept
+    : _header{std::exchange(other._header, nullptr)}
+    , _size{std::exchange(other._size, 0)}
+{
+}
+
+SharedImageRing& SharedImageRing::operator=(SharedImageRing&& other) noexcept
+{
+    std::swap(_header, other._header);
+    std::swap(_size, other._size);
+    return *this;
+}
+
+SharedImageRing::~SharedImageRing()
+{
+    // Les sémaphores vivent dans le segment : ils disparaissent avec lui, après le dernier remove() et la dernière projection
+    if (_header != nullptr) shared_memory::unmap(_header, _size);
+}
+
+int SharedImageRing::slots() const
+{
+    return _header->slots;
+}
+
+int SharedImageRing::max_width() const
+{
+    return _header->max_width;
+}
+
+int SharedImageRing::max_height() const
+{
+    return _header->max_height;
+}
+
+SharedImageRing::SlotHeader* SharedImageRing::slot(uint64_t index) const
+{
+    static_assert(sizeof(SlotHeader) <= slot_pixels_offset);
+    char* base = reinterpret_cast<char*>(_header) + _header->first_slot;
+    return reinterpret_cast<SlotHeader*>(base + (index % static_cast<uint64_t>(_header->slots)) * _header->slot_bytes);
+}
+
+std::optional<SharedImageRing::Slot> SharedImageRing::acquire_write(int width, int height, std::chrono::milliseconds timeout)
+{
+    if (width < 0 || height < 0 || width > _header->max_width || height > _header->max_height)
+    {
+        throw std::invalid_argument{"L'image dépasse la taille maximale de la file"};
+    }
+    if (!wait(&_header->free_slots, timeout)) return std::nullopt;
+
+    // La taille est fixée dès la réservation : le producteur écrit avec la même disposition que celle que lira le consommateur
+    const uint64_t index = _header->head.load(std::memory_order_relaxed); // Seul le producteur modifie head
+    SlotHeader* header = slot(index);
+    header->width = width;
+    header->height = height;
+    header->sequence = index;
+    glm::vec3* pixels = reinterpret_cast<glm::vec3*>(reinterpret_cast<char*>(header) + slot_pixels_offset);
+    return Slot{PixelView{pixels, width, height}, index};
+}
+
+void SharedImageRing::publish()
+{
+    const uint64_t index = _header->head.load(std::memory_order_relaxed);
+    _header->head.store(index + 1, std::memory_order_release);
+    sem_post(&_header->filled_slots);
+}
+
+bool SharedImageRing::push(const sil::Image& img, std::chrono::milliseconds timeout)
+{
+    const std::optional<Slot> free = acquire_write(img.width(), img.height(), timeout);
+    if (!free) return false;
+    free->pixels.assign(img);
+    publish();
+    return true;
+}
+
+void SharedImageRing::close()
+{
+    _header->closed.store(1, std::memory_order_release);
+    sem_post(&_header->filled_slots);
+}
+
+std::optional<SharedImageRing::Slot> SharedImageRing::acquire_read(std::chrono::milliseconds timeout)
+{
+    if (!wait(&_header->filled_slots, timeout)) return std::nullopt;
+
+    const uint64_t index = _header->tail.load(std::memory_order_relaxed); // Seul le consommateur modifie tail
+    if (index == _header->head.load(std::memory_order_acquire))
+    {
+        // Jeton de close() : la file est finie. On le remet pour que les appels suivants le voient aussi.
+        sem_post(&_header->filled_slots);
+        return std::nullopt;
+    }
+
+    SlotHeader* header = slot(index);
+    glm::vec3* pixels = reinterpret_cast<glm::vec3*>(reinterpret_cast<char*>(header) + slot_pixels_offset);
+    return Slot{PixelView{pixels, header->width, header->height}, header->sequence};
+}
+
+void SharedImageRing::release()
+{
+    _header->tail.store(_header->tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    sem_post(&_header->free_slots);
+}
+
+std::optional<sil::Image> SharedImageRing::pop(std::chrono::milliseconds timeout)
+{
+    const std::optional<Slot> filled = acquire_read(timeout);
+    if (!filled) return std::nullopt;
+    sil::Image img = filled->pixels.to_image();
+    release();
+    return img;
+}
+
+bool SharedImageRing::finished() const
+{
+    return _header->closed.load(std::memory_order_acquire) != 0 && _header->tail.load(std::memory_order_acquire) == _header->head.load(std::memory_order_acquire);
+}
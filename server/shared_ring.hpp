@@ -0,0 +1,102 @@
+#pragma once
+#include "shared_image.hpp"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/**
+ * File circulaire d'images dans un segment de mémoire partagée, entre un processus producteur et un processus consommateur
+ * (par exemple un processus qui décode des images et un processus qui leur applique des effets).
+ * Le segment contient `slots` emplacements de max_width * max_height pixels, dans la disposition de sil::Image.
+ * Le producteur écrit directement dans l'emplacement libre suivant (acquire_write() puis publish()), ligne après ligne sans écart entre les lignes,
+ * le consommateur lit directement dans l'emplacement plein suivant (acquire_read() puis release()) : aucune copie ni sérialisation entre les deux.
+ * Deux sémaphores partagés entre processus comptent les emplacements libres et pleins : une file pleine bloque le producteur, une file vide le consommateur.
+ * Un seul producteur et un seul consommateur par file : pour répartir un lot sur plusieurs processus, on crée une file par processus.
+ */
+class SharedImageRing
+{
+public:
+    /// Valeur de Header::magic ("SILR").
+    static constexpr uint32_t magic = 0x524C4953;
+    static constexpr uint32_t version = 1;
+
+    /// Emplacement réservé par acquire_write() ou acquire_read().
+    struct Slot
+    {
+        PixelView pixels;   // Pixels de l'image, à la taille demandée à acquire_write() (les lignes se suivent, sans écart de max_width)
+        uint64_t sequence;  // Numéro de l'image dans la file (0 pour la première)
+    };
+
+    /**
+     * Crée (ou remplace) la file `name`, vide.
+     * Lance std::runtime_error si le segment ne peut pas être créé.
+     *
+     * @param name Nom du segment, qui commence par '/'.
+     * @param slots Nombre d'emplacements (au moins 1).
+     * @param max_width Largeur maximale des images de la file.
+     * @param max_height Hauteur maximale des images de la file.
+     */
+    static SharedImageRing create(const std::string& name, int slots, int max_width, int max_height);
+
+    /// Ouvre une file créée par un autre processus. Lance std::runtime_error si elle n'existe pas ou si son en-tête est invalide.
+    static SharedImageRing open(const std::string& name);
+
+    /// Supprime le segment du système (les processus qui l'ont déjà ouvert gardent leur projection). Renvoie false s'il n'existait pas.
+    static bool remove(const std::string& name);
+
+    SharedImageRing(SharedImageRing&& other) noexcept;
+    SharedImageRing& operator=(SharedImageRing&& other) noexcept;
+    SharedImageRing(const SharedImageRing&) = delete;
+    SharedImageRing& operator=(const SharedImageRing&) = delete;
+    ~SharedImageRing();
+
+    int slots() const;
+    int max_width() const;
+    int max_height() const;
+
+    /* ----- Producteur ----- */
+
+    /**
+     * Attend un emplacement libre et le réserve pour une image de width x height. Le producteur écrit son image par la PixelView renvoyée, puis appelle publish().
+     * Renvoie std::nullopt si aucun emplacement ne s'est libéré avant `timeout`.
+     * Lance std::invalid_argument si l'image dépasse la taille maximale de la file.
+     */
+    std::optional<Slot> acquire_write(int width, int height, std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /// Rend visible au consommateur l'image écrite dans l'emplacement réservé par acquire_write().
+    void publish();
+
+    /// Copie une image dans la file (acquire_write() puis publish()). Renvoie false si la file est restée pleine jusqu'à `timeout`.
+    bool push(const sil::Image& img, std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /// Indique qu'aucune image ne sera plus publiée : le consommateur lit les images restantes, puis acquire_read() renvoie std::nullopt.
+    void close();
+
+    /* ----- Consommateur ----- */
+
+    /**
+     * Attend la prochaine image publiée. Ses pixels sont lus (ou modifiés) en place, jusqu'à l'appel de release().
+     * Renvoie std::nullopt si la file est fermée et vide, ou si aucune image n'est arrivée avant `timeout`.
+     */
+    std::optional<Slot> acquire_read(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /// Rend au producteur l'emplacement lu.
+    void release();
+
+    /// Copie la prochaine image dans une sil::Image (acquire_read() puis release()).
+    std::optional<sil::Image> pop(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /// Vrai si close() a été appelé et que toutes les images ont été lues.
+    bool finished() const;
+
+private:
+    struct Header;
+    struct SlotHeader;
+
+    SharedImageRing(void* mapping, size_t size);
+    SlotHeader* slot(uint64_t index) const;
+
+    Header* _header{nullptr};
+    size_t _size{0};
+};
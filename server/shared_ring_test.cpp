@@ -0,0 +1,143 @@
+#include "shared_image.hpp"
+#include "shared_ring.hpp"
+#include <test_helpers.hpp>
+#include <effect_chain.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * Test des échanges d'images entre processus par mémoire partagée : un processus fils lit les images d'une SharedImageRing,
+ * leur applique une chaîne d'effets et écrit les résultats dans une seconde file ; le processus parent écrit ses images directement
+ * dans les emplacements de la première file et compare les résultats en place dans la seconde, sans fichier ni copie intermédiaire.
+ * Vérifie aussi un aller-retour par SharedImage avec ses deux plans (flottants et octets).
+ * Affiche le débit de l'aller-retour et renvoie 1 si une image reçue n'est pas celle attendue.
+ *
+ * Usage : shared_ring_test [--frames 64] [--size 512] [--chain negative]
+ */
+
+namespace {
+
+struct Options
+{
+    int frames{64};
+    int size{512};
+    std::string chain{"negative"};
+};
+
+constexpr std::chrono::milliseconds timeout{30'000}; // Si le fils s'arrête, le parent ne reste pas bloqué
+
+/// Image numéro `frame`, écrite directement dans les pixels de destination.
+void draw_frame(const PixelView& view, int frame)
+{
+    for (int y{0}; y < view.height; y++)
+    {
+        for (int x{0}; x < view.width; x++)
+        {
+            view.pixel(x, y) = glm::vec3{static_cast<float>((x + frame) % 256) / 255.f, static_cast<float>((y * 3 + frame) % 256) / 255.f,
+                                         static_cast<float>(frame % 7) / 7.f};
+        }
+    }
+}
+
+/// Processus fils : applique la chaîne à chaque image de `input` et écrit le résultat dans `output`, jusqu'à la fermeture de `input`.
+int transform_frames(const std::string& input_name, const std::string& output_name, const EffectChain& chain)
+{
+    SharedImageRing input = SharedImageRing::open(input_name);
+    SharedImageRing output = SharedImageRing::open(output_name);
+    while (std::optional<sil::Image> img = input.pop())
+    {
+        chain.apply(*img); // Les effets travaillent sur une sil::Image : une copie en sortant de la file, une en entrant dans la suivante
+        output.push(*img);
+    }
+    output.close();
+    return input.finished() ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, {{"--frames", int_option(options.frames)}, {"--size", int_option(options.size)}, {"--chain", string_option(options.chain)}})) return 2;
+    const EffectChain chain = EffectChain::parse(options.chain);
+
+    // Image avec ses deux plans
+    const std::string image_name = "/image_editor_image_" + std::to_string(getpid());
+    {
+        sil::Image source{options.size, options.size};
+        draw_frame(PixelView{source.pixels().data(), source.width(), source.height()}, 1);
+        SharedImage::create(image_name, source.width(), source.height(), SharedImage::Float | SharedImage::Bytes).assign(source);
+
+        const SharedImage shared = SharedImage::open(image_name);
+        const uint8_t* bytes = shared.bytes();
+        bool same = shared.to_image().pixels() == source.pixels();
+        for (size_t i{0}; i < source.pixels().size() && same; i++)
+        {
+            same = bytes[3 * i] == sil::to_8bit(source.pixels()[i].r) && bytes[3 * i + 1] == sil::to_8bit(source.pixels()[i].g) && bytes[3 * i + 2] == sil::to_8bit(source.pixels()[i].b);
+        }
+        check(same, "SharedImage : les plans relus ne correspondent pas à l'image écrite");
+        SharedImage::remove(image_name);
+    }
+
+    // Aller-retour par deux files, avec un processus fils
+    const std::string input_name = "/image_editor_ring_in_" + std::to_string(getpid());
+    const std::string output_name = "/image_editor_ring_out_" + std::to_string(getpid());
+    // Emplacements plus grands que les images : les lignes écrites par le parent doivent être relues au même endroit par le fils
+    SharedImageRing input = SharedImageRing::create(input_name, 4, options.size + 17, options.size + 3);
+    SharedImageRing output = SharedImageRing::create(output_name, 4, options.size, options.size);
+
+    // Le fils est créé avant tout thread du parent
+    const pid_t child = fork();
+    if (child < 0)
+    {
+        std::cerr << "fork impossible\n";
+        return 2;
+    }
+    if (child == 0) _exit(transform_frames(input_name, output_name, chain));
+
+    const auto start = std::chrono::steady_clock::now();
+    std::thread producer{[&]() {
+        for (int frame{0}; frame < options.frames; frame++)
+        {
+            const std::optional<SharedImageRing::Slot> slot = input.acquire_write(options.size, options.size, timeout);
+            if (!slot) break;
+            draw_frame(slot->pixels, frame);
+            input.publish();
+        }
+        input.close();
+    }};
+
+    int received = 0;
+    sil::Image expected{options.size, options.size};
+    while (const std::optional<SharedImageRing::Slot> slot = output.acquire_read(timeout))
+    {
+        draw_frame(PixelView{expected.pixels().data(), expected.width(), expected.height()}, static_cast<int>(slot->sequence));
+        chain.apply(expected);
+        check(slot->sequence == static_cast<uint64_t>(received) && slot->pixels.width == expected.width() && slot->pixels.height == expected.height()
+                  && std::equal(expected.pixels().begin(), expected.pixels().end(), slot->pixels.data),
+              "image " + std::to_string(slot->sequence) + " : le résultat reçu n'est pas celui attendu");
+        output.release();
+        received++;
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    producer.join();
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    check(WIFEXITED(status) && WEXITSTATUS(status) == 0 && received == options.frames && output.finished(),
+          std::to_string(received) + " image(s) reçue(s) sur " + std::to_string(options.frames) + ", code de sortie du fils " + std::to_string(status));
+    SharedImageRing::remove(input_name);
+    SharedImageRing::remove(output_name);
+
+    const double megabytes = 2. * options.frames * options.size * options.size * sizeof(glm::vec3) / (1024. * 1024.);
+    std::cout << options.frames << " images de " << options.size << "x" << options.size << " aller-retour (" << options.chain << ") : "
+              << options.frames / elapsed.count() << " images/s, " << megabytes / elapsed.count() << " Mo/s échangés\n";
+
+    return test_result();
+}
@@ -0,0 +1,208 @@
+#include "bilateral.hpp"
+#include <sil/metrics.hpp>
+#include <sil/trace.hpp>
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+float luminance(const glm::vec3& c)
+{
+    return std::clamp(0.299f * c.r + 0.587f * c.g + 0.114f * c.b, 0.f, 1.f);
+}
+
+/**
+ * Grille 3D (x, y, luminosité) : chaque case accumule la somme des couleurs (xyz) et la somme des poids (w) des pixels qui y tombent.
+ * Une case de marge de chaque côté permet de flouter sans tester les bords.
+ */
+struct BilateralGrid
+{
+    static constexpr int padding = 2;
+
+    int size_x;
+    int size_y;
+    int size_z;
+    std::vector<glm::vec4> cells;
+
+    BilateralGrid(int width, int height, float spatial_sigma, float range_sigma)
+        : size_x{static_cast<int>((width - 1) / spatial_sigma) + 1 + 2 * padding}
+        , size_y{static_cast<int>((height - 1) / spatial_sigma) + 1 + 2 * padding}
+        , size_z{static_cast<int>(1.f / range_sigma) + 1 + 2 * padding}
+        , cells(static_cast<size_t>(size_x) * size_y * size_z, glm::vec4{0.f})
+    {
+    }
+
+    size_t index(int x, int y, int z) const { return x + static_cast<size_t>(size_x) * (y + static_cast<size_t>(size_y) * z); }
+};
+
+/**
+ * Floute la grille avec le noyau binomial [1 4 6 4 1] / 16 (variance de 1 case) le long de l'axe donné.
+ * `stride` est l'écart en mémoire entre deux cases voisines sur cet axe.
+ */
+void blur_axis(BilateralGrid& grid, std::vector<glm::vec4>& scratch, size_t stride, int axis_size)
+{
+    constexpr float binomial[5] = {1.f / 16.f, 4.f / 16.f, 6.f / 16.f, 4.f / 16.f, 1.f / 16.f};
+    // Réparti par lignes de la grille (size_x cases contiguës) : le nombre de cases peut dépasser un int sur les grandes images
+    const int rows = grid.size_y * grid.size_z;
+    const size_t row_size = static_cast<size_t>(grid.size_x);
+
+    parallel_for_bands(0, rows, [&](int begin, int end) {
+        for (size_t i{begin * row_size}; i < end * row_size; i++)
+        {
+            // Position de la case le long de l'axe, pour ne pas sortir de la grille
+            const int position = static_cast<int>((i / stride) % static_cast<size_t>(axis_size));
+            glm::vec4 sum{0.f};
+            for (int k{-2}; k <= 2; k++)
+            {
+                if (position + k < 0 || position + k >= axis_size) continue;
+                sum += binomial[k + 2] * grid.cells[i + k * static_cast<std::ptrdiff_t>(stride)];
+            }
+            scratch[i] = sum;
+        }
+    }, std::max(1, 4096 / grid.size_x));
+
+    std::swap(grid.cells, scratch);
+}
+
+glm::vec4 trilinear(const BilateralGrid& grid, float x, float y, float z)
+{
+    const int x0 = std::clamp(static_cast<int>(x), 0, grid.size_x - 2);
+    const int y0 = std::clamp(static_cast<int>(y), 0, grid.size_y - 2);
+    const int z0 = std::clamp(static_cast<int>(z), 0, grid.size_z - 2);
+    const float fx = x - x0;
+    const float fy = y - y0;
+    const float fz = z - z0;
+
+    auto lerp_x = [&](int yy, int zz) {
+        return glm::mix(grid.cells[grid.index(x0, yy, zz)], grid.cells[grid.index(x0 + 1, yy, zz)], fx);
+    };
+    const glm::vec4 c0 = glm::mix(lerp_x(y0, z0), lerp_x(y0 + 1, z0), fy);
+    const glm::vec4 c1 = glm::mix(lerp_x(y0, z0 + 1), lerp_x(y0 + 1, z0 + 1), fy);
+    return glm::mix(c0, c1, fz);
+}
+
+} // namespace
+
+void bilateral_filter(sil::Image& img, float spatial_sigma, float range_sigma)
+{
+    SIL_TRACE_SCOPE("bilateral_filter");
+    SIL_EFFECT_METRICS("bilateral_filter", img.width() * img.height());
+    if (spatial_sigma <= 0.f || range_sigma <= 0.f) return;
+
+    const int w = img.width();
+    const int h = img.height();
+    const int pad = BilateralGrid::padding;
+
+    // Splat : chaque bande de lignes remplit les seules lignes de la grille où tombent ses pixels (une tranche de la grille),
+    // puis les tranches sont additionnées dans la grille complète : la mémoire ne dépend pas du nombre de bandes
+    BilateralGrid grid{w, h, spatial_sigma, range_sigma};
+    const int bands = std::min(thread_count(), std::max(h / 64, 1));
+    auto grid_row = [&](int y) { return static_cast<int>(std::lround(y / spatial_sigma)) + pad; };
+
+    struct Slab
+    {
+        int first_row;
+        int rows;
+        std::vector<glm::vec4> cells; // Disposition de BilateralGrid, limitée aux lignes [first_row, first_row + rows)
+    };
+    std::vector<Slab> slabs(bands);
+
+    parallel_for_bands(0, bands, [&](int band_begin, int band_end) {
+        for (int band{band_begin}; band < band_end; band++)
+        {
+            const int y_begin = h * band / bands;
+            const int y_end = h * (band + 1) / bands;
+            Slab& slab = slabs[band];
+            slab.first_row = grid_row(y_begin);
+            slab.rows = grid_row(y_end - 1) - slab.first_row + 1;
+            slab.cells.assign(static_cast<size_t>(grid.size_x) * slab.rows * grid.size_z, glm::vec4{0.f});
+
+            for (int y{y_begin}; y < y_end; y++)
+            {
+                const size_t gy = static_cast<size_t>(grid_row(y) - slab.first_row);
+                for (int x{0}; x < w; x++)
+                {
+                    const glm::vec3& c = img.pixel(x, y);
+                    const int gx = static_cast<int>(std::lround(x / spatial_sigma)) + pad;
+                    const int gz = static_cast<int>(std::lround(luminance(c) / range_sigma)) + pad;
+                    slab.cells[gx + static_cast<size_t>(grid.size_x) * (gy + static_cast<size_t>(slab.rows) * gz)] += glm::vec4{c, 1.f};
+                }
+            }
+        }
+    }, 1);
+
+    // Les tranches voisines peuvent partager une ligne de la grille : chaque plan de luminosité est additionné par un seul thread
+    parallel_for_bands(0, grid.size_z, [&](int z_begin, int z_end) {
+        for (int z{z_begin}; z < z_end; z++)
+        {
+            for (const Slab& slab : slabs)
+            {
+                for (int row{0}; row < slab.rows; row++)
+                {
+                    const glm::vec4* from = slab.cells.data() + static_cast<size_t>(grid.size_x) * (row + static_cast<size_t>(slab.rows) * z);
+                    glm::vec4* to = grid.cells.data() + grid.index(0, slab.first_row + row, z);
+                    for (int x{0}; x < grid.size_x; x++) to[x] += from[x];
+                }
+            }
+        }
+    }, 1);
+    slabs.clear();
+
+    // Flou de la grille, axe par axe
+    std::vector<glm::vec4> scratch(grid.cells.size());
+    blur_axis(grid, scratch, 1, grid.size_x);
+    blur_axis(grid, scratch, grid.size_x, grid.size_y);
+    blur_axis(grid, scratch, static_cast<size_t>(grid.size_x) * grid.size_y, grid.size_z);
+
+    // Slice : interpolation trilinéaire puis normalisation par le poids accumulé
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            for (int x{0}; x < w; x++)
+            {
+                glm::vec3& c = img.pixel(x, y);
+                const glm::vec4 v = trilinear(grid, x / spatial_sigma + pad, y / spatial_sigma + pad, luminance(c) / range_sigma + pad);
+                if (v.w > 0.f) c = glm::vec3{v} / v.w;
+            }
+        }
+    });
+}
+
+void bilateral_filter_reference(sil::Image& img, float spatial_sigma, float range_sigma)
+{
+    SIL_TRACE_SCOPE("bilateral_filter_reference");
+    if (spatial_sigma <= 0.f || range_sigma <= 0.f) return;
+
+    const int w = img.width();
+    const int h = img.height();
+    const int radius = static_cast<int>(std::ceil(2.f * spatial_sigma));
+    const sil::Image original = img;
+
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            for (int x{0}; x < w; x++)
+            {
+                const float l = luminance(original.pixel(x, y));
+                glm::vec3 sum{0.f};
+                float weights = 0.f;
+
+                for (int dy{std::max(-radius, -y)}; dy <= std::min(radius, h - 1 - y); dy++)
+                {
+                    for (int dx{std::max(-radius, -x)}; dx <= std::min(radius, w - 1 - x); dx++)
+                    {
+                        const glm::vec3& c = original.pixel(x + dx, y + dy);
+                        const float dl = luminance(c) - l;
+                        const float weight = std::exp(-(dx * dx + dy * dy) / (2.f * spatial_sigma * spatial_sigma) - dl * dl / (2.f * range_sigma * range_sigma));
+                        sum += weight * c;
+                        weights += weight;
+                    }
+                }
+
+                img.pixel(x, y) = sum / weights;
+            }
+        }
+    });
+}
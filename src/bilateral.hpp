@@ -0,0 +1,24 @@
+#pragma once
+#include <sil/sil.hpp>
+
+/**
+ * Applique un filtre bilatéral : un flou qui ne mélange que les pixels proches dans l'image ET de luminosité proche, ce qui lisse les zones unies en préservant les bords.
+ * Calculé avec une grille bilatérale : les pixels sont accumulés (splat) dans une grille 3D sous-échantillonnée (x, y, luminosité),
+ * la grille est floutée, puis chaque pixel lit son résultat dans la grille par interpolation trilinéaire (slice).
+ * Le coût ne dépend presque pas de spatial_sigma : plus il est grand, plus la grille est petite.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param spatial_sigma Écart type spatial du flou, en pixels (par défaut 16).
+ * @param range_sigma Écart type sur la luminosité, entre 0 et 1 (par défaut 0.1).
+ */
+void bilateral_filter(sil::Image& img, float spatial_sigma = 16.f, float range_sigma = 0.1f);
+
+/**
+ * Filtre bilatéral calculé directement (somme pondérée gaussienne sur un carré de rayon 2 * spatial_sigma autour de chaque pixel).
+ * Le coût est proportionnel à spatial_sigma² par pixel : à réserver aux petits rayons, pour valider la précision de bilateral_filter().
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param spatial_sigma Écart type spatial du flou, en pixels (par défaut 4).
+ * @param range_sigma Écart type sur la luminosité, entre 0 et 1 (par défaut 0.1).
+ */
+void bilateral_filter_reference(sil::Image& img, float spatial_sigma = 4.f, float range_sigma = 0.1f);
@@ -0,0 +1,261 @@
+#include "convolution_u8.hpp"
+#include <sil/metrics.hpp>
+#include <sil/trace.hpp>
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CONVOLUTION_USE_SSE2 1
+#else
+#define CONVOLUTION_USE_SSE2 0
+#endif
+
+namespace {
+
+constexpr int max_shift = 14;
+
+/**
+ * Poids non nul du noyau, avec le décalage (en octets) du voisin qu'il multiplie.
+ * Les lignes d'une ImageU8 sont contiguës : le voisin (dx, dy) est à (dy * width + dx) * 3 octets du canal courant.
+ */
+struct Tap
+{
+    int offset;
+    int16_t weight;
+};
+
+std::vector<Tap> nonzero_taps(const FixedPointKernel& kernel, int width)
+{
+    const int radius = kernel.size / 2;
+    std::vector<Tap> taps;
+    for (int j{0}; j < kernel.size; j++)
+    {
+        for (int i{0}; i < kernel.size; i++)
+        {
+            const int16_t weight = kernel.weights[i + static_cast<size_t>(j) * kernel.size];
+            if (weight != 0) taps.push_back({((j - radius) * width + (i - radius)) * 3, weight});
+        }
+    }
+    return taps;
+}
+
+inline uint8_t saturate(int32_t value)
+{
+    return static_cast<uint8_t>(std::clamp(value, 0, 255));
+}
+
+/**
+ * Calcule les octets [begin, end) d'une ligne (indices relatifs au début de la ligne dans `src` et `dst`).
+ * `wide` choisit l'accumulation sur 16 bits (false) ou sur 32 bits (true) pour la partie SIMD ; la fin de ligne est calculée sur 32 bits dans les deux cas.
+ */
+template<bool wide>
+void convolve_row(const uint8_t* src, uint8_t* dst, int begin, int end, const std::vector<Tap>& taps, int shift)
+{
+    const int32_t rounding = shift > 0 ? 1 << (shift - 1) : 0;
+    int i{begin};
+
+#if CONVOLUTION_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i shift_count = _mm_cvtsi32_si128(shift);
+
+    if constexpr (!wide)
+    {
+        const __m128i round16 = _mm_set1_epi16(static_cast<int16_t>(rounding));
+        for (; i + 16 <= end; i += 16)
+        {
+            __m128i low = round16;
+            __m128i high = round16;
+            for (const Tap& tap : taps)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + tap.offset));
+                const __m128i weight = _mm_set1_epi16(tap.weight);
+                low = _mm_add_epi16(low, _mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), weight));
+                high = _mm_add_epi16(high, _mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), weight));
+            }
+            low = _mm_sra_epi16(low, shift_count);
+            high = _mm_sra_epi16(high, shift_count);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(low, high));
+        }
+    }
+    else
+    {
+        // Les poids sont pris deux par deux : les valeurs des deux voisins sont entrelacées sur 16 bits et _mm_madd_epi16 calcule a * wa + b * wb sur 32 bits
+        const __m128i round32 = _mm_set1_epi32(rounding);
+        for (; i + 16 <= end; i += 16)
+        {
+            __m128i sum[4] = {round32, round32, round32, round32};
+            for (size_t t{0}; t < taps.size(); t += 2)
+            {
+                const Tap& a = taps[t];
+                const Tap& b = t + 1 < taps.size() ? taps[t + 1] : Tap{a.offset, 0};
+                const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + a.offset));
+                const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + b.offset));
+                const __m128i weights = _mm_set1_epi32(static_cast<int32_t>(static_cast<uint16_t>(a.weight) | (static_cast<uint32_t>(static_cast<uint16_t>(b.weight)) << 16)));
+
+                const __m128i a_low = _mm_unpacklo_epi8(va, zero);
+                const __m128i a_high = _mm_unpackhi_epi8(va, zero);
+                const __m128i b_low = _mm_unpacklo_epi8(vb, zero);
+                const __m128i b_high = _mm_unpackhi_epi8(vb, zero);
+                sum[0] = _mm_add_epi32(sum[0], _mm_madd_epi16(_mm_unpacklo_epi16(a_low, b_low), weights));
+                sum[1] = _mm_add_epi32(sum[1], _mm_madd_epi16(_mm_unpackhi_epi16(a_low, b_low), weights));
+                sum[2] = _mm_add_epi32(sum[2], _mm_madd_epi16(_mm_unpacklo_epi16(a_high, b_high), weights));
+                sum[3] = _mm_add_epi32(sum[3], _mm_madd_epi16(_mm_unpackhi_epi16(a_high, b_high), weights));
+            }
+            for (__m128i& s : sum) s = _mm_sra_epi32(s, shift_count);
+            // Saturation signée vers 16 bits puis non signée vers 8 bits : le résultat est bien la valeur saturée entre 0 et 255
+            const __m128i low = _mm_packs_epi32(sum[0], sum[1]);
+            const __m128i high = _mm_packs_epi32(sum[2], sum[3]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(low, high));
+        }
+    }
+#endif
+
+    for (; i < end; i++)
+    {
+        int32_t sum = rounding;
+        for (const Tap& tap : taps)
+        {
+            sum += tap.weight * static_cast<int32_t>(src[i + tap.offset]);
+        }
+        dst[i] = saturate(sum >> shift);
+    }
+}
+
+template<bool wide>
+void convolve_image(const ImageU8& src, ImageU8& dst, const FixedPointKernel& kernel)
+{
+    const int w = src.width();
+    const int h = src.height();
+    const int radius = kernel.size / 2;
+    const std::vector<Tap> taps = nonzero_taps(kernel, w);
+
+    parallel_for_bands(radius, h - radius, [&](int y_begin, int y_end) {
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            convolve_row<wide>(src.row(y), dst.row(y), 3 * radius, 3 * (w - radius), taps, kernel.shift);
+        }
+    });
+}
+
+/**
+ * Bornes de la somme pondérée (arrondi compris) sur toutes les images possibles : chaque poids positif face à 255 et chaque poids négatif face à 0 pour le maximum, et inversement.
+ */
+void sum_bounds(const std::vector<int16_t>& weights, int shift, int64_t& highest, int64_t& lowest)
+{
+    highest = shift > 0 ? int64_t{1} << (shift - 1) : 0;
+    lowest = highest;
+    for (const int16_t weight : weights)
+    {
+        (weight > 0 ? highest : lowest) += 255 * int64_t{weight};
+    }
+}
+
+bool odd_square(const std::vector<std::vector<float>>& kernel)
+{
+    if (kernel.size() % 2 == 0) return false;
+    return std::all_of(kernel.begin(), kernel.end(), [&](const std::vector<float>& row) { return row.size() == kernel.size(); });
+}
+
+} // namespace
+
+bool FixedPointKernel::fits_16bit() const
+{
+    int64_t highest, lowest;
+    sum_bounds(weights, shift, highest, lowest);
+    return highest <= INT16_MAX && lowest >= INT16_MIN;
+}
+
+bool to_fixed_point(const std::vector<std::vector<float>>& kernel, FixedPointKernel& fixed)
+{
+    if (!odd_square(kernel)) return false;
+
+    for (int shift{0}; shift <= max_shift; shift++)
+    {
+        const double scale = std::ldexp(1., shift);
+        bool exact = true;
+        std::vector<int16_t> weights;
+        weights.reserve(kernel.size() * kernel.size());
+        for (const std::vector<float>& row : kernel)
+        {
+            for (const float weight : row)
+            {
+                const double scaled = weight * scale; // Exact : multiplication par une puissance de deux
+                if (scaled != std::round(scaled) || std::abs(scaled) > INT16_MAX)
+                {
+                    exact = false;
+                    break;
+                }
+                weights.push_back(static_cast<int16_t>(scaled));
+            }
+            if (!exact) break;
+        }
+
+        if (exact)
+        {
+            // Très grands noyaux : la somme pourrait dépasser 32 bits, et un shift plus grand ne ferait que l'augmenter
+            int64_t highest, lowest;
+            sum_bounds(weights, shift, highest, lowest);
+            if (highest > INT32_MAX || lowest < INT32_MIN) return false;
+
+            fixed.size = static_cast<int>(kernel.size());
+            fixed.shift = shift;
+            fixed.weights = std::move(weights);
+            return true;
+        }
+    }
+    return false;
+}
+
+void convolution_fixed_point(ImageU8& img, const FixedPointKernel& kernel)
+{
+    SIL_TRACE_SCOPE("convolution_fixed_point");
+    SIL_EFFECT_METRICS("convolution_fixed_point", img.width() * img.height());
+    if (kernel.size / 2 * 2 >= std::min(img.width(), img.height())) return;
+
+    const ImageU8 original = img;
+    if (kernel.fits_16bit())
+        convolve_image<false>(original, img, kernel);
+    else
+        convolve_image<true>(original, img, kernel);
+}
+
+void convolution_reference(ImageU8& img, const std::vector<std::vector<float>>& kernel)
+{
+    SIL_TRACE_SCOPE("convolution_reference");
+    if (!odd_square(kernel)) return;
+    const int size = static_cast<int>(kernel.size());
+    const int radius = size / 2;
+    const ImageU8 original = img;
+
+    for (int y{radius}; y < img.height() - radius; y++)
+    {
+        for (int x{radius}; x < img.width() - radius; x++)
+        {
+            for (int c{0}; c < 3; c++)
+            {
+                double sum = 0.;
+                for (int j{0}; j < size; j++)
+                {
+                    for (int i{0}; i < size; i++)
+                    {
+                        sum += static_cast<double>(kernel[j][i]) * original.at(x + i - radius, y + j - radius, c);
+                    }
+                }
+                img.at(x, y, c) = static_cast<uint8_t>(std::clamp(std::floor(sum + 0.5), 0., 255.));
+            }
+        }
+    }
+}
+
+void convolution(ImageU8& img, const std::vector<std::vector<float>>& kernel)
+{
+    FixedPointKernel fixed;
+    if (to_fixed_point(kernel, fixed))
+        convolution_fixed_point(img, fixed);
+    else
+        convolution_reference(img, kernel);
+}
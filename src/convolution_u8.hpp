@@ -0,0 +1,54 @@
+#pragma once
+#include "image_u8.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Noyau carré de taille impaire en virgule fixe (format Q) : le poids réel (i, j) vaut weights[i + j * size] / 2^shift.
+ */
+struct FixedPointKernel
+{
+    int size{0};
+    int shift{0};
+    std::vector<int16_t> weights;
+
+    /// Indique si toutes les sommes partielles (arrondi compris) tiennent sur 16 bits signés, quels que soient les octets de l'image.
+    /// Le calcul se fait alors sur 16 bits (8 valeurs par registre SIMD), sinon sur 32 bits.
+    bool fits_16bit() const;
+};
+
+/**
+ * Convertit un noyau flottant (comme ceux de getKernel()) en virgule fixe, si chaque poids s'écrit exactement n / 2^shift avec n sur 16 bits signés et shift <= 14.
+ * C'est le cas des noyaux entiers (Sharpen, EdgeDetection) et de ceux dont les poids sont des fractions dyadiques (Blur), mais pas d'une moyenne 3x3 (poids 1/9).
+ * Le plus petit shift possible est choisi.
+ *
+ * @return false si le noyau n'est pas carré de taille impaire ou si un poids n'est pas représentable exactement.
+ */
+bool to_fixed_point(const std::vector<std::vector<float>>& kernel, FixedPointKernel& fixed);
+
+/**
+ * Applique un noyau en virgule fixe à une image 8 bits. Les poids nuls sont ignorés.
+ * Chaque valeur est arrondie au plus proche (les demis vers le haut) puis saturée entre 0 et 255.
+ * Comme dans convolution(), les pixels à moins de size / 2 du bord ne sont pas modifiés.
+ *
+ * @param img Image à modifier (type ImageU8), modifiée en place.
+ * @param kernel Noyau en virgule fixe.
+ */
+void convolution_fixed_point(ImageU8& img, const FixedPointKernel& kernel);
+
+/**
+ * Convolution d'une image 8 bits calculée en double précision, avec le même arrondi et la même saturation que convolution_fixed_point().
+ * Pour un noyau représentable en virgule fixe, le calcul en double est exact : les deux fonctions donnent exactement les mêmes octets.
+ *
+ * @param img Image à modifier (type ImageU8), modifiée en place.
+ * @param kernel Noyau carré de taille impaire (un noyau d'une autre forme laisse l'image inchangée).
+ */
+void convolution_reference(ImageU8& img, const std::vector<std::vector<float>>& kernel);
+
+/**
+ * Applique un noyau flottant à une image 8 bits : en virgule fixe si to_fixed_point() accepte le noyau, sinon avec convolution_reference().
+ *
+ * @param img Image à modifier (type ImageU8), modifiée en place.
+ * @param kernel Noyau carré de taille impaire.
+ */
+void convolution(ImageU8& img, const std::vector<std::vector<float>>& kernel);
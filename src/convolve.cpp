@@ -0,0 +1,412 @@
+#include "convolve.hpp"
+#include <sil/metrics.hpp>
+#include <sil/trace.hpp>
+#include "fft.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+namespace {
+
+/**
+ * Image prolongée de `kernel.width() - 1` colonnes et `kernel.height() - 1` lignes (bords répétés) :
+ * le pixel (x, y) du résultat est alors la somme des poids (i, j) multipliés par padded(x + i, y + j), sans aucun test de bord.
+ */
+struct Padded
+{
+    int width;
+    int height;
+    std::vector<glm::vec3> pixels;
+
+    Padded(const sil::Image& img, const ConvolutionKernel& kernel)
+        : width{img.width() + kernel.width() - 1}, height{img.height() + kernel.height() - 1}, pixels(static_cast<size_t>(width) * height)
+    {
+        const int anchor_x = kernel.width() / 2;
+        const int anchor_y = kernel.height() / 2;
+        parallel_for_bands(0, height, [&](int y_begin, int y_end) {
+            for (int y{y_begin}; y < y_end; y++)
+            {
+                const int sy = std::clamp(y - anchor_y, 0, img.height() - 1);
+                for (int x{0}; x < width; x++)
+                {
+                    pixels[x + static_cast<size_t>(y) * width] = img.pixel(std::clamp(x - anchor_x, 0, img.width() - 1), sy);
+                }
+            }
+        });
+    }
+
+    const glm::vec3* row(int y) const { return pixels.data() + static_cast<size_t>(y) * width; }
+};
+
+void convolve_direct(sil::Image& img, const ConvolutionKernel& kernel)
+{
+    SIL_TRACE_SCOPE("convolve_direct");
+    struct Tap
+    {
+        int i;
+        int j;
+        float weight;
+    };
+    std::vector<Tap> taps;
+    for (int j{0}; j < kernel.height(); j++)
+    {
+        for (int i{0}; i < kernel.width(); i++)
+        {
+            if (kernel.at(i, j) != 0.f) taps.push_back({i, j, kernel.at(i, j)});
+        }
+    }
+
+    const Padded padded{img, kernel};
+    const int w = img.width();
+    parallel_for_bands(0, img.height(), [&](int y_begin, int y_end) {
+        std::vector<glm::vec3> sum(w);
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            // Un poids à la fois sur toute la ligne : la boucle intérieure lit des pixels consécutifs
+            std::fill(sum.begin(), sum.end(), glm::vec3{0.f});
+            for (const Tap& tap : taps)
+            {
+                const glm::vec3* in = padded.row(y + tap.j) + tap.i;
+                for (int x{0}; x < w; x++) sum[x] += tap.weight * in[x];
+            }
+            for (int x{0}; x < w; x++) img.pixel(x, y) = sum[x];
+        }
+    });
+}
+
+void convolve_separable(sil::Image& img, const ConvolutionKernel& kernel, const std::vector<float>& row, const std::vector<float>& column)
+{
+    SIL_TRACE_SCOPE("convolve_separable");
+    const Padded padded{img, kernel};
+    const int w = img.width();
+
+    // Passe horizontale sur toutes les lignes prolongées, puis passe verticale ligne par ligne
+    std::vector<glm::vec3> horizontal(static_cast<size_t>(w) * padded.height, glm::vec3{0.f});
+    parallel_for_bands(0, padded.height, [&](int y_begin, int y_end) {
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            glm::vec3* out = horizontal.data() + static_cast<size_t>(y) * w;
+            for (int i{0}; i < kernel.width(); i++)
+            {
+                if (row[i] == 0.f) continue;
+                const glm::vec3* in = padded.row(y) + i;
+                for (int x{0}; x < w; x++) out[x] += row[i] * in[x];
+            }
+        }
+    });
+
+    parallel_for_bands(0, img.height(), [&](int y_begin, int y_end) {
+        std::vector<glm::vec3> sum(w);
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            std::fill(sum.begin(), sum.end(), glm::vec3{0.f});
+            for (int j{0}; j < kernel.height(); j++)
+            {
+                if (column[j] == 0.f) continue;
+                const glm::vec3* in = horizontal.data() + static_cast<size_t>(y + j) * w;
+                for (int x{0}; x < w; x++) sum[x] += column[j] * in[x];
+            }
+            for (int x{0}; x < w; x++) img.pixel(x, y) = sum[x];
+        }
+    });
+}
+
+/// Taille des FFT et des tuiles de la convolution par FFT.
+struct FftTiling
+{
+    int fft_width;
+    int fft_height;
+    int tile_width;  // fft_width - kernel.width() + 1 : le résultat d'une tuile tient dans la FFT sans se replier
+    int tile_height;
+    double cost_per_pixel; // Estimation du nombre d'opérations par pixel de l'image
+};
+
+/**
+ * Choisit les tailles de FFT (puissances de 2) qui minimisent le coût par pixel : de grandes tuiles amortissent mieux le débordement du noyau,
+ * mais les FFT coûtent un peu plus par point. Les tuiles font au moins la taille du noyau, si bien que le résultat d'une tuile
+ * ne déborde que sur les tuiles voisines.
+ */
+FftTiling fft_tiling(int padded_width, int padded_height, const ConvolutionKernel& kernel)
+{
+    auto candidates = [](int kernel_size, int padded_size) {
+        std::vector<int> sizes;
+        const int largest = next_power_of_two(padded_size + kernel_size - 1);
+        for (int n{next_power_of_two(2 * kernel_size)}; ; n *= 2)
+        {
+            sizes.push_back(n);
+            if (n >= largest) break;
+        }
+        return sizes;
+    };
+
+    FftTiling best{0, 0, 0, 0, std::numeric_limits<double>::infinity()};
+    for (int nx : candidates(kernel.width(), padded_width))
+    {
+        for (int ny : candidates(kernel.height(), padded_height))
+        {
+            const int tx = nx - kernel.width() + 1;
+            const int ty = ny - kernel.height() + 1;
+            const double tiles = std::ceil(static_cast<double>(padded_width) / tx) * std::ceil(static_cast<double>(padded_height) / ty);
+            // Par tuile et par canal : FFT directe et inverse (réelles, donc ~ n log2 n / 2 chacune) et produit des spectres
+            const double points = static_cast<double>(nx) * ny;
+            const double per_tile = 3.0 * (points * std::log2(points) + points / 2.0);
+            const double cost = per_tile * tiles / (static_cast<double>(padded_width - kernel.width() + 1) * (padded_height - kernel.height() + 1));
+            if (cost < best.cost_per_pixel) best = {nx, ny, tx, ty, cost};
+        }
+    }
+    return best;
+}
+
+void convolve_fft(sil::Image& img, const ConvolutionKernel& kernel)
+{
+    SIL_TRACE_SCOPE("convolve_fft");
+    const int w = img.width();
+    const int h = img.height();
+    const int kw = kernel.width();
+    const int kh = kernel.height();
+    const Padded padded{img, kernel};
+    const FftTiling tiling = fft_tiling(padded.width, padded.height, kernel);
+    const Fft2d fft{tiling.fft_width, tiling.fft_height};
+    const int sw = fft.spectrum_width();
+    const size_t points = static_cast<size_t>(tiling.fft_width) * tiling.fft_height;
+
+    // Spectre du noyau retourné (la FFT calcule une convolution, le noyau s'applique sans être retourné)
+    std::vector<std::complex<float>> kernel_spectrum(static_cast<size_t>(sw) * tiling.fft_height);
+    {
+        std::vector<float> flipped(points, 0.f);
+        for (int j{0}; j < kh; j++)
+        {
+            for (int i{0}; i < kw; i++) flipped[i + static_cast<size_t>(j) * tiling.fft_width] = kernel.at(kw - 1 - i, kh - 1 - j);
+        }
+        fft.forward(flipped.data(), kernel_spectrum.data());
+    }
+
+    // Overlap-add : la convolution complète de chaque tuile est ajoutée au résultat, décalée de (kw - 1, kh - 1) pour ne garder que la partie utile
+    std::vector<float> result(static_cast<size_t>(w) * h * 3, 0.f);
+    const int tiles_x = (padded.width + tiling.tile_width - 1) / tiling.tile_width;
+    const int tiles_y = (padded.height + tiling.tile_height - 1) / tiling.tile_height;
+
+    auto process_tile = [&](int tx, int ty, std::vector<float>& block, std::vector<std::complex<float>>& spectrum) {
+        const int x0 = tx * tiling.tile_width;
+        const int y0 = ty * tiling.tile_height;
+        const int tile_w = std::min(tiling.tile_width, padded.width - x0);
+        const int tile_h = std::min(tiling.tile_height, padded.height - y0);
+
+        for (int c{0}; c < 3; c++)
+        {
+            std::fill(block.begin(), block.end(), 0.f);
+            for (int y{0}; y < tile_h; y++)
+            {
+                const glm::vec3* in = padded.row(y0 + y) + x0;
+                float* out = block.data() + static_cast<size_t>(y) * tiling.fft_width;
+                for (int x{0}; x < tile_w; x++) out[x] = in[x][c];
+            }
+
+            fft.forward(block.data(), spectrum.data(), false);
+            for (size_t i{0}; i < spectrum.size(); i++) spectrum[i] *= kernel_spectrum[i];
+            fft.inverse(spectrum.data(), block.data(), false);
+
+            // Le point (u, v) de la tuile est le pixel (x0 + u - kw + 1, y0 + v - kh + 1) du résultat
+            const int v_begin = std::max(0, kh - 1 - y0);
+            const int v_end = std::min(tile_h + kh - 1, h + kh - 1 - y0);
+            const int u_begin = std::max(0, kw - 1 - x0);
+            const int u_end = std::min(tile_w + kw - 1, w + kw - 1 - x0);
+            for (int v{v_begin}; v < v_end; v++)
+            {
+                const float* in = block.data() + static_cast<size_t>(v) * tiling.fft_width;
+                float* out = result.data() + static_cast<size_t>(y0 + v - kh + 1) * w * 3 + c;
+                for (int u{u_begin}; u < u_end; u++) out[(x0 + u - kw + 1) * 3] += in[u];
+            }
+        }
+    };
+
+    // Le résultat d'une tuile déborde sur ses voisines : les tuiles sont traitées en 4 vagues (colonne paire ou impaire, ligne paire ou impaire),
+    // et deux tuiles d'une même vague ne touchent jamais les mêmes pixels.
+    for (int parity_y{0}; parity_y < 2; parity_y++)
+    {
+        for (int parity_x{0}; parity_x < 2; parity_x++)
+        {
+            const int count_x = (tiles_x - parity_x + 1) / 2;
+            const int count_y = (tiles_y - parity_y + 1) / 2;
+            parallel_for_bands(0, count_x * count_y, [&](int begin, int end) {
+                std::vector<float> block(points);
+                std::vector<std::complex<float>> spectrum(kernel_spectrum.size());
+                for (int t{begin}; t < end; t++)
+                {
+                    process_tile(2 * (t % count_x) + parity_x, 2 * (t / count_x) + parity_y, block, spectrum);
+                }
+            }, 1);
+        }
+    }
+
+    for (int y{0}; y < h; y++)
+    {
+        for (int x{0}; x < w; x++)
+        {
+            const float* v = result.data() + (static_cast<size_t>(y) * w + x) * 3;
+            img.pixel(x, y) = glm::vec3{v[0], v[1], v[2]};
+        }
+    }
+}
+
+} // namespace
+
+ConvolutionKernel::ConvolutionKernel(int width, int height, std::vector<float> weights)
+    : _width{width}, _height{height}, _weights{std::move(weights)}
+{
+    _weights.resize(static_cast<size_t>(width) * height, 0.f);
+}
+
+int ConvolutionKernel::nonzero_count() const
+{
+    return static_cast<int>(std::count_if(_weights.begin(), _weights.end(), [](float weight) { return weight != 0.f; }));
+}
+
+ConvolutionKernel& ConvolutionKernel::normalize()
+{
+    float sum = 0.f;
+    for (float weight : _weights) sum += weight;
+    if (sum != 0.f)
+    {
+        for (float& weight : _weights) weight /= sum;
+    }
+    return *this;
+}
+
+bool ConvolutionKernel::separable(std::vector<float>& row, std::vector<float>& column) const
+{
+    // Un noyau de rang 1 est égal à (sa colonne passant par le plus grand poids) x (sa ligne passant par ce poids) / ce poids
+    const auto largest = std::max_element(_weights.begin(), _weights.end(), [](float a, float b) { return std::abs(a) < std::abs(b); });
+    if (largest == _weights.end() || *largest == 0.f) return false;
+    const int pivot = static_cast<int>(largest - _weights.begin());
+    const int pi = pivot % _width;
+    const int pj = pivot / _width;
+
+    row.resize(_width);
+    column.resize(_height);
+    for (int i{0}; i < _width; i++) row[i] = at(i, pj);
+    for (int j{0}; j < _height; j++) column[j] = at(pi, j) / *largest;
+
+    const float tolerance = 1e-5f * std::abs(*largest);
+    for (int j{0}; j < _height; j++)
+    {
+        for (int i{0}; i < _width; i++)
+        {
+            if (std::abs(at(i, j) - row[i] * column[j]) > tolerance) return false;
+        }
+    }
+    return true;
+}
+
+ConvolutionKernel disk_kernel(float radius)
+{
+    const int r = static_cast<int>(std::ceil(radius));
+    const int size = 2 * r + 1;
+    std::vector<float> weights(static_cast<size_t>(size) * size);
+    constexpr int samples = 4; // Sous-échantillons par axe pour les pixels traversés par le bord
+    for (int j{0}; j < size; j++)
+    {
+        for (int i{0}; i < size; i++)
+        {
+            int inside = 0;
+            for (int sj{0}; sj < samples; sj++)
+            {
+                for (int si{0}; si < samples; si++)
+                {
+                    const float dx = i - r + (si + 0.5f) / samples - 0.5f;
+                    const float dy = j - r + (sj + 0.5f) / samples - 0.5f;
+                    if (dx * dx + dy * dy <= radius * radius) inside++;
+                }
+            }
+            weights[i + static_cast<size_t>(j) * size] = static_cast<float>(inside) / (samples * samples);
+        }
+    }
+    return ConvolutionKernel{size, size, std::move(weights)}.normalize();
+}
+
+ConvolutionKernel motion_blur_kernel(float length, float angle_degrees)
+{
+    const float angle = angle_degrees * std::numbers::pi_v<float> / 180.f;
+    const glm::vec2 direction{std::cos(angle), std::sin(angle)};
+    const int r = static_cast<int>(std::ceil(length / 2.f));
+    const int size = 2 * r + 1;
+    std::vector<float> weights(static_cast<size_t>(size) * size);
+
+    // Le segment est échantillonné finement et chaque échantillon répartit son poids sur les 4 pixels voisins
+    const int samples = std::max(2, static_cast<int>(length * 4.f));
+    for (int s{0}; s < samples; s++)
+    {
+        const glm::vec2 p = glm::vec2{static_cast<float>(r)} + direction * (length * ((s + 0.5f) / samples - 0.5f));
+        const int x0 = static_cast<int>(std::floor(p.x));
+        const int y0 = static_cast<int>(std::floor(p.y));
+        const float fx = p.x - x0;
+        const float fy = p.y - y0;
+        auto add = [&](int x, int y, float weight) {
+            if (x >= 0 && x < size && y >= 0 && y < size) weights[x + static_cast<size_t>(y) * size] += weight;
+        };
+        add(x0, y0, (1.f - fx) * (1.f - fy));
+        add(x0 + 1, y0, fx * (1.f - fy));
+        add(x0, y0 + 1, (1.f - fx) * fy);
+        add(x0 + 1, y0 + 1, fx * fy);
+    }
+    return ConvolutionKernel{size, size, std::move(weights)}.normalize();
+}
+
+ConvolutionKernel gaussian_kernel(float sigma)
+{
+    const int r = std::max(1, static_cast<int>(std::ceil(3.f * sigma)));
+    const int size = 2 * r + 1;
+    std::vector<float> weights(static_cast<size_t>(size) * size);
+    for (int j{0}; j < size; j++)
+    {
+        for (int i{0}; i < size; i++)
+        {
+            const float d2 = static_cast<float>((i - r) * (i - r) + (j - r) * (j - r));
+            weights[i + static_cast<size_t>(j) * size] = std::exp(-d2 / (2.f * sigma * sigma));
+        }
+    }
+    return ConvolutionKernel{size, size, std::move(weights)}.normalize();
+}
+
+ConvolutionMethod choose_convolution_method(int image_width, int image_height, const ConvolutionKernel& kernel)
+{
+    std::vector<float> row;
+    std::vector<float> column;
+    if (kernel.separable(row, column) && kernel.width() + kernel.height() < kernel.nonzero_count()) return ConvolutionMethod::Separable;
+
+    // Mesuré : une opération de la FFT (nombres complexes, accès dispersés) coûte environ deux fois un poids de la méthode directe sur un pixel RGB,
+    // ce qui place l'équilibre vers un disque de rayon 6 (~130 poids non nuls)
+    const double direct = kernel.nonzero_count();
+    const FftTiling tiling = fft_tiling(image_width + kernel.width() - 1, image_height + kernel.height() - 1, kernel);
+    return direct <= 2.0 * tiling.cost_per_pixel ? ConvolutionMethod::Direct : ConvolutionMethod::Fft;
+}
+
+void convolve(sil::Image& img, const ConvolutionKernel& kernel, ConvolutionMethod method)
+{
+    SIL_TRACE_SCOPE("convolve");
+    SIL_EFFECT_METRICS("convolve", img.width() * img.height());
+    if (kernel.width() <= 0 || kernel.height() <= 0) return;
+
+    std::vector<float> row;
+    std::vector<float> column;
+    if (method == ConvolutionMethod::Auto || (method == ConvolutionMethod::Separable && !kernel.separable(row, column)))
+    {
+        method = choose_convolution_method(img.width(), img.height(), kernel);
+    }
+
+    switch (method)
+    {
+    case ConvolutionMethod::Separable:
+        kernel.separable(row, column);
+        convolve_separable(img, kernel, row, column);
+        break;
+    case ConvolutionMethod::Fft:
+        convolve_fft(img, kernel);
+        break;
+    default:
+        convolve_direct(img, kernel);
+        break;
+    }
+}
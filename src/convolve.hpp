@@ -0,0 +1,72 @@
+#pragma once
+#include <sil/sil.hpp>
+#include <vector>
+
+/**
+ * Noyau de convolution 2D de taille quelconque, centré sur la case (width / 2, height / 2).
+ * Comme dans convolution(), le poids (i, j) multiplie le pixel (x + i - width / 2, y + j - height / 2) : le noyau n'est pas retourné.
+ */
+class ConvolutionKernel
+{
+public:
+    /// `weights` contient width * height poids, ligne par ligne.
+    ConvolutionKernel(int width, int height, std::vector<float> weights);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+    float at(int i, int j) const { return _weights[i + static_cast<size_t>(j) * _width]; }
+
+    /// Nombre de poids non nuls (ceux que la convolution directe calcule vraiment).
+    int nonzero_count() const;
+
+    /// Divise les poids par leur somme (si elle n'est pas nulle), pour que le noyau conserve la luminosité moyenne.
+    ConvolutionKernel& normalize();
+
+    /**
+     * Indique si le noyau est le produit d'un noyau ligne et d'un noyau colonne (noyau de rang 1),
+     * auquel cas il s'applique en deux passes 1D. Les deux facteurs sont renvoyés dans `row` et `column`.
+     */
+    bool separable(std::vector<float>& row, std::vector<float>& column) const;
+
+private:
+    int _width;
+    int _height;
+    std::vector<float> _weights;
+};
+
+/// Disque de rayon `radius` (flou d'objectif, « bokeh »), normalisé. Les pixels du bord du disque ont un poids partiel.
+ConvolutionKernel disk_kernel(float radius);
+
+/// Segment de longueur `length` pixels et d'angle `angle_degrees` (flou de bougé), normalisé.
+ConvolutionKernel motion_blur_kernel(float length, float angle_degrees);
+
+/// Gaussienne d'écart type `sigma` sur un carré de rayon 3 * sigma, normalisée (séparable).
+ConvolutionKernel gaussian_kernel(float sigma);
+
+/**
+ * Méthode de calcul d'une convolution.
+ */
+enum class ConvolutionMethod
+{
+    Auto,      // Choisie par choose_convolution_method()
+    Direct,    // Somme pondérée des poids non nuls pour chaque pixel
+    Separable, // Deux passes 1D, seulement pour les noyaux séparables
+    Fft,       // Produit des spectres, par tuiles qui se recouvrent et s'additionnent (overlap-add)
+};
+
+/**
+ * Estime la méthode la plus rapide pour une image et un noyau donnés, à partir du nombre d'opérations par pixel :
+ * poids non nuls pour la méthode directe, largeur + hauteur pour la méthode séparable, et pour la FFT le coût des transformées d'une tuile
+ * divisé par le nombre de pixels qu'elle produit.
+ */
+ConvolutionMethod choose_convolution_method(int image_width, int image_height, const ConvolutionKernel& kernel);
+
+/**
+ * Applique une convolution de taille quelconque à l'image. Les pixels hors de l'image prennent la valeur du bord le plus proche, comme dans blur_convolution().
+ * Les trois méthodes donnent le même résultat (aux arrondis près) ; la méthode séparable demandée pour un noyau non séparable est remplacée par Auto.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param kernel Noyau de convolution.
+ * @param method Méthode de calcul (par défaut ConvolutionMethod::Auto).
+ */
+void convolve(sil::Image& img, const ConvolutionKernel& kernel, ConvolutionMethod method = ConvolutionMethod::Auto);
@@ -0,0 +1,37 @@
+#pragma once
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+/**
+ * Variante dont chaque alternative représente une des valeurs `Values` sous forme de type (std::integral_constant).
+ * Visiter une telle variante appelle une version de la fonction compilée pour chaque valeur : les `if constexpr` sur la valeur disparaissent du code généré.
+ */
+template<auto... Values>
+using ValueVariant = std::variant<std::integral_constant<decltype(Values), Values>...>;
+
+/**
+ * Convertit une valeur connue seulement à l'exécution (mode d'un effet, booléen, ...) en ValueVariant.
+ * La valeur doit faire partie de `Values` ; sinon (en Release) la première alternative est choisie.
+ */
+template<auto... Values, typename T>
+ValueVariant<Values...> as_variant(T value)
+{
+    ValueVariant<Values...> result;
+    [[maybe_unused]] const bool found = ((value == Values ? (result = std::integral_constant<decltype(Values), Values>{}, true) : false) || ...);
+    assert(found && "valeur absente de la liste de as_variant");
+    return result;
+}
+
+/**
+ * Appelle func(std::integral_constant<..., v>{}) où v est celle des valeurs `Values` égale à `value`.
+ * Le choix est fait une seule fois par appel : func peut tester la valeur avec `if constexpr`, et chaque valeur a sa propre boucle, sans test par pixel.
+ * Exemple : visit_values<Brightness::Darker, Brightness::Brighter>(mode, [&](auto mode) { if constexpr (mode == Brightness::Darker) ... });
+ * Pour choisir d'après plusieurs valeurs à la fois, std::visit(func, as_variant<...>(a), as_variant<...>(b)) génère une version par combinaison.
+ */
+template<auto... Values, typename T, typename Func>
+decltype(auto) visit_values(T value, Func&& func)
+{
+    return std::visit(std::forward<Func>(func), as_variant<Values...>(value));
+}
@@ -0,0 +1,340 @@
+#include "edges.hpp"
+#include <sil/metrics.hpp>
+#include <sil/trace.hpp>
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/// Lissage séparable [side center side] de l'opérateur, de somme 1.
+struct Smoothing
+{
+    float side;
+    float center;
+};
+
+Smoothing smoothing(GradientOperator op)
+{
+    return op == GradientOperator::Scharr ? Smoothing{3.f / 16.f, 10.f / 16.f} : Smoothing{1.f / 4.f, 2.f / 4.f};
+}
+
+/// Direction du gradient ramenée à 4 cas, qui donnent les deux voisins à comparer lors de la suppression des non-maxima.
+enum Direction : uint8_t
+{
+    Horizontal, // Gradient selon x : voisins gauche et droite
+    Vertical,   // Gradient selon y : voisins du dessous et du dessus
+    Diagonal,   // Gradient selon (1, 1)
+    AntiDiagonal, // Gradient selon (1, -1)
+};
+
+/**
+ * Calcule à la demande les lignes de norme et de direction du gradient pour une bande de lignes.
+ * Chaque étape ne garde que les 3 lignes dont la suivante a besoin, rangées dans l'emplacement (ligne % 3) :
+ * dérivée horizontale et lissage horizontal de la luminosité, puis norme et direction.
+ */
+class GradientRows
+{
+public:
+    GradientRows(const sil::Image& img, GradientOperator op)
+        : _img{img}
+        , _w{img.width()}
+        , _h{img.height()}
+        , _smoothing{smoothing(op)}
+        , _luminance(_w)
+        , _derivative(3 * static_cast<size_t>(_w))
+        , _smooth(3 * static_cast<size_t>(_w))
+        , _magnitude(3 * static_cast<size_t>(_w))
+        , _direction(3 * static_cast<size_t>(_w))
+        , _zero(_w, 0.f)
+    {
+    }
+
+    /// Norme du gradient de la ligne y (une ligne de zéros hors de l'image).
+    const float* magnitude(int y)
+    {
+        if (y < 0 || y >= _h) return _zero.data();
+        compute(y);
+        return _magnitude.data() + static_cast<size_t>(y % 3) * _w;
+    }
+
+    const uint8_t* direction(int y)
+    {
+        compute(y);
+        return _direction.data() + static_cast<size_t>(y % 3) * _w;
+    }
+
+private:
+    /// Dérivée [-1 0 1] / 2 et lissage horizontaux de la luminosité de la ligne y (bords prolongés).
+    void horizontal(int y)
+    {
+        if (_horizontal_row[y % 3] == y) return;
+        _horizontal_row[y % 3] = y;
+
+        for (int x{0}; x < _w; x++)
+        {
+            const glm::vec3& c = _img.pixel(x, y);
+            _luminance[x] = 0.299f * c.r + 0.587f * c.g + 0.114f * c.b;
+        }
+        float* derivative = _derivative.data() + static_cast<size_t>(y % 3) * _w;
+        float* smooth = _smooth.data() + static_cast<size_t>(y % 3) * _w;
+        for (int x{0}; x < _w; x++)
+        {
+            const float left = _luminance[std::max(x - 1, 0)];
+            const float right = _luminance[std::min(x + 1, _w - 1)];
+            derivative[x] = 0.5f * (right - left);
+            smooth[x] = _smoothing.side * (left + right) + _smoothing.center * _luminance[x];
+        }
+    }
+
+    void compute(int y)
+    {
+        if (_gradient_row[y % 3] == y) return;
+        _gradient_row[y % 3] = y;
+
+        const int below = std::max(y - 1, 0);
+        const int above = std::min(y + 1, _h - 1);
+        horizontal(below);
+        horizontal(y);
+        horizontal(above);
+        const float* d_below = _derivative.data() + static_cast<size_t>(below % 3) * _w;
+        const float* d_center = _derivative.data() + static_cast<size_t>(y % 3) * _w;
+        const float* d_above = _derivative.data() + static_cast<size_t>(above % 3) * _w;
+        const float* s_below = _smooth.data() + static_cast<size_t>(below % 3) * _w;
+        const float* s_above = _smooth.data() + static_cast<size_t>(above % 3) * _w;
+        float* magnitude = _magnitude.data() + static_cast<size_t>(y % 3) * _w;
+        uint8_t* direction = _direction.data() + static_cast<size_t>(y % 3) * _w;
+
+        constexpr float tan_22_5 = 0.41421356f;
+        constexpr float tan_67_5 = 2.41421356f;
+        for (int x{0}; x < _w; x++)
+        {
+            const float gx = _smoothing.side * (d_below[x] + d_above[x]) + _smoothing.center * d_center[x];
+            const float gy = 0.5f * (s_above[x] - s_below[x]);
+            magnitude[x] = std::sqrt(gx * gx + gy * gy);
+
+            const float ax = std::abs(gx);
+            const float ay = std::abs(gy);
+            if (ay <= ax * tan_22_5)
+                direction[x] = Horizontal;
+            else if (ay >= ax * tan_67_5)
+                direction[x] = Vertical;
+            else
+                direction[x] = (gx > 0.f) == (gy > 0.f) ? Diagonal : AntiDiagonal;
+        }
+    }
+
+    const sil::Image& _img;
+    int _w;
+    int _h;
+    Smoothing _smoothing;
+    std::vector<float> _luminance;
+    std::vector<float> _derivative;
+    std::vector<float> _smooth;
+    std::vector<float> _magnitude;
+    std::vector<uint8_t> _direction;
+    std::vector<float> _zero;
+    int _horizontal_row[3]{-1, -1, -1};
+    int _gradient_row[3]{-1, -1, -1};
+};
+
+int32_t find(std::vector<int32_t>& parent, int32_t i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]]; // Compression par moitié
+        i = parent[i];
+    }
+    return i;
+}
+
+/// Version sans écriture, utilisable par plusieurs threads à la fois une fois l'union-find terminé.
+int32_t find_root(const std::vector<int32_t>& parent, int32_t i)
+{
+    while (parent[i] != i) i = parent[i];
+    return i;
+}
+
+void unite(std::vector<int32_t>& parent, int32_t a, int32_t b)
+{
+    a = find(parent, a);
+    b = find(parent, b);
+    if (a == b) return;
+    // La racine est toujours le plus petit indice : les unions d'une bande ne touchent que des indices de cette bande
+    if (a < b)
+        parent[b] = a;
+    else
+        parent[a] = b;
+}
+
+} // namespace
+
+void sobel(sil::Image& img, GradientOperator op)
+{
+    SIL_TRACE_SCOPE("sobel");
+    SIL_EFFECT_METRICS("sobel", img.width() * img.height());
+    const sil::Image original = img;
+    parallel_for_bands(0, img.height(), [&](int y_begin, int y_end) {
+        GradientRows gradient{original, op};
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            const float* magnitude = gradient.magnitude(y);
+            for (int x{0}; x < img.width(); x++) img.pixel(x, y) = glm::vec3{magnitude[x]};
+        }
+    });
+}
+
+EdgeDetector::EdgeDetector(float low, float high, GradientOperator op)
+    : _low{low}, _high{high}, _op{op}
+{
+}
+
+void EdgeDetector::resize(int width, int height)
+{
+    if (width == _width && height == _height) return;
+    _width = width;
+    _height = height;
+    const size_t size = static_cast<size_t>(width) * height;
+    _classes.assign(size, 0);
+    _parent.assign(size, -1);
+    _strong = std::vector<std::atomic<uint8_t>>(size);
+    _edges = BitImage{width, height};
+}
+
+const BitImage& EdgeDetector::detect(const sil::Image& img)
+{
+    resize(img.width(), img.height());
+    gradient_and_suppression(img);
+    hysteresis();
+    return _edges;
+}
+
+void EdgeDetector::gradient_and_suppression(const sil::Image& img)
+{
+    SIL_TRACE_SCOPE("gradient_and_suppression");
+    const int w = _width;
+    const int h = _height;
+
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        GradientRows gradient{img, _op};
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            const float* below = gradient.magnitude(y - 1);
+            const float* above = gradient.magnitude(y + 1);
+            const float* center = gradient.magnitude(y);
+            const uint8_t* direction = gradient.direction(y);
+            uint8_t* classes = _classes.data() + static_cast<size_t>(y) * w;
+
+            for (int x{0}; x < w; x++)
+            {
+                const float m = center[x];
+                if (m < _low)
+                {
+                    classes[x] = 0;
+                    continue;
+                }
+
+                const int left = x - 1;
+                const int right = x + 1;
+                auto at = [&](const float* row, int xx) { return (xx < 0 || xx >= w) ? 0.f : row[xx]; };
+                float before = 0.f; // Voisin du côté où le gradient diminue
+                float after = 0.f;  // Voisin du côté où il augmente
+                switch (direction[x])
+                {
+                case Horizontal: before = at(center, left); after = at(center, right); break;
+                case Vertical: before = at(below, x); after = at(above, x); break;
+                case Diagonal: before = at(below, left); after = at(above, right); break;
+                case AntiDiagonal: before = at(above, left); after = at(below, right); break;
+                }
+
+                // Inégalité large d'un seul côté : un plateau de deux pixels égaux garde exactement un pixel
+                const bool maximum = m > before && m >= after;
+                classes[x] = !maximum ? 0 : m >= _high ? 2 : 1;
+            }
+        }
+    });
+}
+
+void EdgeDetector::hysteresis()
+{
+    SIL_TRACE_SCOPE("hysteresis");
+    const int w = _width;
+    const int h = _height;
+    std::vector<uint8_t> band_start(h, 0);
+
+    // Union-find par bande, sur les pixels faibles ou forts voisins (8-connexité)
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        band_start[y_begin] = 1;
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            for (int x{0}; x < w; x++)
+            {
+                const int32_t i = y * w + x;
+                _strong[i].store(0, std::memory_order_relaxed);
+                if (_classes[i] == 0)
+                {
+                    _parent[i] = -1;
+                    continue;
+                }
+                _parent[i] = i;
+                if (x > 0 && _classes[i - 1] != 0) unite(_parent, i, i - 1);
+                if (y == y_begin) continue;
+                for (int dx{-1}; dx <= 1; dx++)
+                {
+                    if (x + dx >= 0 && x + dx < w && _classes[i - w + dx] != 0) unite(_parent, i, i - w + dx);
+                }
+            }
+        }
+    });
+
+    // Coutures entre bandes : peu de lignes, faites par un seul thread
+    for (int y{1}; y < h; y++)
+    {
+        if (!band_start[y]) continue;
+        for (int x{0}; x < w; x++)
+        {
+            const int32_t i = y * w + x;
+            if (_classes[i] == 0) continue;
+            for (int dx{-1}; dx <= 1; dx++)
+            {
+                if (x + dx >= 0 && x + dx < w && _classes[i - w + dx] != 0) unite(_parent, i, i - w + dx);
+            }
+        }
+    }
+
+    // Une composante est gardée si elle contient un pixel fort
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        for (int32_t i{y_begin * w}; i < y_end * w; i++)
+        {
+            if (_classes[i] == 2) _strong[find_root(_parent, i)].store(1, std::memory_order_relaxed);
+        }
+    });
+
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            uint64_t* row = _edges.row(y);
+            std::fill_n(row, _edges.words_per_row(), 0);
+            for (int x{0}; x < w; x++)
+            {
+                const int32_t i = y * w + x;
+                if (_classes[i] != 0 && _strong[find_root(_parent, i)].load(std::memory_order_relaxed))
+                {
+                    row[x / 64] |= uint64_t{1} << (x % 64);
+                }
+            }
+        }
+    });
+}
+
+BitImage canny_edges(const sil::Image& img, float low, float high, GradientOperator op)
+{
+    SIL_EFFECT_METRICS("canny", img.width() * img.height()); // Compte aussi canny(), qui ne fait que convertir le résultat
+    EdgeDetector detector{low, high, op};
+    return detector.detect(img);
+}
+
+void canny(sil::Image& img, float low, float high, GradientOperator op)
+{
+    img = canny_edges(img, low, high, op).to_image();
+}
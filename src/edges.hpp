@@ -0,0 +1,82 @@
+#pragma once
+#include <sil/sil.hpp>
+#include "morphology.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Filtre dérivateur utilisé pour le gradient. Les deux sont séparables : une dérivée [-1 0 1] dans un sens, un lissage dans l'autre.
+ */
+enum class GradientOperator
+{
+    Sobel,  // Lissage [1 2 1] / 4
+    Scharr, // Lissage [3 10 3] / 16 : gradient plus isotrope, les bords obliques sont mieux orientés
+};
+
+/**
+ * Remplace l'image par la norme de son gradient de luminosité (en niveaux de gris) : les bords apparaissent en clair.
+ * Un bord franc entre le noir et le blanc donne 0.5 sur les deux pixels qui le bordent.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param op Filtre dérivateur (par défaut GradientOperator::Sobel).
+ */
+void sobel(sil::Image& img, GradientOperator op = GradientOperator::Sobel);
+
+/**
+ * Détecteur de bords de Canny : luminosité, gradient séparable, norme et direction, suppression des non-maxima, puis seuillage par hystérésis.
+ * Les premières étapes sont fusionnées en une seule passe par bandes de lignes : chaque thread garde seulement quelques lignes intermédiaires
+ * dans des tampons circulaires, qui restent en cache. L'hystérésis garde les pixels faibles reliés à un pixel fort, grâce à un union-find
+ * calculé en parallèle par bande puis recousu aux frontières entre bandes.
+ * Les tampons sont conservés d'un appel à l'autre : un même détecteur peut traiter toutes les images d'un flux sans nouvelle allocation.
+ */
+class EdgeDetector
+{
+public:
+    /**
+     * @param low Seuil bas de la norme du gradient : en dessous, un pixel n'est jamais un bord (par défaut 0.04).
+     * @param high Seuil haut : au-dessus, un pixel est un bord ; entre les deux, seulement s'il est relié à un bord (par défaut 0.1).
+     * @param op Filtre dérivateur (par défaut GradientOperator::Sobel).
+     */
+    explicit EdgeDetector(float low = 0.04f, float high = 0.1f, GradientOperator op = GradientOperator::Sobel);
+
+    /// Détecte les bords d'une image. Le résultat reste valide jusqu'au prochain appel.
+    const BitImage& detect(const sil::Image& img);
+
+private:
+    void resize(int width, int height);
+    void gradient_and_suppression(const sil::Image& img);
+    void hysteresis();
+
+    float _low;
+    float _high;
+    GradientOperator _op;
+
+    int _width{0};
+    int _height{0};
+    std::vector<uint8_t> _classes; // 0 : pas un bord, 1 : faible, 2 : fort
+    std::vector<int32_t> _parent;  // Union-find sur les pixels faibles ou forts
+    std::vector<std::atomic<uint8_t>> _strong; // Racines dont la composante contient un pixel fort
+    BitImage _edges{0, 0};
+};
+
+/**
+ * Détecte les bords avec le détecteur de Canny.
+ *
+ * @param img Image à analyser.
+ * @param low Seuil bas de la norme du gradient (par défaut 0.04).
+ * @param high Seuil haut de la norme du gradient (par défaut 0.1).
+ * @param op Filtre dérivateur (par défaut GradientOperator::Sobel).
+ * @return Image binaire des bords (1 bit par pixel).
+ */
+BitImage canny_edges(const sil::Image& img, float low = 0.04f, float high = 0.1f, GradientOperator op = GradientOperator::Sobel);
+
+/**
+ * Remplace l'image par ses bords détectés avec le détecteur de Canny : bords blancs d'un pixel d'épaisseur sur fond noir.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param low Seuil bas de la norme du gradient (par défaut 0.04).
+ * @param high Seuil haut de la norme du gradient (par défaut 0.1).
+ * @param op Filtre dérivateur (par défaut GradientOperator::Sobel).
+ */
+void canny(sil::Image& img, float low = 0.04f, float high = 0.1f, GradientOperator op = GradientOperator::Sobel);
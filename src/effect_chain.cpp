@@ -0,0 +1,164 @@
+#include "effect_chain.hpp"
+#include "effects.hpp"
+#include <map>
+#include <stdexcept>
+
+namespace {
+
+using Step = std::function<void(sil::Image&)>;
+using StepFactory = std::function<Step(const std::string& argument)>; // argument vide : valeur par défaut
+
+/// Paramètre entier strictement positif (ou `fallback` si l'argument est vide).
+int positive_argument(const std::string& effect, const std::string& argument, int fallback)
+{
+    if (argument.empty()) return fallback;
+    size_t end = 0;
+    int value = 0;
+    try
+    {
+        value = std::stoi(argument, &end);
+    }
+    catch (const std::exception&)
+    {
+        end = 0;
+    }
+    if (end != argument.size() || value <= 0)
+    {
+        throw std::invalid_argument{"Paramètre invalide pour " + effect + " : \"" + argument + "\" (entier positif attendu)"};
+    }
+    return value;
+}
+
+/// Paramètre choisi parmi une liste de mots (le premier est la valeur par défaut).
+template<typename T>
+T choice_argument(const std::string& effect, const std::string& argument, const std::vector<std::pair<std::string, T>>& choices)
+{
+    if (argument.empty()) return choices.front().second;
+    for (const auto& [name, value] : choices)
+    {
+        if (name == argument) return value;
+    }
+    std::string expected;
+    for (const auto& choice : choices)
+    {
+        expected += (expected.empty() ? "" : "|") + choice.first;
+    }
+    throw std::invalid_argument{"Paramètre invalide pour " + effect + " : \"" + argument + "\" (" + expected + " attendu)"};
+}
+
+/// Effet sans paramètre.
+StepFactory simple(const std::string& name, void (*effect)(sil::Image&))
+{
+    return [name, effect](const std::string& argument) -> Step {
+        if (!argument.empty()) throw std::invalid_argument{name + " n'a pas de paramètre"};
+        return effect;
+    };
+}
+
+/// Effet dont le seul paramètre est un entier positif.
+StepFactory with_int(const std::string& name, int fallback, std::function<void(sil::Image&, int)> effect)
+{
+    return [name, fallback, effect](const std::string& argument) -> Step {
+        const int value = positive_argument(name, argument, fallback);
+        return [effect, value](sil::Image& img) { effect(img, value); };
+    };
+}
+
+const std::map<std::string, StepFactory>& factories()
+{
+    static const std::map<std::string, StepFactory> table{
+        {"keep_green_only", simple("keep_green_only", keep_green_only)},
+        {"channels_swap", simple("channels_swap", channels_swap)},
+        {"black_and_white", simple("black_and_white", black_and_white)},
+        {"negative", simple("negative", negative)},
+        {"gradient", simple("gradient", gradient)},
+        {"noisy", simple("noisy", noisy)},
+        {"rotate90", simple("rotate90", rotate90)},
+        {"splitRGB", simple("splitRGB", splitRGB)},
+        {"glitch", simple("glitch", glitch)},
+        {"pixelSort", simple("pixelSort", pixelSort)},
+        {"gaussienne_difference", simple("gaussienne_difference", gaussienne_difference)},
+        {"differential", [](const std::string& argument) -> Step {
+             if (!argument.empty()) throw std::invalid_argument{"differential n'a pas de paramètre"};
+             return [](sil::Image& img) { differential(img, false); };
+         }},
+        {"mirror", [](const std::string& argument) -> Step {
+             const Mirror direction = choice_argument<Mirror>("mirror", argument, {{"horizontal", Mirror::Horizontal}, {"vertical", Mirror::Vertical}, {"both", Mirror::Both}});
+             return [direction](sil::Image& img) { mirror(img, direction); };
+         }},
+        {"brightness", [](const std::string& argument) -> Step {
+             const Brightness mode = choice_argument<Brightness>("brightness", argument, {{"darker", Brightness::Darker}, {"brighter", Brightness::Brighter}});
+             return [mode](sil::Image& img) { brightness(img, mode); };
+         }},
+        {"convolution", [](const std::string& argument) -> Step {
+             const Kernel kernel = choice_argument<Kernel>("convolution", argument,
+                                                           {{"blur", Kernel::Blur}, {"identity", Kernel::Identity}, {"sharpen", Kernel::Sharpen},
+                                                            {"edge_detection", Kernel::EdgeDetection}, {"box_blur", Kernel::BoxBlur}});
+             return [kernel](sil::Image& img) { convolution(img, kernel); };
+         }},
+        {"dithering", [](const std::string& argument) -> Step {
+             const bool color = choice_argument<bool>("dithering", argument, {{"color", true}, {"gray", false}});
+             return [color](sil::Image& img) { dithering(img, color); };
+         }},
+        {"blur_convolution", with_int("blur_convolution", 100, [](sil::Image& img, int size) { blur_convolution(img, size); })},
+        {"kuwahara", with_int("kuwahara", 4, [](sil::Image& img, int radius) { kuwahara(img, radius); })},
+        {"pixelated", with_int("pixelated", 8, [](sil::Image& img, int block) { pixelated(img, block); })},
+        {"mandelbrotFractal", with_int("mandelbrotFractal", 100, [](sil::Image& img, int iterations) { mandelbrotFractal(img, iterations); })},
+        {"mosaic", with_int("mosaic", 5, [](sil::Image& img, int copies) { mosaic(img, copies); })},
+        {"mosaic_mirror", with_int("mosaic_mirror", 5, [](sil::Image& img, int copies) { mosaic_mirror(img, copies); })},
+        {"disk", with_int("disk", 100, [](sil::Image& img, int radius) { disk(img, static_cast<float>(radius)); })},
+        {"circle", with_int("circle", 100, [](sil::Image& img, int radius) { circle(img, static_cast<float>(radius)); })},
+        {"rosette", with_int("rosette", 6, [](sil::Image& img, int circles) { rosette(img, circles); })},
+    };
+    return table;
+}
+
+} // namespace
+
+EffectChain EffectChain::parse(const std::string& text)
+{
+    EffectChain chain;
+    chain._text = text;
+
+    if (text.empty()) return chain;
+
+    // Chaque virgule est suivie d'une étape : une virgule finale donne une étape vide, refusée comme les autres
+    size_t begin = 0;
+    while (true)
+    {
+        const size_t end = text.find(',', begin);
+        const std::string step = text.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+        if (step.empty()) throw std::invalid_argument{"Étape vide dans la chaîne d'effets \"" + text + "\""};
+
+        const size_t colon = step.find(':');
+        const std::string name = step.substr(0, colon);
+        if (colon != std::string::npos && colon + 1 == step.size()) throw std::invalid_argument{"Paramètre vide après \"" + name + ":\""};
+        const std::string argument = colon == std::string::npos ? "" : step.substr(colon + 1);
+
+        const auto it = factories().find(name);
+        if (it == factories().end()) throw std::invalid_argument{"Effet inconnu : \"" + name + "\""};
+        chain._steps.push_back(it->second(argument));
+
+        if (end == std::string::npos) break;
+        begin = end + 1;
+    }
+    return chain;
+}
+
+void EffectChain::apply(sil::Image& img) const
+{
+    for (const Step& step : _steps)
+    {
+        step(img);
+    }
+}
+
+std::vector<std::string> effect_chain_names()
+{
+    std::vector<std::string> names;
+    for (const auto& entry : factories())
+    {
+        names.push_back(entry.first);
+    }
+    return names;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <sil/sil.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Suite d'effets de effects.hpp décrite par un texte, pour les demander sans recompiler (serveur de traitements, outils en ligne de commande).
+ * Les étapes sont séparées par des virgules, et chacune peut avoir un paramètre après deux-points :
+ * "black_and_white,blur_convolution:5,mirror:vertical".
+ * Paramètres reconnus (tous facultatifs, la valeur par défaut de effects.hpp sinon) :
+ * mirror:horizontal|vertical|both, brightness:darker|brighter, convolution:identity|blur|sharpen|edge_detection|box_blur, dithering:color|gray,
+ * et un entier pour blur_convolution (taille), kuwahara (rayon), pixelated (taille des blocs), mandelbrotFractal (itérations),
+ * mosaic et mosaic_mirror (copies), disk et circle (rayon), rosette (nombre de cercles).
+ */
+class EffectChain
+{
+public:
+    /// Chaîne vide : apply() ne change pas l'image.
+    EffectChain() = default;
+
+    /**
+     * Lit la description d'une chaîne d'effets.
+     * Lance std::invalid_argument si un effet est inconnu, si une étape est vide (virgule en trop) ou si un paramètre est vide ("blur:") ou invalide.
+     *
+     * @param text Étapes séparées par des virgules (texte vide : aucune étape).
+     */
+    static EffectChain parse(const std::string& text);
+
+    /// Applique les étapes dans l'ordre, en place.
+    void apply(sil::Image& img) const;
+
+    /// Étapes, dans l'ordre (pour les exécuter une à une, comme JobPool qui vérifie l'annulation entre deux étapes).
+    const std::vector<std::function<void(sil::Image&)>>& steps() const { return _steps; }
+
+    /// Nombre d'étapes.
+    size_t size() const { return _steps.size(); }
+    bool empty() const { return _steps.empty(); }
+
+    /// Description de la chaîne, telle que passée à parse().
+    const std::string& text() const { return _text; }
+
+private:
+    std::string _text;
+    std::vector<std::function<void(sil::Image&)>> _steps;
+};
+
+/// Noms des effets reconnus par EffectChain::parse(), par ordre alphabétique.
+std::vector<std::string> effect_chain_names();
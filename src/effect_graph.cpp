@@ -0,0 +1,216 @@
+#include "effect_graph.hpp"
+#include <sil/trace.hpp>
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+/// Copie la partie `rect` (en coordonnées de `img`) de l'image ; les pixels hors de l'image sont noirs.
+sil::Image crop(const sil::Image& img, const Rect& rect)
+{
+    sil::Image out{rect.width(), rect.height()};
+    const Rect inside = rect.intersected(Rect{0, 0, img.width(), img.height()});
+    for (int y{inside.y0}; y < inside.y1; y++)
+    {
+        std::copy_n(&img.pixel(inside.x0, y), inside.width(), &out.pixel(inside.x0 - rect.x0, y - rect.y0));
+    }
+    return out;
+}
+
+} // namespace
+
+EffectGraph::EffectGraph(int tile_size)
+    : _tile_size{std::max(tile_size, 1)}
+{
+}
+
+EffectGraph::Node EffectGraph::add(NodeData data)
+{
+    data.tiles.resize(static_cast<size_t>((data.width + _tile_size - 1) / _tile_size) * ((data.height + _tile_size - 1) / _tile_size));
+    _nodes.push_back(std::move(data));
+    return static_cast<Node>(_nodes.size()) - 1;
+}
+
+EffectGraph::Node EffectGraph::source(sil::Image image)
+{
+    NodeData data;
+    data.footprint = Footprint::Source;
+    data.width = image.width();
+    data.height = image.height();
+    data.image = std::make_unique<sil::Image>(std::move(image));
+    return add(std::move(data));
+}
+
+EffectGraph::Node EffectGraph::pointwise(Node input, std::function<void(sil::Image&)> effect)
+{
+    return neighborhood(input, 0, std::move(effect));
+}
+
+EffectGraph::Node EffectGraph::neighborhood(Node input, int radius, std::function<void(sil::Image&)> effect)
+{
+    NodeData data;
+    data.footprint = radius > 0 ? Footprint::Neighborhood : Footprint::Pointwise;
+    data.input = input;
+    data.width = width(input);
+    data.height = height(input);
+    data.radius = std::max(radius, 0);
+    data.effect = std::move(effect);
+    return add(std::move(data));
+}
+
+EffectGraph::Node EffectGraph::remap(Node input, Remap table)
+{
+    NodeData data;
+    data.footprint = Footprint::Remap;
+    data.input = input;
+    data.width = table.width();
+    data.height = table.height();
+    // Une table construite pour une autre taille d'image ne lit rien : le nœud produit une image noire
+    if (table.src_width() == width(input) && table.src_height() == height(input)) data.table = std::make_unique<Remap>(std::move(table));
+    return add(std::move(data));
+}
+
+EffectGraph::Node EffectGraph::global(Node input, std::function<void(sil::Image&)> effect, int width, int height)
+{
+    NodeData data;
+    data.footprint = Footprint::Global;
+    data.input = input;
+    data.width = width < 0 ? this->width(input) : width;
+    data.height = height < 0 ? this->height(input) : height;
+    data.effect = std::move(effect);
+    return add(std::move(data));
+}
+
+Rect EffectGraph::tile_rect(Node node, int tx, int ty) const
+{
+    return Rect{tx * _tile_size, ty * _tile_size, (tx + 1) * _tile_size, (ty + 1) * _tile_size}.intersected(bounds(node));
+}
+
+sil::Image EffectGraph::evaluate(Node node, const Rect& output)
+{
+    SIL_TRACE_SCOPE("EffectGraph::evaluate");
+    NodeData& data = _nodes[node];
+
+    switch (data.footprint)
+    {
+    case Footprint::Pointwise:
+    case Footprint::Neighborhood:
+    {
+        const Rect input_rect = output.expanded(data.radius).intersected(bounds(data.input));
+        sil::Image region = compute(data.input, input_rect);
+        data.effect(region);
+        data.computed_pixels += static_cast<int64_t>(region.width()) * region.height();
+        return crop(region, Rect{output.x0 - input_rect.x0, output.y0 - input_rect.y0, output.x1 - input_rect.x0, output.y1 - input_rect.y0});
+    }
+
+    case Footprint::Remap:
+    {
+        data.computed_pixels += static_cast<int64_t>(output.width()) * output.height();
+        const Rect input_rect = data.table ? data.table->source_bounds(output) : Rect{};
+        if (input_rect.empty()) return sil::Image{output.width(), output.height()};
+        return data.table->apply_region(compute(data.input, input_rect), input_rect, output);
+    }
+
+    case Footprint::Global:
+    {
+        sil::Image img = compute(data.input);
+        data.effect(img);
+        data.computed_pixels += static_cast<int64_t>(img.width()) * img.height();
+        return crop(img, output);
+    }
+
+    case Footprint::Source:
+        break;
+    }
+
+    return crop(*data.image, output);
+}
+
+void EffectGraph::ensure(Node node, Rect region)
+{
+    NodeData& data = _nodes[node];
+    if (data.footprint == Footprint::Source || region.empty()) return;
+
+    // L'image entière est nécessaire de toute façon : toutes les tuiles sont calculées d'un coup
+    if (data.footprint == Footprint::Global)
+    {
+        if (std::none_of(data.tiles.begin(), data.tiles.end(), [](const std::vector<glm::vec3>& tile) { return tile.empty(); })) return;
+        region = bounds(node);
+    }
+
+    const int tx_begin = region.x0 / _tile_size;
+    const int tx_end = (region.x1 + _tile_size - 1) / _tile_size;
+    const int ty_begin = region.y0 / _tile_size;
+    const int ty_end = (region.y1 + _tile_size - 1) / _tile_size;
+    auto tile = [&](int tx, int ty) -> std::vector<glm::vec3>& { return _nodes[node].tiles[tx + static_cast<size_t>(ty) * tiles_x(node)]; };
+
+    for (int ty{ty_begin}; ty < ty_end; ty++)
+    {
+        int tx{tx_begin};
+        while (tx < tx_end)
+        {
+            if (!tile(tx, ty).empty())
+            {
+                tx++;
+                continue;
+            }
+
+            // Regroupe les tuiles manquantes consécutives en une seule région, pour ne calculer la marge qu'une fois
+            const int first_tile = tx;
+            while (tx < tx_end && tile(tx, ty).empty()) tx++;
+
+            const Rect run = Rect{tile_rect(node, first_tile, ty).x0, tile_rect(node, first_tile, ty).y0, tile_rect(node, tx - 1, ty).x1, tile_rect(node, tx - 1, ty).y1};
+            const sil::Image result = evaluate(node, run);
+
+            for (int t{first_tile}; t < tx; t++)
+            {
+                const Rect r = tile_rect(node, t, ty);
+                std::vector<glm::vec3>& pixels = tile(t, ty);
+                pixels.resize(static_cast<size_t>(r.width()) * r.height());
+                for (int y{r.y0}; y < r.y1; y++)
+                {
+                    std::copy_n(&result.pixel(r.x0 - run.x0, y - run.y0), r.width(), pixels.begin() + static_cast<size_t>(y - r.y0) * r.width());
+                }
+            }
+        }
+    }
+}
+
+sil::Image EffectGraph::compute(Node node, Rect region)
+{
+    region = region.intersected(bounds(node));
+    if (region.empty()) return sil::Image{0, 0};
+    if (_nodes[node].footprint == Footprint::Source) return crop(*_nodes[node].image, region);
+
+    ensure(node, region);
+
+    sil::Image out{region.width(), region.height()};
+    for (int ty{region.y0 / _tile_size}; ty < (region.y1 + _tile_size - 1) / _tile_size; ty++)
+    {
+        for (int tx{region.x0 / _tile_size}; tx < (region.x1 + _tile_size - 1) / _tile_size; tx++)
+        {
+            const Rect r = tile_rect(node, tx, ty);
+            const Rect part = r.intersected(region);
+            const std::vector<glm::vec3>& pixels = _nodes[node].tiles[tx + static_cast<size_t>(ty) * tiles_x(node)];
+            for (int y{part.y0}; y < part.y1; y++)
+            {
+                std::copy_n(pixels.begin() + (part.x0 - r.x0) + static_cast<size_t>(y - r.y0) * r.width(), part.width(), &out.pixel(part.x0 - region.x0, y - region.y0));
+            }
+        }
+    }
+    return out;
+}
+
+sil::Image EffectGraph::compute(Node node)
+{
+    return compute(node, bounds(node));
+}
+
+void EffectGraph::clear_cache()
+{
+    for (NodeData& data : _nodes)
+    {
+        for (std::vector<glm::vec3>& tile : data.tiles) tile = {};
+        data.computed_pixels = 0;
+    }
+}
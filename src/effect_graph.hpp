@@ -0,0 +1,101 @@
+#pragma once
+#include <sil/sil.hpp>
+#include "rect.hpp"
+#include "remap.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * Graphe d'effets paresseux : chaque nœud est un effet (ceux de effects.hpp, passés sous forme de lambdas) appliqué à l'image produite par un autre nœud.
+ * Rien n'est calculé à la construction. Quand on demande une région d'un nœud (par exemple un recadrage), la région nécessaire en entrée
+ * est déduite de l'empreinte de l'effet (pixel par pixel, voisinage de rayon r, table de remappage ou image entière), et ainsi de suite jusqu'à l'image source :
+ * seules les tuiles utiles de chaque image intermédiaire sont calculées.
+ * Chaque nœud garde ses tuiles déjà calculées : deux nœuds qui lisent la même entrée, ou deux demandes successives, ne refont pas le calcul.
+ */
+class EffectGraph
+{
+public:
+    /// Identifiant d'un nœud du graphe.
+    using Node = int;
+
+    /// @param tile_size Côté des tuiles mises en cache, en pixels (par défaut 64).
+    explicit EffectGraph(int tile_size = 64);
+
+    /// Image d'entrée du graphe (copiée).
+    Node source(sil::Image image);
+
+    /**
+     * Effet pixel par pixel (noir et blanc, luminosité, ...) : chaque pixel de sortie ne dépend que du pixel d'entrée à la même position.
+     * L'effet est appliqué à des régions alignées sur les tuiles : un motif qui dépend de la position (comme le tramage de Bayer 4x4) reste correct si sa période divise la taille des tuiles.
+     */
+    Node pointwise(Node input, std::function<void(sil::Image&)> effect);
+
+    /**
+     * Effet de voisinage : chaque pixel de sortie ne dépend que des pixels d'entrée à moins de `radius` pixels (1 pour une convolution 3x3).
+     * L'effet est appliqué à des régions agrandies de `radius` pixels, comme dans apply_masked() : il ne doit pas changer la taille de l'image ni dépendre de la position absolue des pixels.
+     */
+    Node neighborhood(Node input, int radius, std::function<void(sil::Image&)> effect);
+
+    /// Table de remappage (rotation, distorsion d'objectif, ...) : la région d'entrée est celle que lisent les pixels demandés.
+    Node remap(Node input, Remap table);
+
+    /**
+     * Effet qui a besoin de toute l'image d'entrée (tri de pixels, miniature, ...) : la première demande calcule toute l'image de sortie.
+     * @param width Largeur de l'image produite (par défaut -1 : même taille que l'entrée).
+     * @param height Hauteur de l'image produite (par défaut -1 : même taille que l'entrée).
+     */
+    Node global(Node input, std::function<void(sil::Image&)> effect, int width = -1, int height = -1);
+
+    int width(Node node) const { return _nodes[node].width; }
+    int height(Node node) const { return _nodes[node].height; }
+
+    /// Calcule (si besoin) et renvoie la région `region` de l'image produite par le nœud, limitée à l'image.
+    sil::Image compute(Node node, Rect region);
+    /// Calcule (si besoin) et renvoie toute l'image produite par le nœud.
+    sil::Image compute(Node node);
+
+    /// Nombre de pixels calculés par le nœud depuis sa création (ou le dernier clear_cache()), marges comprises.
+    int64_t computed_pixels(Node node) const { return _nodes[node].computed_pixels; }
+
+    /// Oublie toutes les tuiles calculées.
+    void clear_cache();
+
+private:
+    enum class Footprint
+    {
+        Source,
+        Pointwise,
+        Neighborhood,
+        Remap,
+        Global
+    };
+
+    struct NodeData
+    {
+        Footprint footprint{Footprint::Source};
+        Node input{-1};
+        int width{0};
+        int height{0};
+        int radius{0};
+        std::function<void(sil::Image&)> effect;
+        std::unique_ptr<Remap> table;
+        std::unique_ptr<sil::Image> image;       // Image du nœud source
+        std::vector<std::vector<glm::vec3>> tiles; // Tuiles calculées, ligne par ligne (vide = pas encore calculée)
+        int64_t computed_pixels{0};
+    };
+
+    Node add(NodeData data);
+    Rect bounds(Node node) const { return Rect{0, 0, _nodes[node].width, _nodes[node].height}; }
+    Rect tile_rect(Node node, int tx, int ty) const;
+    int tiles_x(Node node) const { return (_nodes[node].width + _tile_size - 1) / _tile_size; }
+
+    /// Calcule les tuiles manquantes qui recouvrent `region` (déjà limitée à l'image du nœud).
+    void ensure(Node node, Rect region);
+    /// Calcule la région `output` d'un nœud qui n'est pas une source, à partir de son entrée.
+    sil::Image evaluate(Node node, const Rect& output);
+
+    int _tile_size;
+    std::vector<NodeData> _nodes;
+};
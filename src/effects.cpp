@@ -0,0 +1,769 @@
+#include "effects.hpp"
+#include <sil/metrics.hpp>
+#include <sil/trace.hpp>
+#include <random.hpp>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <complex>
+#include "tiled_view.hpp"
+#include "rle_image.hpp"
+#include "convolution_u8.hpp"
+#include "dispatch.hpp"
+#include "parallel.hpp"
+
+void keep_green_only(sil::Image& img)
+{
+    SIL_TRACE_SCOPE("keep_green_only");
+    SIL_EFFECT_METRICS("keep_green_only", img.width() * img.height());
+    for (glm::vec3& colors : img.pixels())
+    {
+        // On garde uniquement la composante verte
+        colors = glm::vec3{0.f, colors.g, 0.f};
+    }
+}
+
+void channels_swap(sil::Image& img)
+{
+    SIL_TRACE_SCOPE("channels_swap");
+    SIL_EFFECT_METRICS("channels_swap", img.width() * img.height());
+    for (glm::vec3& colors : img.pixels())
+    {
+        // On échange la composante rouge et la composante bleue
+        std::swap(colors.r, colors.b);
+    }
+}
+
+void black_and_white(sil::Image& img)
+{
+    SIL_TRACE_SCOPE("black_and_white");
+    SIL_EFFECT_METRICS("black_and_white", img.width() * img.height());
+    for (glm::vec3& colors : img.pixels())
+    {
+        float gray = 0.299f * colors.r + 0.587f * colors.g + 0.114f * colors.b; // Formule de luminance relative au système sRGB (y = 0.299 * R + 0.587 * G + 0.114 * B)
+        colors = glm::vec3{gray, gray, gray};
+    }
+}
+
+void negative(sil::Image& img)
+{
+    SIL_TRACE_SCOPE("negative");
+    SIL_EFFECT_METRICS("negative", img.width() * img.height());
+    for (glm::vec3& colors : img.pixels())
+    {
+        colors = glm::vec3{1.f, 1.f, 1.f} - colors;
+    }
+}
+
+void gradient(sil::Image& img)
+{
+    SIL_TRACE_SCOPE("gradient");
+    SIL_EFFECT_METRICS("gradient", img.width() * img.height());
+    for (int x{0}; x < img.width(); x++)
+    {
+        float t = static_cast<float>(x) / img.width();
+        glm::vec3 color{t, t, t};
+        
+        for (int y{0}; y < img.height(); y++)
+        {
+            img.pixel(x, y) = color;
+        }
+    }
+}
+
+void mirror(sil::Image& img, Mirror direction)
+{
+    SIL_TRACE_SCOPE("mirror");
+    SIL_EFFECT_METRICS("mirror", img.width() * img.height());
+    const int width = img.width();
+    const int height = img.height();
+    glm::vec3* pixels = img.pixels().data();
+    auto row = [&](int y) { return pixels + static_cast<size_t>(y) * width; };
+
+    visit_values<Mirror::Horizontal, Mirror::Vertical, Mirror::Both>(direction, [&](auto direction) {
+        if constexpr (direction == Mirror::Horizontal)
+        {
+            for (int y{0}; y < height; y++)
+            {
+                std::reverse(row(y), row(y + 1));
+            }
+        }
+        else if constexpr (direction == Mirror::Vertical)
+        {
+            for (int y{0}; y < height / 2; y++) // On ne fait que la moitié des lignes (puisqu'on échange deux lignes à chaque fois)
+            {
+                std::swap_ranges(row(y), row(y + 1), row(height - 1 - y));
+            }
+        }
+        else
+        {
+            // Les deux symétries à la fois : le pixel d'indice i est échangé avec celui d'indice (width * height - 1 - i)
+            std::reverse(row(0), row(height));
+        }
+    });
+}
+
+void noisy(sil::Image& img)
+{
+    SIL_TRACE_SCOPE("noisy");
+    SIL_EFFECT_METRICS("noisy", img.width() * img.height());
+    for (glm::vec3& colors : img.pixels())
+    {
+        const int random = random_int(0, 5);
+        if(random == 0)
+        {
+            const float red = random_float(0, 100) / 100.f;
+            const float green = random_float(0, 100) / 100.f;
+            const float blue = random_float(0, 100) / 100.f;
+            colors = glm::vec3{red, green, blue}; // Pixel aléatoire
+        }
+    }
+}
+
+void rotate90(sil::Image& img)
+{
+    SIL_TRACE_SCOPE("rotate90");
+    SIL_EFFECT_METRICS("rotate90", img.width() * img.height());
+    int width = img.width();
+    int height = img.height();
+    sil::Image rotated_image{height, width};
+
+    for (int y{0}; y < height; y++)
+    {
+        for (int x{0}; x < width; x++)
+        {
+            rotated_image.pixel(height - 1 - y, x) = img.pixel(x, y);
+        }
+    }
+
+    img = std::move(rotated_image); // On remplace l'ancienne image par la nouvelle équivaut à img.pixels() = new_img.pixels();
+}
+
+void splitRGB(sil::Image& img)
+{
+    SIL_TRACE_SCOPE("splitRGB");
+    SIL_EFFECT_METRICS("splitRGB", img.width() * img.height());
+    int width = img.width();
+    int height = img.height();
+    sil::Image split_image{width, height};
+    const int offset = 25;
+
+    for (int y{0}; y < height; y++)
+    {
+        for (int x{0}; x < width; x++)
+        {
+            float red = img.pixel(std::max(x - offset, 0), y).r;
+            float blue = img.pixel(std::min(x + offset, width - 1), y).b;
+            split_image.pixel(x, y) = glm::vec3{red, img.pixel(x, y).g, blue};
+        }
+    }
+
+    img = std::move(split_image);
+}
+
+void brightness(sil::Image& img, Brightness mode)
+{
+    SIL_TRACE_SCOPE("brightness");
+    SIL_EFFECT_METRICS("brightness", img.width() * img.height());
+    // Le mode est choisi une seule fois : chaque mode a sa propre boucle, sans test par pixel
+    visit_values<Brightness::Darker, Brightness::Brighter>(mode, [&](auto mode) {
+        for (glm::vec3& colors : img.pixels())
+        {
+            if constexpr (mode == Brightness::Darker)
+            {
+                colors = glm::vec3{colors.r * colors.r, colors.g * colors.g, colors.b * colors.b};
+            }
+            else
+            {
+                colors = glm::vec3{std::sqrt(colors.r), std::sqrt(colors.g), std::sqrt(colors.b)};
+            }
+        }
+    });
+}
+
+void disk(sil::Image& img, float radius, int centerX, int centerY)
+{
+    SIL_TRACE_SCOPE("disk");
+    SIL_EFFECT_METRICS("disk", img.width() * img.height());
+    int width = img.width();
+    int height = img.height();
+    if (centerX == -1) centerX = width / 2;
+    if (centerY == -1) centerY = height / 2;
+
+    for (int y{0}; y < height; y++)
+    {
+        for (int x{0}; x < width; x++)
+        {
+
+            // Formule de la distance entre deux points : d = sqrt((x2 - x1)² + (y2 - y1)²)
+            float dx = x - centerX; // x2 - x1
+            float dy = y - centerY; // y2 - y1
+            float distance = std::sqrt(dx * dx + dy * dy); // sqrt((x2 - x1)² + (y2 - y1)²
+            if (distance < radius)
+            {
+                img.pixel(x, y) = glm::vec3{1.f, 1.f, 1.f};
+            }
+        }
+    }
+}
+
+void circle(sil::Image& img, float radius, float thickness, int centerX, int centerY)
+{
+    SIL_TRACE_SCOPE("circle");
+    SIL_EFFECT_METRICS("circle", img.width() * img.height());
+    int width = img.width();
+    int height = img.height();
+    if (centerX == -1) centerX = width / 2;
+    if (centerY == -1) centerY = height / 2;
+
+    for (int y{0}; y < height; y++)
+    {
+        for (int x{0}; x < width; x++)
+        {
+            // Formule de la distance entre deux points : d = sqrt((x2 - x1)² + (y2 - y1)²)
+            float dx = x - centerX; // x2 - x1
+            float dy = y - centerY; // y2 - y1
+            float distance = std::sqrt(dx * dx + dy * dy); // sqrt((x2 - x1)² + (y2 - y1)²
+            if (distance < radius + thickness && distance > radius - thickness)
+            {
+                img.pixel(x, y) = glm::vec3{1.f, 1.f, 1.f};
+            }
+        }
+    }
+}
+
+void animation(int centerY, int seconds, int ips)
+{
+    SIL_TRACE_SCOPE("animation");
+    const int width = 500;
+    const int height = 500;
+
+    if (centerY == -1) centerY = height / 2;
+
+    for (int x{0}; x < width; x += width / (seconds * ips))
+    {
+        // Image presque entièrement noire : stockée par plages, le disque n'ajoute qu'une plage par ligne
+        RleImage img{width, height};
+        rle_disk(img, 100.f, x, centerY);
+        img.save("output/animation/frame_" + std::to_string(x) + ".png");
+    }
+}
+
+void rosette(sil::Image& img, int circles, float tightness, float radius)
+{
+    SIL_TRACE_SCOPE("rosette");
+    SIL_EFFECT_METRICS("rosette", img.width() * img.height());
+    int width = img.width();
+    int height = img.height();
+    float centerX = width / 2.f;
+    float centerY = height / 2.f;
+
+    float offset = radius * 2 * tightness;
+
+    for (int i = 0; i < circles; ++i)
+    {
+        // Calcul de l'angle actuel en radians (formule : angle = (2 * π * i) / nombre_de_cercles)
+        float angle = (2.0f * std::numbers::pi * i) / circles;
+
+        // Conversion coordonnées polaires en coordonnées cartésiennes (formules : x = centerX + offset * cos(angle) et y = centerY + offset * sin(angle))
+        float cx = centerX + offset * std::cos(angle);
+        float cy = centerY + offset * std::sin(angle);
+
+        circle(img, radius, 3.f, static_cast<int>(cx), static_cast<int>(cy));
+    }
+
+    // Cercle central
+    circle(img, radius, 3.f, static_cast<int>(centerX), static_cast<int>(centerY));
+}
+
+void mosaic(sil::Image& img, int copies)
+{
+    SIL_TRACE_SCOPE("mosaic");
+    SIL_EFFECT_METRICS("mosaic", img.width() * img.height());
+    img = TiledView{img, copies, copies}.materialize();
+}
+
+void mosaic_mirror(sil::Image& img, int copies)
+{
+    SIL_TRACE_SCOPE("mosaic_mirror");
+    SIL_EFFECT_METRICS("mosaic_mirror", img.width() * img.height());
+    img = TiledView{img, copies, copies, Tiling::MirroredRepeat}.materialize();
+}
+
+void glitch(sil::Image& img)
+{
+    SIL_TRACE_SCOPE("glitch");
+    SIL_EFFECT_METRICS("glitch", img.width() * img.height());
+    int width = img.width();
+    int height = img.height();
+
+    for (int x = 0; x < width; x ++)
+    {
+        for (int y = 0; y < height; y ++)
+        {
+            const int random = random_int(0, 1500);
+            if(random == 0) {
+                int rectWidth = random_int(10, 50);
+                int rectHeight = random_int(1, 10);
+                int x2 = random_int(0, width - rectWidth);
+                int y2 = random_int(0, height - rectHeight);
+
+                for (int dx = 0; dx < rectWidth; dx++) {
+                    for (int dy = 0; dy < rectHeight; dy++) {
+                        if (x + dx < width && y + dy < height && x2 + dx < width && y2 + dy < height) {
+                            std::swap(img.pixel(x + dx, y + dy), img.pixel(x2 + dx, y2 + dy));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void pixelSort(sil::Image& img)
+{
+    SIL_TRACE_SCOPE("pixelSort");
+    SIL_EFFECT_METRICS("pixelSort", img.width() * img.height());
+    std::vector<glm::vec3> pixels = img.pixels();
+    int pixelIndex = 0;
+    while (pixelIndex < img.width() * img.height())
+    {
+        int random = random_int(0, 75);
+        if (random == 0) {
+            int randomLength = random_int(20, 75);
+            int endIndex = std::min(pixelIndex + randomLength, img.width() * img.height());
+            std::sort(pixels.begin() + pixelIndex, pixels.begin() + endIndex, [](const glm::vec3& a, const glm::vec3& b) {
+                return (a.r + a.g + a.b) < (b.r + b.g + b.b); // Tri par luminosité totale (addition des composantes R, G et B)
+            });
+            pixelIndex = endIndex;
+        }
+        else {
+            pixelIndex++;
+        }
+    }
+    img.pixels() = pixels;
+}
+
+void mandelbrotFractal(sil::Image& img, int iterations)
+{
+    SIL_TRACE_SCOPE("mandelbrotFractal");
+    SIL_EFFECT_METRICS("mandelbrotFractal", img.width() * img.height());
+    int width = img.width();
+    int height = img.height();
+
+    // Chaque pixel ne dépend que de sa position : les lignes sont réparties entre les threads
+    parallel_for_bands(0, height, [&](int y_begin, int y_end) {
+        for (int y = y_begin; y < y_end; ++y)
+        {
+            for (int x = 0; x < width; ++x) {
+                std::complex<float> c(
+                    (static_cast<float>(x) / width) * 3.5f - 2.5f,
+                    (static_cast<float>(y) / height) * 2.0f - 1.0f
+                );
+                std::complex<float> z = 0;
+                int n = 0;
+
+                while (std::abs(z) <= 2.0f && n < iterations)
+                {
+                    z = z * z + c;
+                    ++n;
+                }
+
+                float t = static_cast<float>(n) / iterations;
+                img.pixel(x, y) = glm::vec3{t, t, t};
+            }
+        }
+    });
+}
+
+std::vector<std::vector<float>> getKernel(Kernel type) {
+    if (type == Kernel::BoxBlur) return {};
+    return static_kernel(type).to_vector();
+}
+
+void blur_convolution(sil::Image& img, int size) {
+    SIL_TRACE_SCOPE("blur_convolution");
+    SIL_EFFECT_METRICS("blur_convolution", img.width() * img.height());
+    if (size <= 1) return;
+
+    const int w = img.width();
+    const int h = img.height();
+    const int half = size / 2;
+
+    sil::Image temp{w, h};
+
+    // Passe horizontale : chaque ligne a sa propre somme glissante, les lignes sont réparties entre les threads
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        for (int y = y_begin; y < y_end; ++y) {
+            glm::vec3 sum{0.f};
+
+            for (int i = -half; i < -half + size; ++i) {
+                int sx = std::clamp(i, 0, w - 1);
+                sum += img.pixel(sx, y);
+            }
+
+            temp.pixel(0, y) = sum / static_cast<float>(size);
+
+            for (int x = 1; x < w; ++x) {
+                int removeX = std::clamp(x - half - 1, 0, w - 1);
+                int addX    = std::clamp(x - half + size - 1, 0, w - 1);
+
+                sum -= img.pixel(removeX, y);
+                sum += img.pixel(addX, y);
+
+                temp.pixel(x, y) = sum / static_cast<float>(size);
+            }
+        }
+    });
+
+    sil::Image out{w, h};
+
+    // Passe verticale : même chose par colonne, les colonnes sont réparties entre les threads
+    parallel_for_bands(0, w, [&](int x_begin, int x_end) {
+        for (int x = x_begin; x < x_end; ++x) {
+            glm::vec3 sum{0.f};
+
+            for (int j = -half; j < -half + size; ++j) {
+                int sy = std::clamp(j, 0, h - 1);
+                sum += temp.pixel(x, sy);
+            }
+
+            out.pixel(x, 0) = sum / static_cast<float>(size);
+
+            for (int y = 1; y < h; ++y) {
+                int removeY = std::clamp(y - half - 1, 0, h - 1);
+                int addY    = std::clamp(y - half + size - 1, 0, h - 1);
+
+                sum -= temp.pixel(x, removeY);
+                sum += temp.pixel(x, addY);
+
+                out.pixel(x, y) = sum / static_cast<float>(size);
+            }
+        }
+    });
+
+    img = std::move(out);
+}
+
+void convolution(sil::Image& img, Kernel kernel) {
+    SIL_TRACE_SCOPE("convolution");
+    SIL_EFFECT_METRICS("convolution", img.width() * img.height());
+    // Un switch plutôt que visit_values : -Wswitch signale un noyau oublié, qui passe sinon par la version générique
+    switch (kernel) {
+        case Kernel::Identity:
+            convolution_static<kernels::identity>(img);
+            return;
+
+        case Kernel::Blur:
+            convolution_static<kernels::blur>(img);
+            return;
+
+        case Kernel::Sharpen:
+            convolution_static<kernels::sharpen>(img);
+            return;
+
+        case Kernel::EdgeDetection:
+            convolution_static<kernels::edge_detection>(img);
+            return;
+
+        case Kernel::BoxBlur:
+            blur_convolution(img);
+            return;
+    }
+
+    convolution_runtime(img, getKernel(kernel));
+}
+
+void convolution(ImageU8& img, Kernel kernel) {
+    SIL_TRACE_SCOPE("convolution");
+    SIL_EFFECT_METRICS("convolution", img.width() * img.height());
+    if (kernel == Kernel::BoxBlur) {
+        sil::Image blurred = img.to_image();
+        blur_convolution(blurred);
+        img = ImageU8{blurred};
+        return;
+    }
+    convolution(img, getKernel(kernel));
+}
+
+void gaussienne_difference(sil::Image& img) {
+    SIL_TRACE_SCOPE("gaussienne_difference");
+    SIL_EFFECT_METRICS("gaussienne_difference", img.width() * img.height());
+    sil::Image blurred1 = img;
+    sil::Image blurred2 = img;
+
+    blur_convolution(blurred1, 1);
+    blur_convolution(blurred2, 3);
+
+    for (int y = 0; y < img.height(); ++y) {
+        for (int x = 0; x < img.width(); ++x) {
+            glm::vec3 c1 = blurred1.pixel(x, y);
+            glm::vec3 c2 = blurred2.pixel(x, y);
+            img.pixel(x, y) = glm::vec3{
+                std::clamp(c1.r - c2.r > 0.03f ? 1.f : c1.r - c2.r, 0.f, 1.f),
+                std::clamp(c1.g - c2.g > 0.03f ? 1.f : c1.g - c2.g, 0.f, 1.f),
+                std::clamp(c1.b - c2.b > 0.03f ? 1.f : c1.b - c2.b, 0.f, 1.f)
+            };
+        }
+    }
+}
+
+void kuwahara(sil::Image& img, int radius) {
+    SIL_TRACE_SCOPE("kuwahara");
+    SIL_EFFECT_METRICS("kuwahara", img.width() * img.height());
+    const int w = img.width();
+    const int h = img.height();
+    if (radius <= 0) return;
+
+    sil::Image original = img;
+
+    // Chaque pixel ne lit que la copie de l'image d'origine : les lignes sont réparties entre les threads
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        for (int y = y_begin; y < y_end; ++y) {
+            for (int x = 0; x < w; ++x) {
+
+                glm::vec3 bestMean{0.f};
+                float bestVar = std::numeric_limits<float>::infinity();
+
+                for (int q = 0; q < 4; ++q) {
+                    int dx0 = (q == 0 || q == 2) ? -radius : 0;
+                    int dx1 = (q == 0 || q == 2) ? 0       : radius;
+                    int dy0 = (q == 0 || q == 1) ? -radius : 0;
+                    int dy1 = (q == 0 || q == 1) ? 0       : radius;
+
+                    glm::vec3 mean{0.f};
+                    float meanL = 0.f;
+                    int count = 0;
+
+                    for (int dy = dy0; dy <= dy1; ++dy) {
+                        for (int dx = dx0; dx <= dx1; ++dx) {
+                            int sx = std::clamp(x + dx, 0, w - 1);
+                            int sy = std::clamp(y + dy, 0, h - 1);
+                            const glm::vec3 c = original.pixel(sx, sy);
+                            mean += c;
+                            meanL += 0.299f * c.r + 0.587f * c.g + 0.114f * c.b;
+                            ++count;
+                        }
+                    }
+
+                    if (count == 0) continue;
+                    mean /= static_cast<float>(count);
+                    meanL /= static_cast<float>(count);
+
+                    float var = 0.f;
+                    for (int dy = dy0; dy <= dy1; ++dy) {
+                        for (int dx = dx0; dx <= dx1; ++dx) {
+                            int sx = std::clamp(x + dx, 0, w - 1);
+                            int sy = std::clamp(y + dy, 0, h - 1);
+                            float l = 0.299f * original.pixel(sx, sy).r + 0.587f * original.pixel(sx, sy).g + 0.114f * original.pixel(sx, sy).b;
+                            float d = l - meanL;
+                            var += d * d;
+                        }
+                    }
+                    var /= static_cast<float>(count);
+
+                    if (var < bestVar) {
+                        bestVar = var;
+                        bestMean = mean;
+                    }
+                }
+
+                img.pixel(x, y) = bestMean;
+            }
+        }
+    });
+}
+
+namespace {
+
+/**
+ * Applique un tramage (dithering) à une valeur de couleur d'un canal (R, G ou B) en utilisant un motif de Bayer 4x4.
+ * Le tramage est une technique de quantification qui permet de simuler des niveaux de couleur intermédiaires en utilisant des motifs de pixels.
+ * 
+ * @param value Valeur de couleur du canal à tramer (entre 0 et 1).
+ * @param x Coordonnée x du pixel (utilisée pour déterminer le seuil de tramage à partir du motif de Bayer).
+ * @param y Coordonnée y du pixel (utilisée pour déterminer le seuil de tramage à partir du motif de Bayer).
+ */
+float dither_channel(float value, int x, int y)
+{
+    static const int bayer[4][4] = {
+        { 0,  8,  2, 10},
+        {12,  4, 14,  6},
+        { 3, 11,  1,  9},
+        {15,  7, 13,  5}
+    };
+
+    value = std::clamp(value, 0.f, 1.f);
+
+    float threshold = (bayer[y % 4][x % 4] + 0.5f) / 16.f;
+
+    return value > threshold ? 1.f : 0.f;
+}
+
+} // namespace
+
+void dithering(sil::Image& img, bool color)
+{
+    SIL_TRACE_SCOPE("dithering");
+    SIL_EFFECT_METRICS("dithering", img.width() * img.height());
+    int width = img.width();
+    int height = img.height();
+
+    visit_values<true, false>(color, [&](auto color) {
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                glm::vec3 colorVec = img.pixel(x, y);
+
+                if constexpr (color) {
+                    colorVec.r = dither_channel(colorVec.r, x, y);
+                    colorVec.g = dither_channel(colorVec.g, x, y);
+                    colorVec.b = dither_channel(colorVec.b, x, y);
+                } else {
+                    float gray = 0.299f * colorVec.r + 0.587f * colorVec.g + 0.114f * colorVec.b;
+                    gray = dither_channel(gray, x, y);
+                    colorVec = glm::vec3{gray, gray, gray};
+                }
+
+                img.pixel(x, y) = colorVec;
+            }
+        }
+    });
+}
+
+/* ----- Effets personnels ----- */
+
+void pixelated(sil::Image& img, int blockSize) // Effet 8 bits
+{
+    SIL_TRACE_SCOPE("pixelated");
+    SIL_EFFECT_METRICS("pixelated", img.width() * img.height());
+    int width = img.width();
+    int height = img.height();
+
+    for (int y = 0; y < height; y += blockSize)
+    {
+        for (int x = 0; x < width; x += blockSize)
+        {
+            // Calcul de la couleur moyenne du bloc
+            glm::vec3 avgColor{0.f, 0.f, 0.f};
+            int pixelCount = 0;
+
+            for (int dy = 0; dy < blockSize; ++dy)
+            {
+                for (int dx = 0; dx < blockSize; ++dx)
+                {
+                    if (x + dx < width && y + dy < height)
+                    {
+                        avgColor += img.pixel(x + dx, y + dy);
+                        pixelCount++;
+                    }
+                }
+            }
+
+            if (pixelCount > 0)
+            {
+                avgColor /= static_cast<float>(pixelCount);
+            }
+
+            // Application de la couleur moyenne à tous les pixels du bloc
+            for (int dy = 0; dy < blockSize; ++dy)
+            {
+                for (int dx = 0; dx < blockSize; ++dx)
+                {
+                    if (x + dx < width && y + dy < height)
+                    {
+                        img.pixel(x + dx, y + dy) = avgColor;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* 
+    Image différentielle 
+    Effet vu lors de ma 3ème année de BUT Info pour un exercice en C (création de notre propre format d'image et de compression)
+*/
+
+namespace {
+
+/**
+ * Calcule les différences entre chaque pixel et le pixel précédent dans l'image.
+ * Le premier pixel reste inchangé.
+ *
+ * @param img Image source (type sil::Image).
+ * @return Vecteur contenant les pixels différentiels.
+ */
+std::vector<glm::vec3> pixel_to_diff(sil::Image& img)
+{
+    int width = img.width();
+    int height = img.height();
+    std::vector<glm::vec3> differential;
+    differential.reserve(width * height);
+    std::vector<glm::vec3> image_pixels = img.pixels(); // Copie des pixels de l'image (tableau 1D)
+
+    for (int x = 0; x < width * height; ++x)
+    {
+        if (x == 0){
+            differential.push_back(image_pixels[0]);
+            continue;
+        } else {
+            differential.push_back(image_pixels[x] - image_pixels[x - 1]);
+        }        
+    }
+
+    return differential;
+}
+
+} // namespace
+
+void save_differential_data_in_csv(std::vector<glm::vec3> data, const std::string& filename)
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Erreur : impossible d'ouvrir le fichier " << filename << std::endl;
+        return;
+    }
+
+    file << "R,G,B\n"; // En-tête du fichier CSV
+    file << std::fixed << std::setprecision(6);
+
+    for (const auto& color : data)
+    {
+        file << color.r << "," << color.g << "," << color.b << "\n";
+    }
+
+    file.close();
+    std::cout << "Data saved in " << filename << std::endl;
+}
+
+void differential(sil::Image& img, bool save_csv, const std::string& csv_filename)
+{
+    SIL_TRACE_SCOPE("differential");
+    SIL_EFFECT_METRICS("differential", img.width() * img.height());
+    int width = img.width();
+    int height = img.height();
+    std::vector<glm::vec3> differential = pixel_to_diff(img);
+    sil::Image differential_image{width, height};
+
+    for (int x = 0; x < width; ++x)
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            glm::vec3 colors = glm::abs(differential[y * width + x]);
+            glm::vec3 base = {1.0f, 1.0f, 1.0f};
+            differential_image.pixel(x, y) = base - colors;
+        }
+    }
+
+    if (save_csv){
+        save_differential_data_in_csv(differential, csv_filename);
+    }
+    img = std::move(differential_image);
+}
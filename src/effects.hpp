@@ -0,0 +1,322 @@
+#pragma once
+#include <sil/sil.hpp>
+#include <glm/vec3.hpp>
+#include <string>
+#include <vector>
+#include "image_u8.hpp"
+#include "static_convolution.hpp"
+
+/**
+ * Conserve uniquement la composante verte de chaque pixel de l'image.
+ * Les composantes rouge et bleue sont mises à zéro.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ */
+void keep_green_only(sil::Image& img);
+
+/**
+ * Échange les composantes rouge et bleue de chaque pixel de l'image.
+ * La composante verte reste inchangée.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ */
+void channels_swap(sil::Image& img);
+
+/**
+ * Convertit l'image en niveaux de gris en utilisant la formule de luminance relative au système sRGB.
+ * La nouvelle valeur de chaque composante (R, G, B) est calculée comme suit :
+ * gray = 0.299 * R + 0.587 * G + 0.114 * B
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ */
+void black_and_white(sil::Image& img);
+
+/**
+ * Applique un effet de négatif à l'image en inversant les valeurs de chaque composante de couleur.
+ * On sait que les couleurs sont dans l'espace sRGB et donc entre 0 et 1, on peut donc faire la négation donc :
+ * new_color = 1.0 - original_color
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ */
+void negative(sil::Image& img);
+
+/**
+ * Remplit l'image avec un dégradé horizontal allant du noir à gauche (0, 0, 0) au blanc à droite (1, 1, 1).
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ */
+void gradient(sil::Image& img);
+
+enum class Mirror
+{
+    Horizontal,
+    Vertical,
+    Both
+};
+
+/**
+ * Miroir l'image horizontalement.
+ * Chaque pixel (x, y) est échangé avec son symétrique par rapport à l'axe vertical passant par le milieu de l'image, c'est-à-dire le pixel (width - 1 - x, y).
+ * En vertical, le pixel (x, y) est échangé avec (x, height - 1 - y), et avec Both avec (width - 1 - x, height - 1 - y).
+ * La direction est choisie une fois pour toutes (visit_values) : chaque direction a sa propre boucle.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param direction Direction du miroir (par défaut Mirror::Horizontal).
+ */
+void mirror(sil::Image& img, Mirror direction = Mirror::Horizontal);
+
+/**
+ * Ajoute du bruit aléatoire à chaque pixel de l'image.
+ * On modifie aléatoirement la couleur d'environ 20% des pixels en leur assignant une couleur aléatoire.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ */
+void noisy(sil::Image& img);
+
+/**
+ * Fait pivoter l'image de 90 degrés dans le sens des aiguilles d'une montre.
+ * La nouvelle position du pixel (x, y) devient (height - 1 - y, x) dans l'image pivotée.
+ * On crée une nouvelle image pour stocker le résultat, puis on remplace l'ancienne image par la nouvelle.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ */
+void rotate90(sil::Image& img);
+
+/**
+ * Applique un effet de séparation des canaux RGB en décalant la composante rouge vers la gauche et la composante bleue vers la droite.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ */
+void splitRGB(sil::Image& img);
+
+enum class Brightness
+{
+    Darker,
+    Brighter
+};
+
+/**
+ * Modifie la luminosité de l'image en fonction du mode spécifié.
+ * Si le mode est Darker, chaque composante de couleur est élevée au carré pour assombrir l'image.
+ * Si le mode est Brighter, chaque composante de couleur est transformée par la racine carrée pour éclaircir l'image.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param mode Mode de modification de la luminosité (Brightness::Darker ou Brightness::Brighter).
+ */
+void brightness(sil::Image& img, Brightness mode);
+
+/**
+ * Dessine un disque blanc sur un fond noir.
+ * Le rayon et le centre du disque peuvent être spécifiés.
+ * Si le centre n'est pas spécifié, il est placé au centre de l'image.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param radius Rayon du disque (par défaut 100.f).
+ * @param centerX Coordonnée x du centre du disque (par défaut -1, ce qui signifie centré horizontalement).
+ * @param centerY Coordonnée y du centre du disque (par défaut -1, ce qui signifie centré verticalement).
+ */
+void disk(sil::Image& img, float radius = 100.f, int centerX = -1, int centerY = -1);
+
+/**
+ * Dessine un cercle blanc sur un fond noir.
+ * Le rayon, l'épaisseur et le centre du cercle peuvent être spécifiés.
+ * Si le centre n'est pas spécifié, il est placé au centre de l'image.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param radius Rayon du cercle (par défaut 100.f).
+ * @param thickness Épaisseur du cercle (par défaut 3.f).
+ * @param centerX Coordonnée x du centre du cercle (par défaut -1, ce qui signifie centré horizontalement).
+ * @param centerY Coordonnée y du centre du cercle (par défaut -1, ce qui signifie centré verticalement).
+ */
+void circle(sil::Image& img, float radius = 100.f, float thickness = 3.f, int centerX = -1, int centerY = -1);
+
+/**
+ * Crée une animation en dessinant un disque blanc se déplaçant horizontalement sur un fond noir.
+ * Le disque se déplace de la gauche vers la droite de l'image.
+ * Le nombre de secondes et le nombre d'images par seconde (ips) peuvent être spécifiés.
+ * Le centre vertical du disque peut également être spécifié.
+ *
+ * @param centerY Coordonnée y du centre du disque (par défaut -1, ce qui signifie centré verticalement).
+ * @param seconds Durée de l'animation en secondes (par défaut 3 secondes).
+ * @param ips Images par seconde (par défaut 25 ips).
+ */
+void animation(int centerY = -1, int seconds = 3, int ips = 25);
+
+/**
+ * Dessine une rosace composée de plusieurs cercles blancs sur un fond noir.
+ * Le nombre de cercles, la "serréité" (tightness) et le rayon des cercles peuvent être spécifiés.
+ * Les cercles sont disposés de manière circulaire autour du centre de l'image.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param circles Nombre de cercles dans la rosette (par défaut 6).
+ * @param tightness Facteur de serréité des cercles (par défaut 0.5f).
+ * @param radius Rayon des cercles (par défaut 100.f).
+ */
+void rosette(sil::Image& img, int circles = 6, float tightness = 0.5f, float radius = 100.f);
+
+/**
+ * Applique un effet de mosaïque à l'image en répétant l'image plusieurs fois.
+ * Pour seulement afficher ou enregistrer la mosaïque, TiledView évite de construire l'image complète.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param copies Nombre de copies de l'image sur chaque ligne et sur chaque colonne (par défaut 5).
+ */
+void mosaic(sil::Image& img, int copies = 5);
+
+/**
+ * Applique un effet de mosaïque avec miroir à l'image en répétant l'image plusieurs fois et en inversant alternativement les lignes.
+ * Pour seulement afficher ou enregistrer la mosaïque, TiledView évite de construire l'image complète.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param copies Nombre de copies de l'image sur chaque ligne et sur chaque colonne (par défaut 5).
+ */
+void mosaic_mirror(sil::Image& img, int copies = 5);
+
+/**
+ * Applique un effet de glitch à l'image en déplaçant aléatoirement des blocs de pixels.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ */
+void glitch(sil::Image& img);
+
+/**
+ * Trie les pixels de l'image par segments aléatoires en fonction de leur luminosité totale.
+ * Parcourt les pixels de l'image et, avec une probabilité de 1 sur 75, sélectionne un segment de pixels de longueur aléatoire entre 20 et 75 pixels.
+ * Trie ensuite ce segment de pixels en fonction de la somme de leurs composantes R, G et B (luminosité totale).
+ * 
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ */
+void pixelSort(sil::Image& img);
+
+/**
+ * Génère le fractal de Mandelbrot et le dessine dans l'image fournie.
+ * Chaque pixel de l'image est coloré en fonction du nombre d'itérations nécessaires pour déterminer si le point complexe correspondant appartient à l'ensemble de Mandelbrot.
+ * Les lignes sont réparties entre les threads (parallel_for_bands).
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param iterations Nombre maximum d'itérations pour déterminer l'appartenance à l'ensemble de Mandelbrot (par défaut 100).
+ */
+void mandelbrotFractal(sil::Image& img, int iterations = 100);
+
+enum class Kernel
+{
+    Identity,
+    Blur,
+    Sharpen,
+    EdgeDetection,
+    BoxBlur
+};
+
+/**
+ * Matrice de chaque noyau, connue à la compilation (utilisable comme paramètre de convolution_static).
+ * BoxBlur n'a pas de matrice 3x3 : c'est un flou 100x100 calculé par sommes glissantes (blur_convolution), la fonction renvoie alors l'identité.
+ */
+constexpr StaticKernel<3> static_kernel(Kernel type) {
+    switch (type) {
+        case Kernel::Identity:
+            return kernels::identity;
+
+        case Kernel::Blur:
+            return kernels::blur;
+
+        case Kernel::Sharpen:
+            return kernels::sharpen;
+
+        case Kernel::EdgeDetection:
+            return kernels::edge_detection;
+
+        case Kernel::BoxBlur:
+            break;
+    }
+
+    return kernels::identity;
+}
+
+std::vector<std::vector<float>> getKernel(Kernel type);
+
+/**
+ * Applique une convolution de flou à l'image en utilisant un noyau de moyenne mobile de taille spécifiée.
+ * La convolution est effectuée en deux passes : d'abord horizontalement, puis verticalement.
+ * Le résultat final est une image floutée, où chaque pixel est la moyenne des pixels environnants dans un carré de taille "size x size".
+ * Les lignes de la première passe et les colonnes de la deuxième sont réparties entre les threads.
+ * 
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param size Taille du noyau de flou (par défaut 100). 
+ */
+void blur_convolution(sil::Image& img, int size = 100);
+
+/**
+ * Applique une convolution à l'image en utilisant un noyau de convolution spécifié.
+ * La convolution est effectuée en parcourant chaque pixel de l'image (sauf les bords) et en calculant la nouvelle valeur du pixel en fonction des pixels voisins et du noyau.
+ * Chaque noyau a sa propre version compilée (convolution_static), choisie une seule fois par appel : poids nuls retirés et poids égaux regroupés.
+ * Un noyau sans version compilée passe par convolution_runtime() avec la matrice de getKernel().
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param kernel Type de noyau de convolution à appliquer (Kernel::Identity, Kernel::Blur, Kernel::Sharpen, Kernel::EdgeDetection).
+ */
+void convolution(sil::Image& img, Kernel kernel);
+
+/**
+ * Applique une convolution à une image 8 bits.
+ * Les noyaux de getKernel() sont tous exacts en virgule fixe (poids entiers ou fractions dyadiques) : le calcul se fait alors en entiers, 16 octets à la fois.
+ *
+ * @param img Image à modifier (type ImageU8), modifiée en place.
+ * @param kernel Type de noyau de convolution à appliquer.
+ */
+void convolution(ImageU8& img, Kernel kernel);
+
+/**
+ * Applique un effet de différence de gaussienne à l'image en utilisant deux convolutions de flou avec des tailles de noyau différentes.
+ * La différence de gaussienne est obtenue en soustrayant l'image floutée avec un noyau plus grand de l'image floutée avec un noyau plus petit.
+ * 
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ */
+void gaussienne_difference(sil::Image& img);
+
+/**
+ * Applique un filtre de Kuwahara à l'image pour réduire le bruit tout en préservant les bords.
+ * Pour chaque pixel, le filtre divise la région environnante en quatre sous-régions et calcule la moyenne et la variance de chaque sous-région.
+ * Le pixel est ensuite remplacé par la moyenne de la sous-région ayant la plus faible variance.
+ * Les lignes sont réparties entre les threads (parallel_for_bands), ce qui permet aussi d'annuler le filtre en cours dans un JobPool.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param radius Rayon de la région environnante à considérer pour le filtrage (par défaut 4).
+ */
+void kuwahara(sil::Image& img, int radius = 4);
+
+/**
+ * Applique un tramage (dithering) en couleur à l'image.
+ * Chaque canal RGB est quantifié avec un motif de Bayer 4x4.
+ *
+ * @param img Image à modifier (modifiée en place)
+ * @param color Si true, applique le tramage à chaque canal RGB, sinon convertit l'image en niveaux de gris avant d'appliquer le tramage.
+ */
+void dithering(sil::Image& img, bool color = true);
+
+/* ----- Effets personnels ----- */
+
+/**
+ * Applique un effet de pixelisation à l'image en regroupant les pixels en blocs et en remplaçant chaque bloc par la couleur moyenne de ses pixels.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param blockSize Taille des blocs de pixels (par défaut 8).
+ */
+void pixelated(sil::Image& img, int blockSize = 8);
+
+/**
+ * Sauvegarde les données différentielles dans un fichier CSV.
+ *
+ * @param data Vecteur contenant les pixels différentiels (type glm::vec3).
+ * @param filename Nom du fichier CSV où les données seront sauvegardées.
+ */
+void save_differential_data_in_csv(std::vector<glm::vec3> data, const std::string& filename);
+
+/**
+ * Créer une image différentielle à partir de l'image source.
+ * L'image différentielle est obtenue en calculant la différence entre chaque pixel et le pixel précédent.
+ * Le résultat est ensuite converti en une image où les valeurs absolues des différences sont utilisées.
+ * Seul le premier pixel reste inchangé.
+ *
+ * @param img Image source (type sil::Image), modifiée en place pour contenir l'image différentielle.
+ */
+void differential(sil::Image& img, bool save_csv = true, const std::string& csv_filename = "../output/differential.csv");
@@ -0,0 +1,288 @@
+#include "fft.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+using Complex = std::complex<float>;
+
+Complex polar(double angle)
+{
+    return Complex{static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle))};
+}
+
+/// Multiplie par -i (rotation d'un quart de tour) sans multiplication.
+Complex minus_i(Complex c)
+{
+    return Complex{c.imag(), -c.real()};
+}
+
+/// Tampon de travail propre à chaque thread, agrandi si besoin.
+Complex* thread_buffer(std::vector<Complex>& buffer, int size)
+{
+    if (static_cast<int>(buffer.size()) < size) buffer.resize(size);
+    return buffer.data();
+}
+
+/// Appelle func(begin, end) directement ou en bandes parallèles.
+template<typename Func>
+void for_range(bool parallel, int begin, int end, Func&& func)
+{
+    if (parallel)
+        parallel_for_bands(begin, end, func, 1);
+    else if (begin < end)
+        func(begin, end);
+}
+
+} // namespace
+
+int next_power_of_two(int n)
+{
+    int p = 1;
+    while (p < n) p *= 2;
+    return p;
+}
+
+Fft::Fft(int size)
+    : _size{size}
+{
+    if (size <= 1) return;
+
+    if ((size & (size - 1)) != 0)
+    {
+        // Bluestein : X[k] = chirp[k] * somme des (x[n] chirp[n]) * conj(chirp[k - n]), une convolution de taille >= 2 * size - 1
+        const int inner_size = next_power_of_two(2 * size - 1);
+        _inner = std::make_unique<Fft>(inner_size);
+        _chirp.resize(size);
+        for (long long n{0}; n < size; n++)
+        {
+            // n² modulo 2 * size : l'angle reste petit et précis même pour de grandes tailles
+            _chirp[n] = polar(-std::numbers::pi * static_cast<double>((n * n) % (2LL * size)) / size);
+        }
+        _chirp_spectrum.assign(inner_size, Complex{0.f});
+        _chirp_spectrum[0] = std::conj(_chirp[0]);
+        for (int n{1}; n < size; n++)
+        {
+            _chirp_spectrum[n] = _chirp_spectrum[inner_size - n] = std::conj(_chirp[n]);
+        }
+        _inner->forward(_chirp_spectrum.data());
+        return;
+    }
+
+    int stride = 1;
+    while (stride < size)
+    {
+        const int radix = (size / stride) % 4 == 0 ? 4 : 2;
+        Stage stage{radix, stride, {}};
+        stage.twiddles.resize(static_cast<size_t>(radix - 1) * stride);
+        for (int r{1}; r < radix; r++)
+        {
+            for (int k{0}; k < stride; k++)
+            {
+                stage.twiddles[(r - 1) * stride + k] = polar(-2.0 * std::numbers::pi * r * k / (static_cast<double>(stride) * radix));
+            }
+        }
+        _stages.push_back(std::move(stage));
+        stride *= radix;
+    }
+}
+
+Fft::~Fft() = default;
+Fft::Fft(Fft&&) noexcept = default;
+Fft& Fft::operator=(Fft&&) noexcept = default;
+
+void Fft::forward(std::complex<float>* data) const
+{
+    if (_size <= 1) return;
+    if (_inner)
+    {
+        bluestein(data);
+        return;
+    }
+    thread_local std::vector<Complex> scratch;
+    stockham(data, thread_buffer(scratch, _size));
+}
+
+void Fft::inverse(std::complex<float>* data) const
+{
+    // inverse(x) = conj(forward(conj(x))) / size
+    for (int i{0}; i < _size; i++) data[i] = std::conj(data[i]);
+    forward(data);
+    const float scale = 1.f / _size;
+    for (int i{0}; i < _size; i++) data[i] = std::conj(data[i]) * scale;
+}
+
+void Fft::stockham(std::complex<float>* data, std::complex<float>* scratch) const
+{
+    // Chaque étape combine `radix` sous-transformées de taille `stride` ; les résultats vont directement à leur place (pas de permutation finale)
+    Complex* in = data;
+    Complex* out = scratch;
+    const int n = _size;
+
+    for (const Stage& stage : _stages)
+    {
+        const int stride = stage.stride;
+        const int quarter = n / stage.radix;
+        const Complex* twiddles = stage.twiddles.data();
+
+        for (int q{0}; q < quarter / stride; q++)
+        {
+            for (int k{0}; k < stride; k++)
+            {
+                const int j = q * stride + k;
+                Complex* o = out + q * stride * stage.radix + k;
+                if (stage.radix == 4)
+                {
+                    const Complex v0 = in[j];
+                    const Complex v1 = in[j + quarter] * twiddles[k];
+                    const Complex v2 = in[j + 2 * quarter] * twiddles[stride + k];
+                    const Complex v3 = in[j + 3 * quarter] * twiddles[2 * stride + k];
+                    const Complex t0 = v0 + v2;
+                    const Complex t1 = v0 - v2;
+                    const Complex t2 = v1 + v3;
+                    const Complex t3 = minus_i(v1 - v3);
+                    o[0] = t0 + t2;
+                    o[stride] = t1 + t3;
+                    o[2 * stride] = t0 - t2;
+                    o[3 * stride] = t1 - t3;
+                }
+                else
+                {
+                    const Complex v0 = in[j];
+                    const Complex v1 = in[j + quarter] * twiddles[k];
+                    o[0] = v0 + v1;
+                    o[stride] = v0 - v1;
+                }
+            }
+        }
+        std::swap(in, out);
+    }
+
+    if (in != data) std::copy_n(in, n, data);
+}
+
+void Fft::bluestein(std::complex<float>* data) const
+{
+    thread_local std::vector<Complex> buffer;
+    const int inner_size = _inner->size();
+    Complex* a = thread_buffer(buffer, inner_size);
+
+    for (int n{0}; n < _size; n++) a[n] = data[n] * _chirp[n];
+    std::fill(a + _size, a + inner_size, Complex{0.f});
+
+    _inner->forward(a);
+    for (int i{0}; i < inner_size; i++) a[i] *= _chirp_spectrum[i];
+    _inner->inverse(a);
+
+    for (int k{0}; k < _size; k++) data[k] = a[k] * _chirp[k];
+}
+
+Fft2d::Fft2d(int width, int height)
+    : _rows{width}, _columns{height}
+{
+}
+
+void Fft2d::forward(const float* image, std::complex<float>* spectrum, bool parallel) const
+{
+    const int w = width();
+    const int h = height();
+    const int sw = spectrum_width();
+
+    // Lignes 2p et 2p + 1 dans une même FFT : z = a + i b, puis A[k] = (Z[k] + conj(Z[w - k])) / 2 et B[k] = -i (Z[k] - conj(Z[w - k])) / 2
+    for_range(parallel, 0, (h + 1) / 2, [&](int begin, int end) {
+        std::vector<Complex> z(w);
+        for (int p{begin}; p < end; p++)
+        {
+            const float* a = image + static_cast<size_t>(2 * p) * w;
+            const bool pair = 2 * p + 1 < h;
+            for (int x{0}; x < w; x++) z[x] = Complex{a[x], pair ? a[x + w] : 0.f};
+            _rows.forward(z.data());
+
+            Complex* out_a = spectrum + static_cast<size_t>(2 * p) * sw;
+            if (!pair)
+            {
+                std::copy_n(z.begin(), sw, out_a);
+                continue;
+            }
+            Complex* out_b = out_a + sw;
+            for (int k{0}; k < sw; k++)
+            {
+                const Complex zk = z[k];
+                const Complex zc = std::conj(z[(w - k) % w]);
+                out_a[k] = 0.5f * (zk + zc);
+                out_b[k] = 0.5f * minus_i(zk - zc);
+            }
+        }
+    });
+
+    transform_columns(spectrum, false, parallel);
+}
+
+void Fft2d::inverse(std::complex<float>* spectrum, float* image, bool parallel) const
+{
+    const int w = width();
+    const int h = height();
+    const int sw = spectrum_width();
+
+    transform_columns(spectrum, true, parallel);
+
+    // Reconstruit le spectre complet de a + i b par symétrie : Z[k] = A[k] + i B[k], et pour k > w / 2, Z[k] = conj(A[w - k]) + i conj(B[w - k])
+    for_range(parallel, 0, (h + 1) / 2, [&](int begin, int end) {
+        std::vector<Complex> z(w);
+        for (int p{begin}; p < end; p++)
+        {
+            const Complex* a = spectrum + static_cast<size_t>(2 * p) * sw;
+            const bool pair = 2 * p + 1 < h;
+            const Complex* b = a + sw;
+            for (int k{0}; k < w; k++)
+            {
+                const Complex ak = k < sw ? a[k] : std::conj(a[w - k]);
+                const Complex bk = !pair ? Complex{0.f} : k < sw ? b[k] : std::conj(b[w - k]);
+                z[k] = ak + Complex{-bk.imag(), bk.real()};
+            }
+            _rows.inverse(z.data());
+
+            float* out = image + static_cast<size_t>(2 * p) * w;
+            for (int x{0}; x < w; x++) out[x] = z[x].real();
+            if (pair)
+            {
+                for (int x{0}; x < w; x++) out[x + w] = z[x].imag();
+            }
+        }
+    });
+}
+
+void Fft2d::transform_columns(std::complex<float>* spectrum, bool inverse, bool parallel) const
+{
+    const int h = height();
+    const int sw = spectrum_width();
+    constexpr int block = 8; // Colonnes recopiées ensemble : chaque ligne lue apporte 8 valeurs utiles (64 octets)
+
+    for_range(parallel, 0, (sw + block - 1) / block, [&](int begin, int end) {
+        std::vector<Complex> columns(static_cast<size_t>(block) * h);
+        for (int b{begin}; b < end; b++)
+        {
+            const int c0 = b * block;
+            const int count = std::min(block, sw - c0);
+            for (int y{0}; y < h; y++)
+            {
+                const Complex* row = spectrum + static_cast<size_t>(y) * sw + c0;
+                for (int c{0}; c < count; c++) columns[static_cast<size_t>(c) * h + y] = row[c];
+            }
+            for (int c{0}; c < count; c++)
+            {
+                if (inverse)
+                    _columns.inverse(columns.data() + static_cast<size_t>(c) * h);
+                else
+                    _columns.forward(columns.data() + static_cast<size_t>(c) * h);
+            }
+            for (int y{0}; y < h; y++)
+            {
+                Complex* row = spectrum + static_cast<size_t>(y) * sw + c0;
+                for (int c{0}; c < count; c++) row[c] = columns[static_cast<size_t>(c) * h + y];
+            }
+        }
+    });
+}
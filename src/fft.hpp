@@ -0,0 +1,81 @@
+#pragma once
+#include <complex>
+#include <memory>
+#include <vector>
+
+/**
+ * Transformée de Fourier rapide (FFT) 1D, pour une taille fixée à la construction (le « plan »).
+ * Les tailles puissances de 2 utilisent l'algorithme de Stockham en base 4 (plus une étape en base 2 si besoin),
+ * les autres tailles l'algorithme de Bluestein, qui se ramène à une convolution calculée avec des FFT de taille puissance de 2.
+ * Un plan ne change plus après sa construction : plusieurs threads peuvent l'utiliser en même temps.
+ */
+class Fft
+{
+public:
+    explicit Fft(int size);
+    ~Fft();
+    Fft(Fft&&) noexcept;
+    Fft& operator=(Fft&&) noexcept;
+
+    int size() const { return _size; }
+
+    /// X[k] = somme des x[n] * exp(-2iπ kn / size), en place.
+    void forward(std::complex<float>* data) const;
+    /// Transformée inverse, divisée par size : inverse(forward(x)) == x, en place.
+    void inverse(std::complex<float>* data) const;
+
+private:
+    /// Étapes de Stockham, tampon de travail fourni (size valeurs).
+    void stockham(std::complex<float>* data, std::complex<float>* scratch) const;
+    void bluestein(std::complex<float>* data) const;
+
+    struct Stage
+    {
+        int radix;
+        int stride; // Taille des sous-transformées déjà combinées
+        std::vector<std::complex<float>> twiddles; // (radix - 1) facteurs par position dans la sous-transformée
+    };
+
+    int _size;
+    std::vector<Stage> _stages;
+
+    // Bluestein : plan puissance de 2, chirp exp(-iπ n² / size) et FFT du noyau de convolution
+    std::unique_ptr<Fft> _inner;
+    std::vector<std::complex<float>> _chirp;
+    std::vector<std::complex<float>> _chirp_spectrum;
+};
+
+/// Plus petite puissance de 2 supérieure ou égale à n.
+int next_power_of_two(int n);
+
+/**
+ * FFT 2D d'images réelles de taille width x height (valeurs rangées ligne par ligne).
+ * Le spectre d'une image réelle est symétrique : seules les colonnes 0 à width / 2 sont calculées et stockées (spectrum_width() valeurs par ligne).
+ * Les lignes sont transformées deux par deux (l'une en partie réelle, l'autre en partie imaginaire d'une même FFT complexe),
+ * puis les colonnes par paquets recopiés dans un tampon contigu pour rester en cache. Les deux passes sont réparties sur plusieurs threads.
+ */
+class Fft2d
+{
+public:
+    Fft2d(int width, int height);
+
+    int width() const { return _rows.size(); }
+    int height() const { return _columns.size(); }
+    int spectrum_width() const { return _rows.size() / 2 + 1; }
+
+    /**
+     * @param image width() * height() valeurs réelles.
+     * @param spectrum spectrum_width() * height() valeurs complexes, remplies.
+     * @param parallel Répartit le calcul sur plusieurs threads (à désactiver quand l'appelant est déjà parallèle).
+     */
+    void forward(const float* image, std::complex<float>* spectrum, bool parallel = true) const;
+
+    /// Transformée inverse (divisée par width * height). Le spectre sert de tampon de travail et est modifié.
+    void inverse(std::complex<float>* spectrum, float* image, bool parallel = true) const;
+
+private:
+    void transform_columns(std::complex<float>* spectrum, bool inverse, bool parallel) const;
+
+    Fft _rows;
+    Fft _columns;
+};
@@ -0,0 +1,316 @@
+#include "guided.hpp"
+#include <sil/metrics.hpp>
+#include <sil/trace.hpp>
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+/**
+ * Plusieurs plans flottants de la même taille, entrelacés : les `channels` valeurs d'un pixel sont consécutives.
+ * Les moyennes sur des carrés traitent ainsi tous les plans en un seul parcours.
+ */
+struct Planes
+{
+    int width;
+    int height;
+    int channels;
+    std::vector<float> data;
+
+    Planes(int width, int height, int channels)
+        : width{width}, height{height}, channels{channels}, data(static_cast<size_t>(width) * height * channels, 0.f)
+    {
+    }
+
+    float* pixel(int x, int y) { return data.data() + (x + static_cast<size_t>(y) * width) * channels; }
+    float const* pixel(int x, int y) const { return data.data() + (x + static_cast<size_t>(y) * width) * channels; }
+};
+
+/**
+ * Remplace chaque valeur par la moyenne du carré (2 * radius + 1)² qui l'entoure, bords prolongés.
+ * Même principe que blur_convolution() : une somme glissante horizontale puis verticale, donc un coût constant par pixel.
+ * La passe verticale avance ligne par ligne avec une somme par colonne : chaque bande de lignes (un thread) garde ses propres sommes.
+ * Les sommes sont en double pour que les ajouts et retraits successifs ne dérivent pas sur les grandes images.
+ */
+void box_mean(Planes& planes, int radius)
+{
+    const int w = planes.width;
+    const int h = planes.height;
+    const int c = planes.channels;
+    const double inv_size = 1.0 / (2 * radius + 1);
+    Planes temp{w, h, c};
+
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        std::vector<double> sum(c);
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            std::fill(sum.begin(), sum.end(), 0.0);
+            for (int dx{-radius}; dx <= radius; dx++)
+            {
+                const float* in = planes.pixel(std::clamp(dx, 0, w - 1), y);
+                for (int k{0}; k < c; k++) sum[k] += in[k];
+            }
+
+            for (int x{0}; x < w; x++)
+            {
+                if (x > 0)
+                {
+                    const float* removed = planes.pixel(std::clamp(x - radius - 1, 0, w - 1), y);
+                    const float* added = planes.pixel(std::clamp(x + radius, 0, w - 1), y);
+                    for (int k{0}; k < c; k++) sum[k] += added[k] - removed[k];
+                }
+                float* out = temp.pixel(x, y);
+                for (int k{0}; k < c; k++) out[k] = static_cast<float>(sum[k] * inv_size);
+            }
+        }
+    });
+
+    const int row_size = w * c;
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        std::vector<double> sum(row_size, 0.0);
+        for (int dy{-radius}; dy <= radius; dy++)
+        {
+            const float* in = temp.pixel(0, std::clamp(y_begin + dy, 0, h - 1));
+            for (int i{0}; i < row_size; i++) sum[i] += in[i];
+        }
+
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            if (y > y_begin)
+            {
+                const float* removed = temp.pixel(0, std::clamp(y - radius - 1, 0, h - 1));
+                const float* added = temp.pixel(0, std::clamp(y + radius, 0, h - 1));
+                for (int i{0}; i < row_size; i++) sum[i] += added[i] - removed[i];
+            }
+            float* out = planes.pixel(0, y);
+            for (int i{0}; i < row_size; i++) out[i] = static_cast<float>(sum[i] * inv_size);
+        }
+    });
+}
+
+float luminance(const glm::vec3& c)
+{
+    return 0.299f * c.r + 0.587f * c.g + 0.114f * c.b;
+}
+
+/// Guide (1 ou 3 canaux) et entrée (3 canaux) réunis dans les mêmes plans : [guide..., entrée...].
+Planes load(const sil::Image& img, const sil::Image& guide, int guide_channels)
+{
+    Planes planes{img.width(), img.height(), guide_channels + 3};
+    parallel_for_bands(0, img.height(), [&](int y_begin, int y_end) {
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            for (int x{0}; x < img.width(); x++)
+            {
+                float* out = planes.pixel(x, y);
+                const glm::vec3& g = guide.pixel(x, y);
+                if (guide_channels == 1)
+                    out[0] = luminance(g);
+                else
+                    std::copy_n(&g.r, 3, out);
+                std::copy_n(&img.pixel(x, y).r, 3, out + guide_channels);
+            }
+        }
+    });
+    return planes;
+}
+
+/// Réduit les plans d'un facteur `factor` en moyennant chaque bloc factor x factor (les blocs du bord peuvent être incomplets).
+Planes downsample(const Planes& planes, int factor)
+{
+    Planes small{(planes.width + factor - 1) / factor, (planes.height + factor - 1) / factor, planes.channels};
+    parallel_for_bands(0, small.height, [&](int y_begin, int y_end) {
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            const int sy_end = std::min((y + 1) * factor, planes.height);
+            for (int x{0}; x < small.width; x++)
+            {
+                const int sx_end = std::min((x + 1) * factor, planes.width);
+                float* out = small.pixel(x, y);
+                for (int sy{y * factor}; sy < sy_end; sy++)
+                {
+                    for (int sx{x * factor}; sx < sx_end; sx++)
+                    {
+                        const float* in = planes.pixel(sx, sy);
+                        for (int k{0}; k < planes.channels; k++) out[k] += in[k];
+                    }
+                }
+                const float inv_count = 1.f / ((sy_end - y * factor) * (sx_end - x * factor));
+                for (int k{0}; k < planes.channels; k++) out[k] *= inv_count;
+            }
+        }
+    });
+    return small;
+}
+
+/**
+ * Calcule les coefficients (a, b) de chaque fenêtre à partir des plans guide + entrée, puis les moyenne (chaque pixel appartient à plusieurs fenêtres).
+ * Guide gris : a et b ont 3 valeurs chacun (une par canal de sortie), plans [a0 a1 a2 b0 b1 b2].
+ * Guide couleur : a est une matrice 3x3 (un vecteur par canal de sortie), plans [a00 a01 a02 a10 ... a22 b0 b1 b2].
+ */
+Planes coefficients(const Planes& input, int guide_channels, int radius, float epsilon)
+{
+    const int w = input.width;
+    const int h = input.height;
+    const int g = guide_channels;
+
+    // Statistiques : guide, entrée, produits guide x guide (triangle supérieur), produits guide x entrée
+    const int products = g == 1 ? 1 : 6;
+    Planes stats{w, h, g + 3 + products + 3 * g};
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            for (int x{0}; x < w; x++)
+            {
+                const float* in = input.pixel(x, y);
+                float* out = stats.pixel(x, y);
+                std::copy_n(in, g + 3, out);
+                out += g + 3;
+                for (int i{0}; i < g; i++)
+                {
+                    for (int j{i}; j < g; j++) *out++ = in[i] * in[j];
+                }
+                for (int c{0}; c < 3; c++)
+                {
+                    for (int i{0}; i < g; i++) *out++ = in[i] * in[g + c];
+                }
+            }
+        }
+    });
+    box_mean(stats, radius);
+
+    Planes coeffs{w, h, 3 * g + 3};
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            for (int x{0}; x < w; x++)
+            {
+                const float* s = stats.pixel(x, y);
+                const float* mean_guide = s;
+                const float* mean_input = s + g;
+                const float* guide_guide = s + g + 3;
+                const float* guide_input = guide_guide + products;
+                float* out = coeffs.pixel(x, y);
+
+                if (g == 1)
+                {
+                    const float variance = guide_guide[0] - mean_guide[0] * mean_guide[0];
+                    for (int c{0}; c < 3; c++)
+                    {
+                        const float covariance = guide_input[c] - mean_guide[0] * mean_input[c];
+                        out[c] = covariance / (variance + epsilon);
+                        out[3 + c] = mean_input[c] - out[c] * mean_guide[0];
+                    }
+                    continue;
+                }
+
+                // Matrice de covariance du guide (symétrique) + epsilon sur la diagonale
+                const glm::vec3 mean{mean_guide[0], mean_guide[1], mean_guide[2]};
+                glm::mat3 sigma;
+                for (int i{0}, k{0}; i < 3; i++)
+                {
+                    for (int j{i}; j < 3; j++, k++)
+                    {
+                        sigma[i][j] = sigma[j][i] = guide_guide[k] - mean[i] * mean[j] + (i == j ? epsilon : 0.f);
+                    }
+                }
+                const glm::mat3 inverse = glm::inverse(sigma);
+
+                for (int c{0}; c < 3; c++)
+                {
+                    const glm::vec3 covariance = glm::vec3{guide_input[3 * c], guide_input[3 * c + 1], guide_input[3 * c + 2]} - mean * mean_input[c];
+                    const glm::vec3 a = inverse * covariance;
+                    std::copy_n(&a.x, 3, out + 3 * c);
+                    out[9 + c] = mean_input[c] - glm::dot(a, mean);
+                }
+            }
+        }
+    });
+    box_mean(coeffs, radius);
+    return coeffs;
+}
+
+} // namespace
+
+void guided_filter(sil::Image& img, const sil::Image& guide, int radius, float epsilon, GuideMode mode, int subsample)
+{
+    SIL_TRACE_SCOPE("guided_filter");
+    SIL_EFFECT_METRICS("guided_filter", img.width() * img.height());
+    if (radius <= 0 || guide.width() != img.width() || guide.height() != img.height()) return;
+
+    const int w = img.width();
+    const int h = img.height();
+    const int g = mode == GuideMode::Gray ? 1 : 3;
+    subsample = std::clamp(subsample, 1, radius);
+
+    const Planes input = load(img, guide, g);
+    const Planes coeffs = subsample == 1
+                            ? coefficients(input, g, radius, epsilon)
+                            : coefficients(downsample(input, subsample), g, std::max(radius / subsample, 1), epsilon);
+
+    // Résultat : q = a * guide + b, avec le guide à pleine résolution (les coefficients réduits sont interpolés linéairement)
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        std::vector<float> ab(coeffs.channels);
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            const float cy = std::clamp((y + 0.5f) / subsample - 0.5f, 0.f, static_cast<float>(coeffs.height - 1));
+            const int y0 = std::min(static_cast<int>(cy), std::max(coeffs.height - 2, 0));
+            const int y1 = std::min(y0 + 1, coeffs.height - 1);
+            const float fy = cy - y0;
+
+            for (int x{0}; x < w; x++)
+            {
+                if (subsample == 1)
+                {
+                    std::copy_n(coeffs.pixel(x, y), coeffs.channels, ab.begin());
+                }
+                else
+                {
+                    const float cx = std::clamp((x + 0.5f) / subsample - 0.5f, 0.f, static_cast<float>(coeffs.width - 1));
+                    const int x0 = std::min(static_cast<int>(cx), std::max(coeffs.width - 2, 0));
+                    const int x1 = std::min(x0 + 1, coeffs.width - 1);
+                    const float fx = cx - x0;
+                    const float* c00 = coeffs.pixel(x0, y0);
+                    const float* c10 = coeffs.pixel(x1, y0);
+                    const float* c01 = coeffs.pixel(x0, y1);
+                    const float* c11 = coeffs.pixel(x1, y1);
+                    for (int k{0}; k < coeffs.channels; k++)
+                    {
+                        const float bottom = c00[k] + (c10[k] - c00[k]) * fx;
+                        const float top = c01[k] + (c11[k] - c01[k]) * fx;
+                        ab[k] = bottom + (top - bottom) * fy;
+                    }
+                }
+
+                const float* guide_value = input.pixel(x, y);
+                glm::vec3& out = img.pixel(x, y);
+                for (int c{0}; c < 3; c++)
+                {
+                    float q = ab[3 * g + c];
+                    for (int i{0}; i < g; i++) q += ab[g * c + i] * guide_value[i];
+                    out[c] = q;
+                }
+            }
+        }
+    });
+}
+
+void detail_enhance(sil::Image& img, float amount, int radius, float epsilon)
+{
+    SIL_TRACE_SCOPE("detail_enhance");
+    SIL_EFFECT_METRICS("detail_enhance", img.width() * img.height());
+    sil::Image base = img;
+    guided_filter(base, img, radius, epsilon, GuideMode::Gray);
+
+    for (int y{0}; y < img.height(); y++)
+    {
+        for (int x{0}; x < img.width(); x++)
+        {
+            glm::vec3& color = img.pixel(x, y);
+            const glm::vec3& smooth = base.pixel(x, y);
+            color = glm::clamp(smooth + amount * (color - smooth), 0.f, 1.f);
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <sil/sil.hpp>
+
+/**
+ * Image servant de guide au filtre guidé.
+ */
+enum class GuideMode
+{
+    Gray,  // Le guide est réduit à sa luminosité : plus rapide, suffisant pour lisser une image par elle-même
+    Color, // Le guide garde ses trois canaux : les bords entre deux couleurs de même luminosité sont aussi préservés
+};
+
+/**
+ * Applique le filtre guidé de He et al. : dans chaque fenêtre (2 * radius + 1)², le résultat est une fonction affine du guide (a * guide + b),
+ * ajustée au mieux sur l'image d'entrée. Là où le guide a des bords, le résultat les suit ; ailleurs il se réduit à une moyenne locale.
+ * Avec l'image elle-même comme guide, c'est un lissage qui préserve les bords (comme kuwahara() ou bilateral_filter()) ;
+ * avec une photo comme guide, il recale un masque grossier sur les contours de la photo.
+ * Tout le calcul se fait avec des moyennes sur des carrés par somme glissante (comme blur_convolution()), le coût ne dépend donc pas du rayon.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param guide Image guide, de la même taille que img (peut être img elle-même).
+ * @param radius Rayon des fenêtres, en pixels (par défaut 8).
+ * @param epsilon Régularisation : plus elle est grande, plus les bords faibles sont lissés (par défaut 0.01, soit un écart de luminosité de 0.1).
+ * @param mode Guide en niveaux de gris ou en couleur (par défaut GuideMode::Color).
+ * @param subsample Facteur de sous-échantillonnage de la version rapide : les coefficients a et b sont calculés sur une image réduite `subsample` fois,
+ *                  puis interpolés à pleine résolution. Le résultat reste net car il est recombiné avec le guide à pleine résolution (par défaut 1, pas de réduction).
+ */
+void guided_filter(sil::Image& img, const sil::Image& guide, int radius = 8, float epsilon = 0.01f, GuideMode mode = GuideMode::Color, int subsample = 1);
+
+/**
+ * Renforce les détails de l'image : la base lissée par le filtre guidé (l'image étant son propre guide) est gardée,
+ * et l'écart entre l'image et cette base est multiplié par `amount`. Les bords marqués ne produisent pas de halo, contrairement à un masque flou.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param amount Facteur appliqué aux détails (par défaut 3, 1 laisse l'image inchangée).
+ * @param radius Rayon du filtre guidé (par défaut 8).
+ * @param epsilon Régularisation du filtre guidé (par défaut 0.01).
+ */
+void detail_enhance(sil::Image& img, float amount = 3.f, int radius = 8, float epsilon = 0.01f);
@@ -0,0 +1,103 @@
+#include "image_cache.hpp"
+#include <sil/trace.hpp>
+#include <algorithm>
+#include <system_error>
+
+ImageCache::ImageCache(int64_t capacity_bytes)
+    : _capacity_bytes{std::max<int64_t>(capacity_bytes, 0)}
+{
+}
+
+std::shared_ptr<const sil::Image> ImageCache::get(const std::filesystem::path& path)
+{
+    SIL_TRACE_SCOPE("ImageCache::get");
+    const std::string key = path.string();
+    std::error_code error;
+    const std::filesystem::file_time_type modified = std::filesystem::last_write_time(path, error); // Date par défaut si le fichier n'existe pas : sil::Image signalera l'erreur
+
+    std::unique_lock lock{_mutex};
+    auto it = _entries.find(key);
+    if (it != _entries.end() && it->second.modified == modified)
+    {
+        _stats.hits++;
+        _recent.splice(_recent.begin(), _recent, it->second.use);
+        const std::shared_future<Shared> image = it->second.image;
+        lock.unlock();
+        return image.get(); // Attend la fin du décodage si un autre thread s'en occupe
+    }
+
+    // Absente ou modifiée depuis : ce thread la décode, les autres demandes attendront son résultat
+    if (it != _entries.end())
+    {
+        _stats.bytes -= it->second.bytes;
+        _recent.erase(it->second.use);
+        _entries.erase(it);
+    }
+    _stats.misses++;
+    std::promise<Shared> promise;
+    const int64_t id = ++_next_id;
+    _recent.push_front(key);
+    _entries[key] = Entry{promise.get_future().share(), modified, 0, id, _recent.begin()};
+    lock.unlock();
+
+    Shared image;
+    try
+    {
+        image = std::make_shared<const sil::Image>(path);
+    }
+    catch (...)
+    {
+        promise.set_exception(std::current_exception());
+        lock.lock();
+        it = _entries.find(key);
+        if (it != _entries.end() && it->second.id == id)
+        {
+            _recent.erase(it->second.use);
+            _entries.erase(it);
+        }
+        throw;
+    }
+    promise.set_value(image);
+
+    lock.lock();
+    it = _entries.find(key);
+    if (it != _entries.end() && it->second.id == id)
+    {
+        it->second.bytes = static_cast<int64_t>(image->pixels().size() * sizeof(glm::vec3));
+        _stats.bytes += it->second.bytes;
+        evict();
+    }
+    return image;
+}
+
+void ImageCache::evict()
+{
+    // Les entrées en cours de décodage (bytes = 0) ne sont pas retirées : d'autres threads attendent peut-être leur résultat
+    auto use = _recent.end();
+    while (_stats.bytes > _capacity_bytes && use != _recent.begin())
+    {
+        --use;
+        const auto it = _entries.find(*use);
+        if (it->second.bytes == 0) continue;
+        _stats.bytes -= it->second.bytes;
+        use = _recent.erase(use);
+        _entries.erase(it);
+    }
+}
+
+ImageCache::Stats ImageCache::stats() const
+{
+    std::lock_guard lock{_mutex};
+    Stats stats = _stats;
+    stats.entries = static_cast<int64_t>(_entries.size());
+    return stats;
+}
+
+void ImageCache::clear()
+{
+    std::lock_guard lock{_mutex};
+    // Les décodages en cours gardent leur promesse : leur résultat sera renvoyé mais pas gardé
+    _entries.clear();
+    _recent.clear();
+    _stats.bytes = 0;
+}
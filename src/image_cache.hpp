@@ -0,0 +1,64 @@
+#pragma once
+#include <sil/sil.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * Cache des images décodées, partagé entre threads : une image demandée plusieurs fois n'est décodée qu'une fois.
+ * Une entrée est oubliée quand la date de modification du fichier change, et les images les moins récemment utilisées
+ * sont retirées quand le total dépasse la capacité. Si plusieurs threads demandent en même temps une image absente,
+ * un seul la décode et les autres attendent son résultat.
+ */
+class ImageCache
+{
+public:
+    struct Stats
+    {
+        int64_t hits{0};
+        int64_t misses{0};
+        int64_t bytes{0};   // Pixels des images gardées en cache
+        int64_t entries{0};
+    };
+
+    /// @param capacity_bytes Taille maximale des pixels gardés en cache (par défaut 512 Mo). Une image plus grosse est décodée mais pas gardée.
+    explicit ImageCache(int64_t capacity_bytes = int64_t{512} << 20);
+
+    /**
+     * Renvoie l'image du fichier, décodée si elle n'est pas déjà dans le cache.
+     * L'image renvoyée reste valide même si elle est ensuite retirée du cache. Lance std::runtime_error si le fichier ne peut pas être lu.
+     *
+     * @param path Chemin de l'image (relatif au dossier du CMakeLists.txt, comme pour sil::Image).
+     */
+    std::shared_ptr<const sil::Image> get(const std::filesystem::path& path);
+
+    Stats stats() const;
+    void clear();
+
+private:
+    using Shared = std::shared_ptr<const sil::Image>;
+
+    struct Entry
+    {
+        std::shared_future<Shared> image;
+        std::filesystem::file_time_type modified;
+        int64_t bytes{0};                     // 0 tant que l'image est en cours de décodage
+        int64_t id{0};                        // Distingue une entrée de celle qui l'a remplacée pendant le décodage
+        std::list<std::string>::iterator use; // Position dans _recent
+    };
+
+    /// Retire les entrées les moins récemment utilisées jusqu'à revenir sous la capacité (verrou pris).
+    void evict();
+
+    int64_t _capacity_bytes;
+    mutable std::mutex _mutex;
+    std::map<std::string, Entry> _entries;
+    std::list<std::string> _recent; // Clés de la plus récemment utilisée à la plus ancienne
+    Stats _stats;
+    int64_t _next_id{0};
+};
@@ -0,0 +1,165 @@
+#include "image_compare.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+namespace {
+
+/// Constantes de stabilisation du SSIM (Wang et al. 2004) pour une dynamique de 255.
+constexpr double C1 = (0.01 * 255.) * (0.01 * 255.);
+constexpr double C2 = (0.03 * 255.) * (0.03 * 255.);
+
+/// Somme des carrés des écarts sur tous les canaux.
+int64_t squared_error(const ImageU8& a, const ImageU8& b)
+{
+    int64_t sum = 0;
+    for (size_t i{0}; i < a.data().size(); i++)
+    {
+        const int d = static_cast<int>(a.data()[i]) - static_cast<int>(b.data()[i]);
+        sum += d * d;
+    }
+    return sum;
+}
+
+double psnr_from_squared_error(int64_t squared_error, size_t values)
+{
+    if (squared_error == 0) return std::numeric_limits<double>::infinity();
+    const double mse = static_cast<double>(squared_error) / static_cast<double>(values);
+    return 10. * std::log10(255. * 255. / mse);
+}
+
+/// Canal `channel` de l'image, rangé dans un tableau contigu pour que les boucles sur les colonnes soient vectorisables.
+std::vector<int32_t> channel_plane(const ImageU8& img, int channel)
+{
+    std::vector<int32_t> plane(static_cast<size_t>(img.width()) * img.height());
+    for (size_t i{0}; i < plane.size(); i++)
+    {
+        plane[i] = img.data()[3 * i + channel];
+    }
+    return plane;
+}
+
+/// Somme des SSIM de toutes les fenêtres window x window d'un canal.
+double ssim_channel_sum(const std::vector<int32_t>& a, const std::vector<int32_t>& b, int width, int height, int window)
+{
+    // Sommes par colonne sur les `window` lignes de la fenêtre courante (au plus 16 * 255² : tient sur 32 bits)
+    std::vector<int32_t> col_a(width, 0), col_b(width, 0), col_aa(width, 0), col_bb(width, 0), col_ab(width, 0);
+    auto add_row = [&](int y, int32_t sign) {
+        const int32_t* ra = a.data() + static_cast<size_t>(y) * width;
+        const int32_t* rb = b.data() + static_cast<size_t>(y) * width;
+        for (int x{0}; x < width; x++)
+        {
+            col_a[x] += sign * ra[x];
+            col_b[x] += sign * rb[x];
+            col_aa[x] += sign * ra[x] * ra[x];
+            col_bb[x] += sign * rb[x] * rb[x];
+            col_ab[x] += sign * ra[x] * rb[x];
+        }
+    };
+
+    const int out_width = width - window + 1;
+    const int64_t n = static_cast<int64_t>(window) * window;
+    const double c1 = C1 * static_cast<double>(n * n);
+    const double c2 = C2 * static_cast<double>(n * n);
+    std::vector<int64_t> sa(out_width), sb(out_width), saa(out_width), sbb(out_width), sab(out_width);
+    std::vector<double> row_ssim(out_width);
+
+    for (int y{0}; y < window; y++) add_row(y, 1);
+
+    double total = 0.;
+    for (int y{0}; y + window <= height; y++)
+    {
+        // Sommes sur les fenêtres de la ligne, par somme glissante horizontale
+        int64_t s[5] = {0, 0, 0, 0, 0};
+        for (int x{0}; x < width; x++)
+        {
+            s[0] += col_a[x];
+            s[1] += col_b[x];
+            s[2] += col_aa[x];
+            s[3] += col_bb[x];
+            s[4] += col_ab[x];
+            if (x >= window)
+            {
+                s[0] -= col_a[x - window];
+                s[1] -= col_b[x - window];
+                s[2] -= col_aa[x - window];
+                s[3] -= col_bb[x - window];
+                s[4] -= col_ab[x - window];
+            }
+            if (x >= window - 1)
+            {
+                const int o = x - window + 1;
+                sa[o] = s[0];
+                sb[o] = s[1];
+                saa[o] = s[2];
+                sbb[o] = s[3];
+                sab[o] = s[4];
+            }
+        }
+
+        // SSIM = (2 µa µb + C1)(2 σab + C2) / ((µa² + µb² + C1)(σa² + σb² + C2)), multiplié en haut et en bas par n⁴ pour rester en entiers jusqu'à la division
+        for (int x{0}; x < out_width; x++)
+        {
+            const int64_t mean_product = sa[x] * sb[x];
+            const int64_t variance_a = n * saa[x] - sa[x] * sa[x];
+            const int64_t variance_b = n * sbb[x] - sb[x] * sb[x];
+            const int64_t covariance = n * sab[x] - mean_product;
+            const double numerator = (2. * static_cast<double>(mean_product) + c1) * (2. * static_cast<double>(covariance) + c2);
+            const double denominator = (static_cast<double>(sa[x] * sa[x] + sb[x] * sb[x]) + c1) * (static_cast<double>(variance_a + variance_b) + c2);
+            row_ssim[x] = numerator / denominator;
+        }
+        for (int x{0}; x < out_width; x++) total += row_ssim[x];
+
+        if (y + window < height)
+        {
+            add_row(y, -1);
+            add_row(y + window, 1);
+        }
+    }
+    return total;
+}
+
+} // namespace
+
+double psnr(const ImageU8& a, const ImageU8& b)
+{
+    return psnr_from_squared_error(squared_error(a, b), a.data().size());
+}
+
+double ssim(const ImageU8& a, const ImageU8& b, int window)
+{
+    const int width = a.width();
+    const int height = a.height();
+    if (width == 0 || height == 0) return 1.;
+    window = std::clamp(std::min({window, width, height}), 1, 16);
+
+    const double windows = static_cast<double>(width - window + 1) * (height - window + 1);
+    double total = 0.;
+    for (int channel{0}; channel < 3; channel++)
+    {
+        total += ssim_channel_sum(channel_plane(a, channel), channel_plane(b, channel), width, height, window) / windows;
+    }
+    return total / 3.;
+}
+
+ImageDifference compare_images(const ImageU8& a, const ImageU8& b)
+{
+    ImageDifference difference;
+    if (a.width() != b.width() || a.height() != b.height())
+    {
+        difference.same_size = false;
+        return difference;
+    }
+
+    for (size_t i{0}; i < a.data().size(); i++)
+    {
+        const int d = std::abs(static_cast<int>(a.data()[i]) - static_cast<int>(b.data()[i]));
+        if (d != 0) difference.differing_values++;
+        difference.max_abs_error = std::max(difference.max_abs_error, d);
+    }
+    difference.psnr = psnr(a, b);
+    difference.ssim = difference.identical() ? 1. : ssim(a, b);
+    return difference;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "image_u8.hpp"
+#include <cstdint>
+
+/**
+ * Écart entre deux images 8 bits, mesuré canal par canal (niveaux de 0 à 255).
+ */
+struct ImageDifference
+{
+    bool same_size{true};
+    int64_t differing_values{0}; // Nombre de canaux différents (0 : images identiques)
+    int max_abs_error{0};        // Plus grand écart sur un canal
+    double psnr{0.};             // Rapport signal sur bruit de crête en dB (infini si les images sont identiques)
+    double ssim{0.};             // Similarité structurelle moyenne, entre -1 et 1 (1 : images identiques)
+
+    bool identical() const { return same_size && differing_values == 0; }
+};
+
+/**
+ * Compare deux images 8 bits : nombre de valeurs différentes, écart maximal, PSNR et SSIM.
+ * Si les tailles diffèrent, seul same_size est renseigné (à false).
+ */
+ImageDifference compare_images(const ImageU8& a, const ImageU8& b);
+
+/**
+ * Rapport signal sur bruit de crête (PSNR) entre deux images de même taille, en dB : 10 log10(255² / erreur quadratique moyenne).
+ * Renvoie l'infini si les images sont identiques.
+ */
+double psnr(const ImageU8& a, const ImageU8& b);
+
+/**
+ * Similarité structurelle (SSIM) entre deux images de même taille, moyenne des trois canaux.
+ * Moyennes, variances et covariance sont calculées sur toutes les fenêtres carrées de `window` pixels de côté (pas de 1 pixel),
+ * par sommes glissantes entières : le coût ne dépend pas de la taille de la fenêtre et les boucles sur les colonnes sont vectorisées par le compilateur.
+ *
+ * @param window Côté des fenêtres, entre 1 et 16 (par défaut 8), réduit si l'image est plus petite.
+ */
+double ssim(const ImageU8& a, const ImageU8& b, int window = 8);
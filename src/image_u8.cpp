@@ -0,0 +1,38 @@
+#include "image_u8.hpp"
+#include <algorithm>
+#include <memory>
+
+ImageU8::ImageU8(int width, int height)
+    : _width{width}
+    , _height{height}
+    , _data(static_cast<size_t>(width) * static_cast<size_t>(height) * 3, 0)
+{
+}
+
+ImageU8::ImageU8(const sil::Image& img)
+    : ImageU8{img.width(), img.height()}
+{
+    for (size_t i{0}; i < img.pixels().size(); i++)
+    {
+        _data[3 * i + 0] = sil::to_8bit(img.pixels()[i].r);
+        _data[3 * i + 1] = sil::to_8bit(img.pixels()[i].g);
+        _data[3 * i + 2] = sil::to_8bit(img.pixels()[i].b);
+    }
+}
+
+sil::Image ImageU8::to_image() const
+{
+    sil::Image img{_width, _height};
+    for (size_t i{0}; i < img.pixels().size(); i++)
+    {
+        img.pixels()[i] = glm::vec3{_data[3 * i + 0], _data[3 * i + 1], _data[3 * i + 2]} / 255.f;
+    }
+    return img;
+}
+
+void ImageU8::save(std::filesystem::path path) const
+{
+    auto data = std::make_unique<uint8_t[]>(_data.size());
+    std::copy(_data.begin(), _data.end(), data.get());
+    sil::save_rgb8(std::move(path), _width, _height, std::move(data));
+}
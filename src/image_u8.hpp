@@ -0,0 +1,44 @@
+#pragma once
+#include <sil/sil.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+/**
+ * Image 8 bits par canal (RGB entrelacé : 3 octets par pixel), stockée ligne par ligne de gauche à droite et de bas en haut, comme sil::Image.
+ * Quatre fois plus compacte qu'une sil::Image, elle sert aux filtres qui travaillent directement sur des entiers.
+ * La conversion depuis et vers sil::Image utilise la même quantification que Image::save(), donc un aller-retour ne change pas l'image enregistrée.
+ */
+class ImageU8
+{
+public:
+    /// Crée une image noire de la taille donnée.
+    ImageU8(int width, int height);
+    /// Quantifie une image flottante en 8 bits.
+    explicit ImageU8(const sil::Image& img);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    /// Renvoie le premier octet de la ligne y (3 * width() octets).
+    uint8_t* row(int y) { return _data.data() + static_cast<size_t>(y) * _width * 3; }
+    uint8_t const* row(int y) const { return _data.data() + static_cast<size_t>(y) * _width * 3; }
+
+    /// Renvoie la valeur du canal `channel` (0 = R, 1 = G, 2 = B) du pixel (x, y).
+    uint8_t& at(int x, int y, int channel) { return _data[(x + static_cast<size_t>(y) * _width) * 3 + channel]; }
+    uint8_t at(int x, int y, int channel) const { return _data[(x + static_cast<size_t>(y) * _width) * 3 + channel]; }
+
+    std::vector<uint8_t>& data() { return _data; }
+    std::vector<uint8_t> const& data() const { return _data; }
+
+    /// Convertit en image flottante (chaque canal divisé par 255, comme au chargement d'un fichier).
+    sil::Image to_image() const;
+
+    /// Enregistre l'image en png ou jpeg, sans conversion.
+    void save(std::filesystem::path path) const;
+
+private:
+    int _width;
+    int _height;
+    std::vector<uint8_t> _data;
+};
@@ -0,0 +1,294 @@
+#include "job_pool.hpp"
+#include "parallel.hpp"
+#include <sil/metrics.hpp>
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+/**
+ * État partagé entre un JobHandle et le thread qui exécute le traitement.
+ * Le statut passe de Queued à Running par le thread qui prend le traitement, ou de Queued à Cancelled par cancel() :
+ * celui qui réussit cette transition est le seul à pouvoir lancer le traitement ou à le terminer sans l'avoir lancé.
+ */
+struct JobState : BandObserver
+{
+    JobState(JobPool& pool, sil::Image image, std::vector<std::function<void(sil::Image&)>> steps, JobOptions options)
+        : pool{pool}
+        , image{std::move(image)}
+        , steps{std::move(steps)}
+        , options{std::move(options)}
+    {
+    }
+
+    void before_tile() override
+    {
+        // Les traitements plus prioritaires en attente passent d'abord, sur ce thread (et sur ceux des autres bandes qui en trouvent)
+        while (std::shared_ptr<JobState> job = pool.take_higher_than(options.priority))
+        {
+            pool.execute(job);
+        }
+        if (cancelled.load(std::memory_order_relaxed)) throw JobCancelled{};
+    }
+
+    void tile_done(int rows, int total) override
+    {
+        std::lock_guard lock{progress_mutex};
+        // Un nouvel appel de parallel_for_bands (autre passe de l'effet) commence quand le précédent est terminé ou n'a pas la même taille
+        if (total != section_total || section_rows >= section_total)
+        {
+            section_total = total;
+            section_rows = 0;
+        }
+        section_rows += rows;
+        // La progression ne recule jamais, et n'atteint 1 qu'une fois l'étape terminée
+        step_fraction = std::max(step_fraction, std::min(static_cast<float>(section_rows) / static_cast<float>(section_total), 0.99f));
+        report((static_cast<float>(step) + step_fraction) / static_cast<float>(steps.size()));
+    }
+
+    /// Passe à l'étape suivante de la chaîne d'effets.
+    void step_done()
+    {
+        std::lock_guard lock{progress_mutex};
+        step++;
+        step_fraction = 0.f;
+        section_total = 0;
+        section_rows = 0;
+        report(static_cast<float>(step) / static_cast<float>(steps.size()));
+    }
+
+    /// À appeler avec progress_mutex verrouillé.
+    void report(float value)
+    {
+        progress.store(value, std::memory_order_relaxed);
+        if (options.on_progress && (value >= reported + 0.01f || (value >= 1.f && reported < 1.f)))
+        {
+            reported = value;
+            options.on_progress(value);
+        }
+    }
+
+    JobPool& pool;
+    const std::chrono::steady_clock::time_point submitted{std::chrono::steady_clock::now()};
+    sil::Image image;
+    std::vector<std::function<void(sil::Image&)>> steps;
+    JobOptions options;
+    std::promise<sil::Image> result;
+
+    std::atomic<JobStatus> status{JobStatus::Queued};
+    std::atomic<bool> cancelled{false};
+    std::atomic<float> progress{0.f};
+
+    std::mutex progress_mutex;
+    int step{0};
+    float step_fraction{0.f};
+    int section_total{0};
+    int section_rows{0};
+    float reported{0.f};
+};
+
+namespace {
+
+/// Métriques exportées par sil::MetricsExporter, par priorité et communes à tous les JobPool du processus.
+struct PriorityMetrics
+{
+    sil::Gauge& queue_depth;            // Traitements en attente (y compris ceux annulés pas encore retirés de la file)
+    sil::LatencyHistogram& job_seconds; // Durée des traitements réussis, attente dans la file comprise
+};
+
+PriorityMetrics& priority_metrics(JobPriority priority)
+{
+    static PriorityMetrics metrics[] = {
+        {sil::metrics_gauge("image_editor_job_queue_depth", "priority=\"interactive\""), sil::metrics_histogram("image_editor_job_seconds", "priority=\"interactive\"")},
+        {sil::metrics_gauge("image_editor_job_queue_depth", "priority=\"normal\""), sil::metrics_histogram("image_editor_job_seconds", "priority=\"normal\"")},
+        {sil::metrics_gauge("image_editor_job_queue_depth", "priority=\"batch\""), sil::metrics_histogram("image_editor_job_seconds", "priority=\"batch\"")},
+    };
+    return metrics[static_cast<int>(priority)];
+}
+
+/// Termine un traitement qui n'a pas été lancé (voir JobState).
+void resolve_cancelled(JobState& job)
+{
+    job.result.set_exception(std::make_exception_ptr(JobCancelled{}));
+}
+
+/// Prend le traitement s'il est encore en attente.
+bool try_start(JobState& job)
+{
+    JobStatus expected = JobStatus::Queued;
+    return job.status.compare_exchange_strong(expected, JobStatus::Running);
+}
+
+} // namespace
+
+JobHandle::JobHandle(std::shared_ptr<JobState> state, std::future<sil::Image> result)
+    : _state{std::move(state)}
+    , _result{std::move(result)}
+{
+}
+
+void JobHandle::cancel()
+{
+    _state->cancelled.store(true, std::memory_order_relaxed);
+    // Un traitement en attente est terminé tout de suite ; le pool l'ignorera quand il arrivera en tête de file
+    JobStatus expected = JobStatus::Queued;
+    if (_state->status.compare_exchange_strong(expected, JobStatus::Cancelled)) resolve_cancelled(*_state);
+}
+
+float JobHandle::progress() const
+{
+    return _state->progress.load(std::memory_order_relaxed);
+}
+
+JobStatus JobHandle::status() const
+{
+    return _state->status.load();
+}
+
+JobPool::JobPool(int workers)
+{
+    const int count = workers > 0 ? workers : thread_count();
+    _workers.reserve(count);
+    for (int i{0}; i < count; i++)
+    {
+        _workers.emplace_back([this]() { work(); });
+    }
+}
+
+JobPool::~JobPool()
+{
+    std::deque<std::shared_ptr<JobState>> queued;
+    {
+        std::lock_guard lock{_mutex};
+        _closing = true;
+        for (int i{0}; i < 3; i++)
+        {
+            priority_metrics(static_cast<JobPriority>(i)).queue_depth.add(-static_cast<int64_t>(_queues[i].size()));
+            queued.insert(queued.end(), _queues[i].begin(), _queues[i].end());
+            _queues[i].clear();
+        }
+    }
+    _queue_changed.notify_all();
+
+    for (const std::shared_ptr<JobState>& job : queued)
+    {
+        job->cancelled.store(true, std::memory_order_relaxed);
+        JobStatus expected = JobStatus::Queued;
+        if (job->status.compare_exchange_strong(expected, JobStatus::Cancelled)) resolve_cancelled(*job);
+    }
+    for (std::thread& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+JobHandle JobPool::submit(sil::Image image, std::function<void(sil::Image&)> effect, JobOptions options)
+{
+    return enqueue(std::move(image), {std::move(effect)}, std::move(options));
+}
+
+JobHandle JobPool::submit(sil::Image image, const EffectChain& chain, JobOptions options)
+{
+    return enqueue(std::move(image), chain.steps(), std::move(options));
+}
+
+size_t JobPool::pending() const
+{
+    std::lock_guard lock{_mutex};
+    size_t count = 0;
+    for (const std::deque<std::shared_ptr<JobState>>& queue : _queues)
+    {
+        count += static_cast<size_t>(std::count_if(queue.begin(), queue.end(), [](const std::shared_ptr<JobState>& job) {
+            return job->status.load() == JobStatus::Queued;
+        }));
+    }
+    return count;
+}
+
+JobHandle JobPool::enqueue(sil::Image image, std::vector<std::function<void(sil::Image&)>> steps, JobOptions options)
+{
+    const auto job = std::make_shared<JobState>(*this, std::move(image), std::move(steps), std::move(options));
+    JobHandle handle{job, job->result.get_future()};
+    {
+        std::lock_guard lock{_mutex};
+        if (_closing) throw std::runtime_error{"Le pool de traitements est en cours d'arrêt"};
+        _queues[static_cast<int>(job->options.priority)].push_back(job);
+        priority_metrics(job->options.priority).queue_depth.add(1);
+    }
+    _queue_changed.notify_one();
+    return handle;
+}
+
+void JobPool::work()
+{
+    while (true)
+    {
+        std::shared_ptr<JobState> job;
+        {
+            std::unique_lock lock{_mutex};
+            _queue_changed.wait(lock, [&]() {
+                return _closing || std::any_of(std::begin(_queues), std::end(_queues), [](const auto& queue) { return !queue.empty(); });
+            });
+            if (_closing) return;
+            for (std::deque<std::shared_ptr<JobState>>& queue : _queues)
+            {
+                if (queue.empty()) continue;
+                job = std::move(queue.front());
+                queue.pop_front();
+                break;
+            }
+            priority_metrics(job->options.priority).queue_depth.add(-1);
+        }
+        if (try_start(*job)) execute(job);
+    }
+}
+
+std::shared_ptr<JobState> JobPool::take_higher_than(JobPriority priority)
+{
+    std::lock_guard lock{_mutex};
+    for (int i{0}; i < static_cast<int>(priority); i++)
+    {
+        while (!_queues[i].empty())
+        {
+            std::shared_ptr<JobState> job = std::move(_queues[i].front());
+            _queues[i].pop_front();
+            priority_metrics(job->options.priority).queue_depth.add(-1);
+            if (try_start(*job)) return job; // Les traitements annulés en attente sont simplement retirés
+        }
+    }
+    return nullptr;
+}
+
+void JobPool::execute(const std::shared_ptr<JobState>& job)
+{
+    SIL_TRACE_SCOPE("job");
+    // Un traitement exécuté à l'intérieur d'un autre (préemption) rend ensuite la main à l'observateur de celui-ci
+    BandObserver* previous = std::exchange(current_band_observer(), job.get());
+    try
+    {
+        for (size_t i{0}; i < job->steps.size(); i++)
+        {
+            if (job->cancelled.load(std::memory_order_relaxed)) throw JobCancelled{};
+            job->steps[i](job->image);
+            job->step_done();
+        }
+        {
+            std::lock_guard lock{job->progress_mutex};
+            job->report(1.f); // Pour une chaîne vide
+        }
+        priority_metrics(job->options.priority).job_seconds.record(std::chrono::steady_clock::now() - job->submitted);
+        job->status = JobStatus::Finished;
+        job->result.set_value(std::move(job->image));
+    }
+    catch (const JobCancelled&)
+    {
+        job->status = JobStatus::Cancelled;
+        job->result.set_exception(std::current_exception());
+    }
+    catch (...)
+    {
+        job->status = JobStatus::Failed;
+        job->result.set_exception(std::current_exception());
+    }
+    job->image = sil::Image{0, 0}; // Libère l'image d'entrée d'un traitement interrompu
+    current_band_observer() = previous;
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <sil/sil.hpp>
+#include "effect_chain.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/**
+ * Classe de priorité d'un traitement. Un traitement plus prioritaire passe devant dans la file,
+ * et prend la main sur un traitement moins prioritaire déjà lancé à la fin de la tuile en cours (voir JobPool).
+ */
+enum class JobPriority
+{
+    Interactive, // Aperçus, réponses à l'utilisateur
+    Normal,
+    Batch        // Lots d'images en arrière-plan
+};
+
+enum class JobStatus
+{
+    Queued,
+    Running,
+    Finished,
+    Cancelled,
+    Failed
+};
+
+/// Exception renvoyée par JobHandle::get() quand le traitement a été annulé.
+class JobCancelled : public std::runtime_error
+{
+public:
+    JobCancelled()
+        : std::runtime_error{"Traitement annulé"}
+    {
+    }
+};
+
+struct JobOptions
+{
+    JobPriority priority{JobPriority::Normal};
+    /// Appelée quand la progression (entre 0 et 1) avance d'au moins 1 %, depuis les threads du traitement (jamais deux appels en même temps).
+    std::function<void(float)> on_progress;
+};
+
+struct JobState;
+
+/**
+ * Traitement lancé par JobPool::submit() : son résultat s'obtient comme celui d'un std::future, et il peut être annulé à tout moment.
+ */
+class JobHandle
+{
+public:
+    JobHandle(std::shared_ptr<JobState> state, std::future<sil::Image> result);
+
+    /// Attend la fin du traitement et renvoie l'image. Lance JobCancelled s'il a été annulé, ou l'exception lancée par l'effet. Un seul appel possible.
+    sil::Image get() { return _result.get(); }
+
+    void wait() const { _result.wait(); }
+    /// Renvoie true si le traitement est terminé avant `timeout` (réussi, annulé ou en erreur).
+    bool wait_for(std::chrono::milliseconds timeout) const { return _result.wait_for(timeout) == std::future_status::ready; }
+
+    /**
+     * Demande l'annulation. Un traitement en attente ne sera pas lancé ; un traitement en cours s'arrête à la fin de sa tuile
+     * (effets qui utilisent parallel_for_bands) ou de l'étape en cours de sa chaîne d'effets (autres effets).
+     */
+    void cancel();
+
+    /// Progression entre 0 et 1 (approximative pour les effets en plusieurs passes : elle suit la passe la plus avancée).
+    float progress() const;
+
+    JobStatus status() const;
+
+private:
+    std::shared_ptr<JobState> _state;
+    std::future<sil::Image> _result;
+};
+
+/**
+ * Threads qui exécutent des effets de façon asynchrone, avec annulation, progression et priorités.
+ * Pendant un traitement, parallel_for_bands découpe chaque bande en tuiles et, entre deux tuiles, vérifie l'annulation, fait avancer
+ * la progression, et exécute sur place les traitements plus prioritaires en attente : un aperçu interactif n'attend pas la fin d'un lot
+ * (mais seulement la fin d'une tuile), sans thread supplémentaire ni interruption forcée.
+ * Les effets qui n'utilisent pas parallel_for_bands ne sont interrompus qu'entre deux étapes d'une chaîne d'effets.
+ */
+class JobPool
+{
+public:
+    /// @param workers Nombre de threads (par défaut 0 : thread_count()).
+    explicit JobPool(int workers = 0);
+    /// Annule les traitements en attente et attend la fin de ceux en cours.
+    ~JobPool();
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    /**
+     * Lance un effet quelconque sur une image.
+     *
+     * @param image Image d'entrée (le résultat est renvoyé par JobHandle::get()).
+     * @param effect Effet à appliquer en place, par exemple [](sil::Image& img) { kuwahara(img, 12); }.
+     */
+    JobHandle submit(sil::Image image, std::function<void(sil::Image&)> effect, JobOptions options = {});
+
+    /// Lance une chaîne d'effets (voir effect_chain.hpp) : l'annulation est aussi vérifiée entre deux étapes.
+    JobHandle submit(sil::Image image, const EffectChain& chain, JobOptions options = {});
+
+    /// Nombre de traitements en attente.
+    size_t pending() const;
+
+private:
+    friend struct JobState;
+
+    JobHandle enqueue(sil::Image image, std::vector<std::function<void(sil::Image&)>> steps, JobOptions options);
+    void work();
+    /// Exécute un traitement sur le thread courant.
+    void execute(const std::shared_ptr<JobState>& job);
+    /// Retire le prochain traitement strictement plus prioritaire que `priority` (nullptr s'il n'y en a pas).
+    std::shared_ptr<JobState> take_higher_than(JobPriority priority);
+
+    mutable std::mutex _mutex;
+    std::condition_variable _queue_changed;
+    std::deque<std::shared_ptr<JobState>> _queues[3]; // Une file par JobPriority
+    bool _closing{false};
+    std::vector<std::thread> _workers;
+};
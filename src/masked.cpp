@@ -0,0 +1,137 @@
+#include "masked.hpp"
+#include <sil/trace.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+MaskTiles::MaskTiles(const sil::Image& mask, int tile_size)
+    : _width{mask.width()}
+    , _height{mask.height()}
+    , _tile_size{std::max(tile_size, 1)}
+    , _tiles_x{(mask.width() + _tile_size - 1) / _tile_size}
+    , _tiles_y{(mask.height() + _tile_size - 1) / _tile_size}
+    , _weights(mask.pixels().size())
+    , _tiles(static_cast<size_t>(_tiles_x) * _tiles_y)
+{
+    for (size_t i{0}; i < _weights.size(); i++)
+    {
+        const glm::vec3& c = mask.pixels()[i];
+        _weights[i] = std::clamp((c.r + c.g + c.b) / 3.f, 0.f, 1.f);
+    }
+
+    for (int ty{0}; ty < _tiles_y; ty++)
+    {
+        for (int tx{0}; tx < _tiles_x; tx++)
+        {
+            float min_weight = 1.f;
+            float max_weight = 0.f;
+            for (int y{ty * _tile_size}; y < std::min((ty + 1) * _tile_size, _height); y++)
+            {
+                for (int x{tx * _tile_size}; x < std::min((tx + 1) * _tile_size, _width); x++)
+                {
+                    min_weight = std::min(min_weight, weight(x, y));
+                    max_weight = std::max(max_weight, weight(x, y));
+                }
+            }
+
+            TileCoverage coverage = TileCoverage::Partial;
+            if (max_weight <= 0.f) coverage = TileCoverage::Empty;
+            else if (min_weight >= 1.f) coverage = TileCoverage::Full;
+            _tiles[tx + ty * _tiles_x] = coverage;
+        }
+    }
+}
+
+namespace {
+
+/**
+ * Résultat de l'effet sur une région, en attente d'être recopié dans l'image.
+ */
+struct ProcessedRegion
+{
+    sil::Image pixels;
+    int x0;         // Position de la région (marge comprise) dans l'image
+    int y0;
+    int first_tile; // Tuiles [first_tile, end_tile) de la ligne de tuiles tile_y couvertes par la région
+    int end_tile;
+    int tile_y;
+};
+
+} // namespace
+
+void apply_masked(sil::Image& img, const MaskTiles& mask, const std::function<void(sil::Image&)>& effect, int margin)
+{
+    SIL_TRACE_SCOPE("apply_masked");
+    if (img.width() != mask.width() || img.height() != mask.height()) throw std::invalid_argument{"Le masque n'a pas la taille de l'image"};
+
+    const int tile = mask.tile_size();
+    margin = std::max(margin, 0);
+
+    // Les résultats ne sont recopiés qu'à la fin, pour que les marges des régions suivantes lisent toujours l'image d'origine
+    std::vector<ProcessedRegion> processed;
+
+    for (int ty{0}; ty < mask.tiles_y(); ty++)
+    {
+        int tx{0};
+        while (tx < mask.tiles_x())
+        {
+            if (mask.coverage(tx, ty) == TileCoverage::Empty)
+            {
+                tx++;
+                continue;
+            }
+
+            // Regroupe les tuiles non vides consécutives en une seule région
+            const int first_tile = tx;
+            while (tx < mask.tiles_x() && mask.coverage(tx, ty) != TileCoverage::Empty) tx++;
+
+            // Région agrandie de la marge (sans sortir de l'image)
+            const int x0 = std::max(first_tile * tile - margin, 0);
+            const int x1 = std::min(tx * tile + margin, img.width());
+            const int y0 = std::max(ty * tile - margin, 0);
+            const int y1 = std::min((ty + 1) * tile + margin, img.height());
+
+            sil::Image region{x1 - x0, y1 - y0};
+            for (int y{y0}; y < y1; y++)
+            {
+                std::copy_n(img.pixels().begin() + (x0 + static_cast<size_t>(y) * img.width()), x1 - x0,
+                            region.pixels().begin() + static_cast<size_t>(y - y0) * region.width());
+            }
+
+            effect(region);
+            // Rien n'a encore été recopié : l'image reste intacte
+            if (region.width() != x1 - x0 || region.height() != y1 - y0) throw std::invalid_argument{"L'effet appliqué par apply_masked a changé la taille de l'image"};
+
+            processed.push_back(ProcessedRegion{std::move(region), x0, y0, first_tile, tx, ty});
+        }
+    }
+
+    for (const ProcessedRegion& region : processed)
+    {
+        const int y_begin = region.tile_y * tile;
+        const int y_end = std::min(y_begin + tile, img.height());
+
+        for (int t{region.first_tile}; t < region.end_tile; t++)
+        {
+            const int x_begin = t * tile;
+            const int x_end = std::min(x_begin + tile, img.width());
+
+            if (mask.coverage(t, region.tile_y) == TileCoverage::Full)
+            {
+                // Tuile entièrement dans le masque : copie directe des lignes, sans mélange
+                for (int y{y_begin}; y < y_end; y++)
+                {
+                    std::copy_n(&region.pixels.pixel(x_begin - region.x0, y - region.y0), x_end - x_begin, &img.pixel(x_begin, y));
+                }
+                continue;
+            }
+
+            for (int y{y_begin}; y < y_end; y++)
+            {
+                for (int x{x_begin}; x < x_end; x++)
+                {
+                    img.pixel(x, y) = glm::mix(img.pixel(x, y), region.pixels.pixel(x - region.x0, y - region.y0), mask.weight(x, y));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <sil/sil.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+enum class TileCoverage : uint8_t
+{
+    Empty,  // Aucun pixel du masque dans la tuile : l'effet n'y est pas calculé
+    Full,   // Tous les pixels sont entièrement dans le masque : le résultat de l'effet est recopié tel quel
+    Partial // Mélange pixel par pixel entre l'image d'origine et le résultat de l'effet
+};
+
+/**
+ * Masque résumé par tuiles carrées : chaque tuile est marquée vide, pleine ou partielle,
+ * ce qui permet de ne calculer un effet que là où le masque l'utilise.
+ * Le poids d'un pixel est la moyenne de ses composantes R, G et B (0 = hors du masque, 1 = dans le masque).
+ */
+class MaskTiles
+{
+public:
+    explicit MaskTiles(const sil::Image& mask, int tile_size = 32);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+    int tile_size() const { return _tile_size; }
+    int tiles_x() const { return _tiles_x; }
+    int tiles_y() const { return _tiles_y; }
+
+    TileCoverage coverage(int tile_x, int tile_y) const { return _tiles[tile_x + tile_y * _tiles_x]; }
+    float weight(int x, int y) const { return _weights[x + static_cast<size_t>(y) * _width]; }
+
+private:
+    int _width;
+    int _height;
+    int _tile_size;
+    int _tiles_x;
+    int _tiles_y;
+    std::vector<float> _weights;
+    std::vector<TileCoverage> _tiles;
+};
+
+/**
+ * Applique un effet uniquement à l'intérieur d'un masque.
+ * Sur chaque ligne de tuiles, les tuiles non vides consécutives sont regroupées en une région (agrandie de `margin` pixels de chaque côté
+ * pour que les effets de voisinage voient les mêmes voisins que sur l'image entière), et l'effet n'est appliqué qu'à ces régions.
+ * L'effet ne doit pas changer la taille de l'image ni dépendre de la position absolue des pixels.
+ * Lance std::invalid_argument, sans modifier l'image, si le masque n'a pas la taille de l'image ou si l'effet change la taille d'une région.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param mask Masque résumé par tuiles, de la même taille que l'image.
+ * @param effect Effet à appliquer, par exemple [](sil::Image& region) { blur_convolution(region, 15); }.
+ * @param margin Rayon de voisinage utilisé par l'effet (par défaut 0, pour les effets pixel par pixel).
+ */
+void apply_masked(sil::Image& img, const MaskTiles& mask, const std::function<void(sil::Image&)>& effect, int margin = 0);
@@ -0,0 +1,279 @@
+#include "median.hpp"
+#include <sil/metrics.hpp>
+#include <sil/trace.hpp>
+#include "parallel.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MEDIAN_USE_SSE2 1
+#else
+#define MEDIAN_USE_SSE2 0
+#endif
+
+namespace {
+
+inline void sort2(uint8_t& a, uint8_t& b)
+{
+    const uint8_t low = std::min(a, b);
+    b = std::max(a, b);
+    a = low;
+}
+
+#if MEDIAN_USE_SSE2
+// 16 octets à la fois : chaque octet est un canal d'un pixel différent
+inline void sort2(__m128i& a, __m128i& b)
+{
+    const __m128i low = _mm_min_epu8(a, b);
+    b = _mm_max_epu8(a, b);
+    a = low;
+}
+#endif
+
+/**
+ * Médiane de N valeurs (N impair) par sélection « oublieuse » : on garde N / 2 + 2 valeurs, on retire la plus petite et la plus grande,
+ * on ajoute la valeur suivante, et ainsi de suite jusqu'à ce qu'il n'en reste que 3.
+ * Les valeurs retirées ne peuvent pas être la médiane, et l'algorithme n'utilise que des min / max : il s'applique donc aussi bien à des octets qu'à des registres SIMD.
+ * Le tableau v est modifié.
+ */
+template<int N, typename V>
+V forgetful_median(V* v)
+{
+    constexpr int kept = N / 2 + 2;
+    const int last = kept - 1;
+    int begin = 0;
+
+    for (int next{kept}; next < N; next++, begin++)
+    {
+        // Place le minimum en v[begin] et le maximum en v[last]
+        for (int i{begin + 1}; i <= last; i++) sort2(v[begin], v[i]);
+        for (int i{begin + 1}; i < last; i++) sort2(v[i], v[last]);
+        // Le minimum est oublié en avançant begin, le maximum est remplacé par la valeur suivante
+        v[last] = v[next];
+    }
+
+    // Médiane des 3 valeurs restantes
+    sort2(v[begin], v[begin + 1]);
+    sort2(v[begin + 1], v[begin + 2]);
+    sort2(v[begin], v[begin + 1]);
+    return v[begin + 1];
+}
+
+/**
+ * Filtre médian 3x3 ou 5x5 par réseau de comparaisons.
+ * Les lignes sources sont prolongées de `radius` pixels de chaque côté, si bien que les voisins d'un octet sont simplement aux décalages ±3 octets (pixel voisin, même canal) :
+ * le réseau traite 16 octets consécutifs d'une ligne à la fois sans se soucier des canaux.
+ */
+template<int radius>
+void median_network(const ImageU8& src, ImageU8& dst)
+{
+    SIL_TRACE_SCOPE("median_network");
+    constexpr int size = 2 * radius + 1;
+    constexpr int N = size * size;
+    const int w = src.width();
+    const int h = src.height();
+    const int row_bytes = 3 * w;
+    const int padded_bytes = 3 * (w + 2 * radius);
+
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        // `size` lignes prolongées, rangées dans l'emplacement (ligne % size)
+        std::vector<uint8_t> rows(static_cast<size_t>(size) * padded_bytes);
+        int slot_row[size];
+        std::fill(slot_row, slot_row + size, -1);
+
+        auto padded_row = [&](int sy) -> const uint8_t* {
+            uint8_t* row = rows.data() + static_cast<size_t>(sy % size) * padded_bytes;
+            if (slot_row[sy % size] != sy)
+            {
+                const uint8_t* in = src.row(sy);
+                for (int i{0}; i < radius; i++)
+                {
+                    std::copy_n(in, 3, row + 3 * i);
+                    std::copy_n(in + row_bytes - 3, 3, row + 3 * (radius + w + i));
+                }
+                std::copy_n(in, row_bytes, row + 3 * radius);
+                slot_row[sy % size] = sy;
+            }
+            return row;
+        };
+
+        const uint8_t* window_rows[size];
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            for (int dy{0}; dy < size; dy++)
+            {
+                window_rows[dy] = padded_row(std::clamp(y + dy - radius, 0, h - 1));
+            }
+            uint8_t* out = dst.row(y);
+
+            int i{0};
+#if MEDIAN_USE_SSE2
+            for (; i + 16 <= row_bytes; i += 16)
+            {
+                __m128i v[N];
+                for (int dy{0}; dy < size; dy++)
+                {
+                    for (int dx{0}; dx < size; dx++)
+                    {
+                        v[dy * size + dx] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(window_rows[dy] + i + 3 * dx));
+                    }
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), forgetful_median<N>(v));
+            }
+#endif
+            for (; i < row_bytes; i++)
+            {
+                uint8_t v[N];
+                for (int dy{0}; dy < size; dy++)
+                {
+                    for (int dx{0}; dx < size; dx++)
+                    {
+                        v[dy * size + dx] = window_rows[dy][i + 3 * dx];
+                    }
+                }
+                out[i] = forgetful_median<N>(v);
+            }
+        }
+    });
+}
+
+/**
+ * Filtre médian de Perreault et Hébert, en temps constant par pixel quel que soit le rayon.
+ * Chaque colonne garde l'histogramme de ses 2 * radius + 1 pixels autour de la ligne courante (mis à jour en retirant une ligne et en ajoutant une autre),
+ * et l'histogramme de la fenêtre glisse le long de la ligne en ajoutant une colonne et en retirant une autre.
+ * Chaque histogramme a deux niveaux (16 cases grossières + 256 cases fines) pour trouver la médiane en parcourant au plus 32 cases.
+ */
+void median_histogram(const ImageU8& src, ImageU8& dst, int radius)
+{
+    SIL_TRACE_SCOPE("median_histogram");
+    const int w = src.width();
+    const int h = src.height();
+    const int size = 2 * radius + 1;
+    const int rank = size * size / 2 + 1; // Rang de la médiane (à partir de 1)
+
+    parallel_for_bands(0, h, [&](int y_begin, int y_end) {
+        // Histogrammes de colonne : [x][canal][case]
+        std::vector<uint16_t> column_fine(static_cast<size_t>(w) * 3 * 256, 0);
+        std::vector<uint16_t> column_coarse(static_cast<size_t>(w) * 3 * 16, 0);
+
+        auto update_column = [&](int x, int sy, bool add) {
+            for (int c{0}; c < 3; c++)
+            {
+                const uint8_t v = src.at(x, sy, c);
+                const size_t column = static_cast<size_t>(x) * 3 + c;
+                if (add)
+                {
+                    column_fine[column * 256 + v]++;
+                    column_coarse[column * 16 + (v >> 4)]++;
+                }
+                else
+                {
+                    column_fine[column * 256 + v]--;
+                    column_coarse[column * 16 + (v >> 4)]--;
+                }
+            }
+        };
+
+        for (int x{0}; x < w; x++)
+        {
+            for (int dy{-radius}; dy <= radius; dy++)
+            {
+                update_column(x, std::clamp(y_begin + dy, 0, h - 1), true);
+            }
+        }
+
+        // Histogrammes de la fenêtre : [canal][case]
+        std::vector<uint16_t> kernel_fine(3 * 256);
+        std::vector<uint16_t> kernel_coarse(3 * 16);
+
+        auto update_kernel = [&](int x, bool add) {
+            const uint16_t* fine = column_fine.data() + static_cast<size_t>(x) * 3 * 256;
+            const uint16_t* coarse = column_coarse.data() + static_cast<size_t>(x) * 3 * 16;
+            if (add)
+            {
+                for (int i{0}; i < 3 * 256; i++) kernel_fine[i] += fine[i];
+                for (int i{0}; i < 3 * 16; i++) kernel_coarse[i] += coarse[i];
+            }
+            else
+            {
+                for (int i{0}; i < 3 * 256; i++) kernel_fine[i] -= fine[i];
+                for (int i{0}; i < 3 * 16; i++) kernel_coarse[i] -= coarse[i];
+            }
+        };
+
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            if (y > y_begin)
+            {
+                for (int x{0}; x < w; x++)
+                {
+                    update_column(x, std::clamp(y - radius - 1, 0, h - 1), false);
+                    update_column(x, std::clamp(y + radius, 0, h - 1), true);
+                }
+            }
+
+            std::fill(kernel_fine.begin(), kernel_fine.end(), 0);
+            std::fill(kernel_coarse.begin(), kernel_coarse.end(), 0);
+            for (int dx{-radius}; dx <= radius; dx++)
+            {
+                update_kernel(std::clamp(dx, 0, w - 1), true);
+            }
+
+            for (int x{0}; x < w; x++)
+            {
+                if (x > 0)
+                {
+                    update_kernel(std::clamp(x - radius - 1, 0, w - 1), false);
+                    update_kernel(std::clamp(x + radius, 0, w - 1), true);
+                }
+
+                for (int c{0}; c < 3; c++)
+                {
+                    const uint16_t* coarse = kernel_coarse.data() + c * 16;
+                    const uint16_t* fine = kernel_fine.data() + c * 256;
+                    int sum = 0;
+                    int bucket = 0;
+                    while (sum + coarse[bucket] < rank) sum += coarse[bucket++];
+                    int value = bucket * 16;
+                    while (sum + fine[value] < rank) sum += fine[value++];
+                    dst.at(x, y, c) = static_cast<uint8_t>(value);
+                }
+            }
+        }
+    });
+}
+
+/// median_filter sur une image 8 bits, sans métriques : la version flottante l'appelle sans compter l'effet deux fois.
+void filter(ImageU8& img, int radius)
+{
+    if (radius <= 0) return;
+    radius = std::min(radius, 127); // Les histogrammes comptent sur 16 bits : (2 * 127 + 1)² < 65536
+
+    const ImageU8 original = img;
+    if (radius == 1)
+        median_network<1>(original, img);
+    else if (radius == 2)
+        median_network<2>(original, img);
+    else
+        median_histogram(original, img, radius);
+}
+
+} // namespace
+
+void median_filter(ImageU8& img, int radius)
+{
+    SIL_TRACE_SCOPE("median_filter");
+    SIL_EFFECT_METRICS("median_filter", img.width() * img.height());
+    filter(img, radius);
+}
+
+void median_filter(sil::Image& img, int radius)
+{
+    SIL_TRACE_SCOPE("median_filter");
+    SIL_EFFECT_METRICS("median_filter", img.width() * img.height());
+    ImageU8 quantized{img};
+    filter(quantized, radius);
+    img = quantized.to_image();
+}
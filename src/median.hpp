@@ -0,0 +1,23 @@
+#pragma once
+#include <sil/sil.hpp>
+#include "image_u8.hpp"
+
+/**
+ * Applique un filtre médian : chaque canal de chaque pixel est remplacé par la médiane des valeurs de ce canal dans le carré (2 * radius + 1)² qui l'entoure.
+ * C'est le filtre naturel pour retirer le bruit ajouté par noisy(), sans flouter les bords comme un flou moyen.
+ * Les rayons 1 et 2 (3x3 et 5x5) utilisent un réseau de comparaisons appliqué à 16 octets à la fois,
+ * les rayons plus grands l'algorithme de Perreault et Hébert, dont le coût ne dépend pas du rayon (histogrammes par colonne mis à jour incrémentalement).
+ * Les bords de l'image sont prolongés (les pixels hors de l'image prennent la valeur du bord le plus proche).
+ *
+ * @param img Image à modifier (type ImageU8), modifiée en place.
+ * @param radius Rayon du filtre, entre 1 et 127 (par défaut 1).
+ */
+void median_filter(ImageU8& img, int radius = 1);
+
+/**
+ * Applique un filtre médian à une image flottante, quantifiée en 8 bits (même quantification que Image::save()) pendant le filtrage.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param radius Rayon du filtre, entre 1 et 127 (par défaut 1).
+ */
+void median_filter(sil::Image& img, int radius = 1);
@@ -0,0 +1,365 @@
+#include "morphology.hpp"
+#include <sil/metrics.hpp>
+#include <sil/trace.hpp>
+#include "parallel.hpp"
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace {
+
+/**
+ * Van Herk / Gil-Werman sur une ligne de n valeurs : out[x] = op des valeurs in[x - anchor .. x - anchor + size - 1].
+ * La ligne est prolongée par `neutral` puis découpée en blocs de `size` valeurs ; `forward` garde le cumul depuis le début de chaque bloc,
+ * `backward` le cumul jusqu'à la fin. Une fenêtre de `size` valeurs recouvre au plus deux blocs : son résultat est op(backward[début], forward[fin]).
+ * `stride` est l'écart entre deux valeurs consécutives de la ligne, `forward` et `backward` sont des tampons réutilisés d'une ligne à l'autre.
+ */
+template<typename T, typename Op>
+void vhgw_line(T* line, size_t stride, int n, int size, int anchor, Op op, T neutral, std::vector<T>& forward, std::vector<T>& backward)
+{
+    const int padded = (n + 2 * (size - 1)) / size * size;
+    forward.resize(padded);
+    backward.resize(padded);
+
+    auto value = [&](int i) { return (i >= anchor && i - anchor < n) ? line[(i - anchor) * stride] : neutral; };
+
+    for (int i{0}; i < padded; i++)
+    {
+        forward[i] = i % size == 0 ? value(i) : op(forward[i - 1], value(i));
+    }
+    for (int i{padded - 1}; i >= 0; i--)
+    {
+        backward[i] = i % size == size - 1 ? value(i) : op(backward[i + 1], value(i));
+    }
+    for (int x{0}; x < n; x++)
+    {
+        line[x * stride] = op(backward[x], forward[x + size - 1]);
+    }
+}
+
+/**
+ * Applique vhgw_line() à toutes les colonnes de `data` (`height` lignes de `row_size` valeurs).
+ * Les colonnes sont traitées par paquets de 64 voisines, pour que chaque ligne lue remplisse des lignes de cache entières.
+ */
+template<typename T, typename Op>
+void vhgw_columns(T* data, int row_size, int height, int size, int anchor, Op op, T neutral)
+{
+    if (size <= 1) return;
+
+    parallel_for_bands(0, row_size, [&](int begin, int end) {
+        constexpr int chunk = 64;
+        const int padded = (height + 2 * (size - 1)) / size * size;
+        std::vector<T> forward(static_cast<size_t>(padded) * chunk);
+        std::vector<T> backward(static_cast<size_t>(padded) * chunk);
+
+        for (int c0{begin}; c0 < end; c0 += chunk)
+        {
+            const int columns = std::min(chunk, end - c0);
+            auto value = [&](int i, int c) {
+                return (i >= anchor && i - anchor < height) ? data[static_cast<size_t>(i - anchor) * row_size + c0 + c] : neutral;
+            };
+
+            // Même calcul que vhgw_line(), mais ligne par ligne sur `columns` colonnes à la fois
+            for (int i{0}; i < padded; i++)
+            {
+                T* f = forward.data() + static_cast<size_t>(i) * chunk;
+                for (int c{0}; c < columns; c++)
+                {
+                    f[c] = i % size == 0 ? value(i, c) : op(f[c - chunk], value(i, c));
+                }
+            }
+            for (int i{padded - 1}; i >= 0; i--)
+            {
+                T* b = backward.data() + static_cast<size_t>(i) * chunk;
+                for (int c{0}; c < columns; c++)
+                {
+                    b[c] = i % size == size - 1 ? value(i, c) : op(b[c + chunk], value(i, c));
+                }
+            }
+            for (int y{0}; y < height; y++)
+            {
+                T* out = data + static_cast<size_t>(y) * row_size + c0;
+                const T* b = backward.data() + static_cast<size_t>(y) * chunk;
+                const T* f = forward.data() + static_cast<size_t>(y + size - 1) * chunk;
+                for (int c{0}; c < columns; c++)
+                {
+                    out[c] = op(b[c], f[c]);
+                }
+            }
+        }
+    }, 64);
+}
+
+/// Point d'ancrage du rectangle : centré, et pour une taille paire, symétrique entre érosion et dilatation.
+int anchor(int size, bool dilation)
+{
+    return dilation ? size - 1 - size / 2 : size / 2;
+}
+
+template<bool dilation>
+void morphology(sil::Image& img, int width, int height)
+{
+    SIL_TRACE_SCOPE("morphology");
+    const glm::vec3 neutral{dilation ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity()};
+    auto op = [](const glm::vec3& a, const glm::vec3& b) { return dilation ? glm::max(a, b) : glm::min(a, b); };
+    glm::vec3* data = img.pixels().data();
+
+    if (width > 1)
+    {
+        parallel_for_bands(0, img.height(), [&](int y_begin, int y_end) {
+            std::vector<glm::vec3> forward;
+            std::vector<glm::vec3> backward;
+            for (int y{y_begin}; y < y_end; y++)
+            {
+                vhgw_line(data + static_cast<size_t>(y) * img.width(), 1, img.width(), width, anchor(width, dilation), op, neutral, forward, backward);
+            }
+        });
+    }
+    vhgw_columns(data, img.width(), img.height(), height, anchor(height, dilation), op, neutral);
+}
+
+/// Remplace img par combine(img, other) pixel par pixel.
+template<typename Func>
+void combine(sil::Image& img, const sil::Image& other, Func&& func)
+{
+    std::vector<glm::vec3>& pixels = img.pixels();
+    const std::vector<glm::vec3>& other_pixels = other.pixels();
+    for (size_t i{0}; i < pixels.size(); i++)
+    {
+        pixels[i] = func(pixels[i], other_pixels[i]);
+    }
+}
+
+/**
+ * Morphologie binaire. Horizontalement, la ligne est d'abord décalée de `anchor` pixels et prolongée par la valeur neutre,
+ * puis le cumul sur `width` pixels se fait par doublements : après avoir combiné la ligne avec elle-même décalée de 1, 2, 4... pixels,
+ * chaque bit couvre 2^k pixels, et un dernier décalage complète jusqu'à `width`.
+ * Cela fait log2(width) opérations par mot de 64 pixels. Verticalement, chaque mot est traité comme une valeur par van Herk / Gil-Werman.
+ */
+template<bool dilation>
+void morphology(BitImage& img, int width, int height)
+{
+    SIL_TRACE_SCOPE("morphology (BitImage)");
+    const uint64_t fill = dilation ? 0 : ~uint64_t{0}; // Valeur neutre des pixels hors de l'image
+    auto op = [](uint64_t a, uint64_t b) { return dilation ? a | b : a & b; };
+    const int words = img.words_per_row();
+    const int tail_bits = img.width() % 64;
+    const uint64_t tail_mask = tail_bits == 0 ? ~uint64_t{0} : (uint64_t{1} << tail_bits) - 1;
+
+    if (width > 1)
+    {
+        // Ligne prolongée : le pixel x du résultat dépend des pixels [x, x + width - 1] de la ligne décalée
+        const int extended_words = (img.width() + width - 1 + 63) / 64;
+
+        parallel_for_bands(0, img.height(), [&](int y_begin, int y_end) {
+            std::vector<uint64_t> run(extended_words);
+            std::vector<uint64_t> shifted(extended_words);
+
+            // out[pixel x] = line[pixel x + s], les mots hors de `line` valant `fill`
+            auto shift = [&](const uint64_t* line, int line_words, int s, uint64_t* out) {
+                auto load = [&](int j) { return (j < 0 || j >= line_words) ? fill : line[j]; };
+                const int q = s >= 0 ? s / 64 : -((-s + 63) / 64);
+                const int r = s - 64 * q;
+                for (int i{0}; i < extended_words; i++)
+                {
+                    out[i] = r == 0 ? load(i + q) : (load(i + q) >> r) | (load(i + q + 1) << (64 - r));
+                }
+            };
+
+            for (int y{y_begin}; y < y_end; y++)
+            {
+                uint64_t* row = img.row(y);
+                const uint64_t last = row[words - 1];
+                row[words - 1] = (last & tail_mask) | (fill & ~tail_mask);
+                shift(row, words, -anchor(width, dilation), run.data());
+
+                int covered = 1;
+                while (covered * 2 <= width)
+                {
+                    shift(run.data(), extended_words, covered, shifted.data());
+                    for (int i{0}; i < extended_words; i++) run[i] = op(run[i], shifted[i]);
+                    covered *= 2;
+                }
+                if (covered < width)
+                {
+                    shift(run.data(), extended_words, width - covered, shifted.data());
+                    for (int i{0}; i < extended_words; i++) run[i] = op(run[i], shifted[i]);
+                }
+
+                std::copy_n(run.begin(), words, row);
+                row[words - 1] &= tail_mask;
+            }
+        });
+    }
+
+    // Les bits après le dernier pixel valent 0 dans toutes les lignes et le restent : la passe verticale peut traiter les mots entiers
+    vhgw_columns(img.row(0), words, img.height(), height, anchor(height, dilation), op, fill);
+}
+
+/// Remplace img par combine(img, other) mot par mot.
+template<typename Func>
+void combine(BitImage& img, const BitImage& other, Func&& func)
+{
+    for (int y{0}; y < img.height(); y++)
+    {
+        uint64_t* row = img.row(y);
+        const uint64_t* other_row = other.row(y);
+        for (int i{0}; i < img.words_per_row(); i++) row[i] = func(row[i], other_row[i]);
+    }
+}
+
+} // namespace
+
+void erode(sil::Image& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("erode", img.width() * img.height());
+    morphology<false>(img, width, height);
+}
+
+void dilate(sil::Image& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("dilate", img.width() * img.height());
+    morphology<true>(img, width, height);
+}
+
+void opening(sil::Image& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("opening", img.width() * img.height());
+    morphology<false>(img, width, height);
+    morphology<true>(img, width, height);
+}
+
+void closing(sil::Image& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("closing", img.width() * img.height());
+    morphology<true>(img, width, height);
+    morphology<false>(img, width, height);
+}
+
+void top_hat(sil::Image& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("top_hat", img.width() * img.height());
+    sil::Image opened = img;
+    morphology<false>(opened, width, height);
+    morphology<true>(opened, width, height);
+    combine(img, opened, [](const glm::vec3& a, const glm::vec3& b) { return a - b; });
+}
+
+void black_top_hat(sil::Image& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("black_top_hat", img.width() * img.height());
+    sil::Image closed = img;
+    morphology<true>(closed, width, height);
+    morphology<false>(closed, width, height);
+    combine(img, closed, [](const glm::vec3& a, const glm::vec3& b) { return b - a; });
+}
+
+void morphological_gradient(sil::Image& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("morphological_gradient", img.width() * img.height());
+    sil::Image eroded = img;
+    morphology<false>(eroded, width, height);
+    morphology<true>(img, width, height);
+    combine(img, eroded, [](const glm::vec3& a, const glm::vec3& b) { return a - b; });
+}
+
+BitImage::BitImage(int width, int height)
+    : _width{width}, _height{height}, _words_per_row{(width + 63) / 64}, _words(static_cast<size_t>(_words_per_row) * height, 0)
+{
+}
+
+BitImage BitImage::from_image(const sil::Image& img, float threshold)
+{
+    BitImage bits{img.width(), img.height()};
+    for (int y{0}; y < img.height(); y++)
+    {
+        for (int x{0}; x < img.width(); x++)
+        {
+            const glm::vec3& c = img.pixel(x, y);
+            if (0.299f * c.r + 0.587f * c.g + 0.114f * c.b > threshold) bits.set(x, y, true);
+        }
+    }
+    return bits;
+}
+
+void BitImage::set(int x, int y, bool value)
+{
+    const uint64_t bit = uint64_t{1} << (x % 64);
+    if (value)
+        row(y)[x / 64] |= bit;
+    else
+        row(y)[x / 64] &= ~bit;
+}
+
+size_t BitImage::count() const
+{
+    size_t total = 0;
+    for (uint64_t word : _words) total += std::popcount(word);
+    return total;
+}
+
+sil::Image BitImage::to_image() const
+{
+    sil::Image img{_width, _height};
+    for (int y{0}; y < _height; y++)
+    {
+        for (int x{0}; x < _width; x++)
+        {
+            if (get(x, y)) img.pixel(x, y) = glm::vec3{1.f};
+        }
+    }
+    return img;
+}
+
+void erode(BitImage& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("erode (BitImage)", img.width() * img.height());
+    morphology<false>(img, width, height);
+}
+
+void dilate(BitImage& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("dilate (BitImage)", img.width() * img.height());
+    morphology<true>(img, width, height);
+}
+
+void opening(BitImage& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("opening (BitImage)", img.width() * img.height());
+    morphology<false>(img, width, height);
+    morphology<true>(img, width, height);
+}
+
+void closing(BitImage& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("closing (BitImage)", img.width() * img.height());
+    morphology<true>(img, width, height);
+    morphology<false>(img, width, height);
+}
+
+void top_hat(BitImage& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("top_hat (BitImage)", img.width() * img.height());
+    BitImage opened = img;
+    morphology<false>(opened, width, height);
+    morphology<true>(opened, width, height);
+    combine(img, opened, [](uint64_t a, uint64_t b) { return a & ~b; });
+}
+
+void black_top_hat(BitImage& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("black_top_hat (BitImage)", img.width() * img.height());
+    BitImage closed = img;
+    morphology<true>(closed, width, height);
+    morphology<false>(closed, width, height);
+    combine(img, closed, [](uint64_t a, uint64_t b) { return b & ~a; });
+}
+
+void morphological_gradient(BitImage& img, int width, int height)
+{
+    SIL_EFFECT_METRICS("morphological_gradient (BitImage)", img.width() * img.height());
+    BitImage eroded = img;
+    morphology<false>(eroded, width, height);
+    morphology<true>(img, width, height);
+    combine(img, eroded, [](uint64_t a, uint64_t b) { return a & ~b; });
+}
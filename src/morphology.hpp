@@ -0,0 +1,81 @@
+#pragma once
+#include <sil/sil.hpp>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Morphologie mathématique avec des éléments structurants rectangulaires width x height.
+ * L'érosion remplace chaque canal par le minimum du rectangle centré sur le pixel, la dilatation par le maximum.
+ * Le rectangle est séparable : une passe horizontale puis une passe verticale, chacune avec l'algorithme de van Herk / Gil-Werman
+ * (minimums cumulés par blocs de la taille du rectangle, vers l'avant et vers l'arrière), soit 3 comparaisons par pixel et par passe quelle que soit la taille.
+ * Les pixels hors de l'image sont ignorés (ils ne font ni diminuer une érosion ni augmenter une dilatation).
+ * Pour une taille paire, la dilatation utilise le rectangle symétrique de celui de l'érosion, ce qui garde l'ouverture et la fermeture idempotentes.
+ */
+
+/// Érosion : chaque canal devient le minimum du rectangle width x height autour du pixel. Les zones claires rétrécissent.
+void erode(sil::Image& img, int width = 3, int height = 3);
+/// Dilatation : chaque canal devient le maximum du rectangle width x height autour du pixel. Les zones claires grossissent.
+void dilate(sil::Image& img, int width = 3, int height = 3);
+/// Ouverture (érosion puis dilatation) : efface les détails clairs plus petits que le rectangle.
+void opening(sil::Image& img, int width = 3, int height = 3);
+/// Fermeture (dilatation puis érosion) : bouche les trous sombres plus petits que le rectangle.
+void closing(sil::Image& img, int width = 3, int height = 3);
+/// Chapeau haut-de-forme : image - ouverture, ne garde que les détails clairs plus petits que le rectangle.
+void top_hat(sil::Image& img, int width = 3, int height = 3);
+/// Chapeau haut-de-forme noir : fermeture - image, ne garde que les détails sombres plus petits que le rectangle.
+void black_top_hat(sil::Image& img, int width = 3, int height = 3);
+/// Gradient morphologique : dilatation - érosion, fait ressortir les contours.
+void morphological_gradient(sil::Image& img, int width = 3, int height = 3);
+
+/**
+ * Image binaire (noir et blanc) stockée sur 1 bit par pixel : le pixel x de la ligne y est le bit (x % 64) du mot (x / 64) de la ligne.
+ * Les opérations morphologiques binaires traitent 64 pixels par opération sur les mots.
+ * Comme pour sil::Image, la ligne y = 0 est en bas de l'image.
+ */
+class BitImage
+{
+public:
+    /// Crée une image noire de la taille donnée.
+    BitImage(int width, int height);
+
+    /// Binarise une image : un pixel est blanc si sa luminosité dépasse `threshold`.
+    static BitImage from_image(const sil::Image& img, float threshold = 0.5f);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+    /// Nombre de mots de 64 bits par ligne.
+    int words_per_row() const { return _words_per_row; }
+
+    uint64_t* row(int y) { return _words.data() + static_cast<size_t>(y) * _words_per_row; }
+    uint64_t const* row(int y) const { return _words.data() + static_cast<size_t>(y) * _words_per_row; }
+
+    bool get(int x, int y) const { return (row(y)[x / 64] >> (x % 64)) & 1; }
+    void set(int x, int y, bool value);
+
+    /// Nombre de pixels blancs.
+    size_t count() const;
+
+    /// Convertit en image noir (0) et blanc (1).
+    sil::Image to_image() const;
+
+private:
+    int _width;
+    int _height;
+    int _words_per_row;
+    std::vector<uint64_t> _words;
+};
+
+/// Érosion binaire : un pixel reste blanc si tout le rectangle width x height autour de lui est blanc.
+void erode(BitImage& img, int width = 3, int height = 3);
+/// Dilatation binaire : un pixel devient blanc si au moins un pixel du rectangle width x height autour de lui est blanc.
+void dilate(BitImage& img, int width = 3, int height = 3);
+/// Ouverture binaire : efface les taches blanches plus petites que le rectangle.
+void opening(BitImage& img, int width = 3, int height = 3);
+/// Fermeture binaire : bouche les trous noirs plus petits que le rectangle.
+void closing(BitImage& img, int width = 3, int height = 3);
+/// Chapeau haut-de-forme binaire : pixels blancs effacés par l'ouverture.
+void top_hat(BitImage& img, int width = 3, int height = 3);
+/// Chapeau haut-de-forme noir binaire : pixels noirs bouchés par la fermeture.
+void black_top_hat(BitImage& img, int width = 3, int height = 3);
+/// Gradient morphologique binaire : pixels blancs de la dilatation qui ne sont pas dans l'érosion (contours d'épaisseur ~ taille du rectangle).
+void morphological_gradient(BitImage& img, int width = 3, int height = 3);
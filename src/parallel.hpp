@@ -0,0 +1,121 @@
+#pragma once
+#include <sil/trace.hpp>
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+/**
+ * Renvoie le nombre de threads à utiliser pour les traitements parallèles (au moins 1).
+ */
+inline int thread_count()
+{
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+/**
+ * Suivi du traitement asynchrone exécuté par le thread courant (voir job_pool.hpp).
+ * Quand un observateur est installé, parallel_for_bands découpe chaque bande en tuiles et le consulte entre deux tuiles :
+ * c'est là qu'un traitement annulé s'arrête (par une exception, qui remonte jusqu'au code qui a lancé le traitement),
+ * que sa progression avance et qu'il laisse passer les traitements plus prioritaires.
+ */
+class BandObserver
+{
+public:
+    virtual ~BandObserver() = default;
+    /// Appelé avant chaque tuile. Lance une exception si le traitement est annulé.
+    virtual void before_tile() = 0;
+    /// Appelé après chaque tuile de `rows` lignes, sur `total` lignes pour tout l'appel de parallel_for_bands.
+    virtual void tile_done(int rows, int total) = 0;
+};
+
+/// Observateur du thread courant (nullptr en dehors d'un traitement asynchrone : les bandes sont alors traitées d'un seul bloc).
+inline BandObserver*& current_band_observer()
+{
+    thread_local BandObserver* observer = nullptr;
+    return observer;
+}
+
+/**
+ * Découpe l'intervalle [begin, end) en bandes contiguës et appelle func(band_begin, band_end) sur chaque bande, chacune dans son propre thread.
+ * Les bandes ne se chevauchent pas : func peut donc écrire sans synchronisation dans les lignes qui lui sont attribuées.
+ * Dans un traitement asynchrone, chaque bande est elle-même traitée en tuiles d'au moins min_band_size lignes (func est alors appelée une fois par tuile) :
+ * func ne doit donc pas dépendre de la façon dont l'intervalle est découpé.
+ * Une exception lancée dans une bande (par func ou par l'annulation du traitement) est relancée dans le thread appelant, une fois toutes les bandes terminées.
+ *
+ * @param begin Début de l'intervalle (inclus).
+ * @param end Fin de l'intervalle (exclue).
+ * @param func Fonction appelée avec (band_begin, band_end).
+ * @param min_band_size Taille minimale d'une bande, pour ne pas lancer de threads sur de trop petits morceaux (par défaut 16).
+ */
+template<typename Func>
+void parallel_for_bands(int begin, int end, Func&& func, int min_band_size = 16)
+{
+    const int count = end - begin;
+    if (count <= 0) return;
+
+    // Sans observateur, chaque bande est un seul appel à func ; sinon elle est parcourue par tuiles
+    BandObserver* observer = current_band_observer();
+    auto run_band = [&func, observer, count, tile = std::max(min_band_size, 16)](int band_begin, int band_end) {
+        if (observer == nullptr)
+        {
+            func(band_begin, band_end);
+            return;
+        }
+        current_band_observer() = observer; // Pour les appels imbriqués dans func
+        for (int tile_begin{band_begin}; tile_begin < band_end; tile_begin += tile)
+        {
+            observer->before_tile();
+            const int tile_end = std::min(tile_begin + tile, band_end);
+            func(tile_begin, tile_end);
+            observer->tile_done(tile_end - tile_begin, count);
+        }
+    };
+
+    const int bands = std::clamp(count / std::max(min_band_size, 1), 1, thread_count());
+    if (bands == 1)
+    {
+        run_band(begin, end);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(bands); // Une exception ne doit pas quitter un thread : elle est gardée jusqu'à la fin de toutes les bandes
+    threads.reserve(bands - 1);
+    for (int i{1}; i < bands; i++)
+    {
+        const int band_begin = begin + count * i / bands;
+        const int band_end = begin + count * (i + 1) / bands;
+        threads.emplace_back([&run_band, &error = errors[i], band_begin, band_end]() {
+            SIL_TRACE_SCOPE("band");
+            try
+            {
+                run_band(band_begin, band_end);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+        });
+    }
+
+    // Le thread appelant traite la première bande lui-même
+    try
+    {
+        SIL_TRACE_SCOPE("band");
+        run_band(begin, begin + count / bands);
+    }
+    catch (...)
+    {
+        errors[0] = std::current_exception();
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error) std::rethrow_exception(error);
+    }
+}
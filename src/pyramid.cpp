@@ -0,0 +1,231 @@
+#include "pyramid.hpp"
+#include <sil/metrics.hpp>
+#include <sil/trace.hpp>
+#include "parallel.hpp"
+#include <algorithm>
+
+namespace {
+
+// Noyau binomial 5 taps [1 4 6 4 1] / 16
+constexpr float binomial[5] = {1.f / 16.f, 4.f / 16.f, 6.f / 16.f, 4.f / 16.f, 1.f / 16.f};
+
+/**
+ * Floute (noyau binomial 5x5 séparable) et sous-échantillonne d'un facteur 2 en une seule passe :
+ * seules les lignes et colonnes paires sont calculées, et chaque ligne source n'est filtrée horizontalement qu'une fois par bande.
+ */
+void downsample(const glm::vec3* src, int src_width, int src_height, glm::vec3* dst, int dst_width, int dst_height)
+{
+    parallel_for_bands(0, dst_height, [&](int y_begin, int y_end) {
+        // 5 lignes sources filtrées horizontalement, rangées dans l'emplacement (ligne % 5)
+        std::vector<glm::vec3> rows(5 * static_cast<size_t>(dst_width));
+        int slot_row[5] = {-1, -1, -1, -1, -1};
+
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            glm::vec3* out = dst + static_cast<size_t>(y) * dst_width;
+            std::fill(out, out + dst_width, glm::vec3{0.f});
+
+            for (int k{0}; k < 5; k++)
+            {
+                const int sy = std::clamp(2 * y + k - 2, 0, src_height - 1);
+                glm::vec3* row = rows.data() + static_cast<size_t>(sy % 5) * dst_width;
+
+                if (slot_row[sy % 5] != sy)
+                {
+                    const glm::vec3* in = src + static_cast<size_t>(sy) * src_width;
+                    for (int x{0}; x < dst_width; x++)
+                    {
+                        glm::vec3 sum{0.f};
+                        for (int t{0}; t < 5; t++)
+                        {
+                            sum += binomial[t] * in[std::clamp(2 * x + t - 2, 0, src_width - 1)];
+                        }
+                        row[x] = sum;
+                    }
+                    slot_row[sy % 5] = sy;
+                }
+
+                for (int x{0}; x < dst_width; x++)
+                {
+                    out[x] += binomial[k] * row[x];
+                }
+            }
+        }
+    });
+}
+
+/**
+ * Agrandit d'un facteur 2 le niveau grossier (interpolation par le même noyau binomial) et combine le résultat avec le niveau fin grâce à `combine(fin, agrandi)`.
+ * Un pixel fin pair utilise les poids [1/8, 6/8, 1/8] autour de son pixel grossier, un pixel impair les poids [1/2, 1/2].
+ */
+template<typename Combine>
+void expand(const glm::vec3* coarse, int coarse_width, int coarse_height, glm::vec3* fine, int fine_width, int fine_height, Combine combine)
+{
+    parallel_for_bands(0, fine_height, [&](int y_begin, int y_end) {
+        // 3 lignes grossières agrandies horizontalement, rangées dans l'emplacement (ligne % 3)
+        std::vector<glm::vec3> rows(3 * static_cast<size_t>(fine_width));
+        int slot_row[3] = {-1, -1, -1};
+
+        auto expanded_row = [&](int cy) -> const glm::vec3* {
+            glm::vec3* row = rows.data() + static_cast<size_t>(cy % 3) * fine_width;
+            if (slot_row[cy % 3] != cy)
+            {
+                const glm::vec3* in = coarse + static_cast<size_t>(cy) * coarse_width;
+                for (int x{0}; x < fine_width; x++)
+                {
+                    const int cx = x / 2;
+                    if (x % 2 == 0)
+                        row[x] = 0.125f * in[std::max(cx - 1, 0)] + 0.75f * in[cx] + 0.125f * in[std::min(cx + 1, coarse_width - 1)];
+                    else
+                        row[x] = 0.5f * in[cx] + 0.5f * in[std::min(cx + 1, coarse_width - 1)];
+                }
+                slot_row[cy % 3] = cy;
+            }
+            return row;
+        };
+
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            const int cy = y / 2;
+            glm::vec3* out = fine + static_cast<size_t>(y) * fine_width;
+
+            if (y % 2 == 0)
+            {
+                const glm::vec3* above = expanded_row(std::max(cy - 1, 0));
+                const glm::vec3* center = expanded_row(cy);
+                const glm::vec3* below = expanded_row(std::min(cy + 1, coarse_height - 1));
+                for (int x{0}; x < fine_width; x++)
+                {
+                    combine(out[x], 0.125f * above[x] + 0.75f * center[x] + 0.125f * below[x]);
+                }
+            }
+            else
+            {
+                const glm::vec3* center = expanded_row(cy);
+                const glm::vec3* below = expanded_row(std::min(cy + 1, coarse_height - 1));
+                for (int x{0}; x < fine_width; x++)
+                {
+                    combine(out[x], 0.5f * center[x] + 0.5f * below[x]);
+                }
+            }
+        }
+    });
+}
+
+void copy_into_pyramid(const sil::Image& img, Pyramid& pyramid)
+{
+    std::copy(img.pixels().begin(), img.pixels().end(), pyramid.data(0));
+    for (int level{1}; level < pyramid.levels(); level++)
+    {
+        downsample(pyramid.data(level - 1), pyramid.width(level - 1), pyramid.height(level - 1),
+                   pyramid.data(level), pyramid.width(level), pyramid.height(level));
+    }
+}
+
+} // namespace
+
+Pyramid::Pyramid(int width, int height, int levels)
+{
+    size_t total = 0;
+    for (int level{0}; level < std::max(levels, 1); level++)
+    {
+        _levels.push_back({width, height, total});
+        total += static_cast<size_t>(width) * static_cast<size_t>(height);
+        if (width == 1 && height == 1) break;
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+    }
+    _pixels.resize(total);
+}
+
+sil::Image Pyramid::to_image(int level) const
+{
+    sil::Image img{width(level), height(level)};
+    std::copy(data(level), data(level) + img.pixels().size(), img.pixels().begin());
+    return img;
+}
+
+Pyramid gaussian_pyramid(const sil::Image& img, int levels)
+{
+    SIL_TRACE_SCOPE("gaussian_pyramid");
+    Pyramid pyramid{img.width(), img.height(), levels};
+    copy_into_pyramid(img, pyramid);
+    return pyramid;
+}
+
+Pyramid laplacian_pyramid(const sil::Image& img, int levels)
+{
+    SIL_TRACE_SCOPE("laplacian_pyramid");
+    Pyramid pyramid = gaussian_pyramid(img, levels);
+    gaussian_to_laplacian(pyramid);
+    return pyramid;
+}
+
+void gaussian_to_laplacian(Pyramid& pyramid)
+{
+    // Du plus fin au plus grossier : G(i + 1) est encore intact quand on calcule L(i)
+    for (int level{0}; level < pyramid.levels() - 1; level++)
+    {
+        expand(pyramid.data(level + 1), pyramid.width(level + 1), pyramid.height(level + 1),
+               pyramid.data(level), pyramid.width(level), pyramid.height(level),
+               [](glm::vec3& fine, const glm::vec3& expanded) { fine -= expanded; });
+    }
+}
+
+void collapse_laplacian(Pyramid& pyramid)
+{
+    SIL_TRACE_SCOPE("collapse_laplacian");
+    // Du plus grossier au plus fin : G(i + 1) vient d'être reconstruit quand on reconstruit G(i)
+    for (int level{pyramid.levels() - 2}; level >= 0; level--)
+    {
+        expand(pyramid.data(level + 1), pyramid.width(level + 1), pyramid.height(level + 1),
+               pyramid.data(level), pyramid.width(level), pyramid.height(level),
+               [](glm::vec3& fine, const glm::vec3& expanded) { fine += expanded; });
+    }
+}
+
+void pyramid_blend(sil::Image& img, const sil::Image& other, const sil::Image& mask, int levels)
+{
+    SIL_TRACE_SCOPE("pyramid_blend");
+    SIL_EFFECT_METRICS("pyramid_blend", img.width() * img.height());
+    if (img.width() != other.width() || img.height() != other.height()
+        || img.width() != mask.width() || img.height() != mask.height())
+    {
+        return;
+    }
+
+    Pyramid blended = laplacian_pyramid(img, levels);
+    const Pyramid other_pyramid = laplacian_pyramid(other, levels);
+    const Pyramid mask_pyramid = gaussian_pyramid(mask, levels);
+
+    for (int level{0}; level < blended.levels(); level++)
+    {
+        glm::vec3* a = blended.data(level);
+        const glm::vec3* b = other_pyramid.data(level);
+        const glm::vec3* m = mask_pyramid.data(level);
+        const size_t count = static_cast<size_t>(blended.width(level)) * blended.height(level);
+        for (size_t i{0}; i < count; i++)
+        {
+            a[i] = a[i] * m[i] + b[i] * (1.f - m[i]);
+        }
+    }
+
+    collapse_laplacian(blended);
+    std::copy(blended.data(0), blended.data(0) + img.pixels().size(), img.pixels().begin());
+}
+
+void pyramid_blur(sil::Image& img, int level)
+{
+    SIL_TRACE_SCOPE("pyramid_blur");
+    SIL_EFFECT_METRICS("pyramid_blur", img.width() * img.height());
+    if (level <= 0) return;
+
+    Pyramid pyramid = gaussian_pyramid(img, level + 1);
+    for (int l{pyramid.levels() - 2}; l >= 0; l--)
+    {
+        expand(pyramid.data(l + 1), pyramid.width(l + 1), pyramid.height(l + 1),
+               pyramid.data(l), pyramid.width(l), pyramid.height(l),
+               [](glm::vec3& fine, const glm::vec3& expanded) { fine = expanded; });
+    }
+    std::copy(pyramid.data(0), pyramid.data(0) + img.pixels().size(), img.pixels().begin());
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <sil/sil.hpp>
+#include <vector>
+
+/**
+ * Pyramide d'images : le niveau 0 a la taille de l'image d'origine, chaque niveau suivant est deux fois plus petit.
+ * Tous les niveaux sont stockés dans une seule allocation, réutilisée par les conversions en place (Laplacien, reconstruction).
+ */
+class Pyramid
+{
+public:
+    /// Alloue une pyramide de `levels` niveaux (réduit si l'image devient trop petite) pour une image de taille width x height.
+    Pyramid(int width, int height, int levels);
+
+    int levels() const { return static_cast<int>(_levels.size()); }
+    int width(int level) const { return _levels[level].width; }
+    int height(int level) const { return _levels[level].height; }
+
+    /// Renvoie le premier pixel du niveau. Les pixels sont stockés ligne par ligne, comme dans sil::Image.
+    glm::vec3* data(int level) { return _pixels.data() + _levels[level].offset; }
+    glm::vec3 const* data(int level) const { return _pixels.data() + _levels[level].offset; }
+
+    glm::vec3& pixel(int level, int x, int y) { return data(level)[x + y * width(level)]; }
+    glm::vec3 const& pixel(int level, int x, int y) const { return data(level)[x + y * width(level)]; }
+
+    /// Copie un niveau dans une nouvelle image.
+    sil::Image to_image(int level) const;
+
+private:
+    struct Level
+    {
+        int width;
+        int height;
+        size_t offset;
+    };
+
+    std::vector<glm::vec3> _pixels;
+    std::vector<Level> _levels;
+};
+
+/**
+ * Construit la pyramide gaussienne de l'image : chaque niveau est le précédent flouté par le noyau binomial 5x5 [1 4 6 4 1] / 16
+ * puis sous-échantillonné d'un facteur 2. Le flou et le sous-échantillonnage sont fusionnés en une seule passe.
+ *
+ * @param img Image source (type sil::Image).
+ * @param levels Nombre de niveaux souhaités, niveau 0 compris (par défaut 6).
+ */
+Pyramid gaussian_pyramid(const sil::Image& img, int levels = 6);
+
+/**
+ * Construit la pyramide laplacienne de l'image : chaque niveau contient les détails perdus entre deux niveaux de la pyramide gaussienne,
+ * le dernier niveau contient l'image la plus réduite.
+ *
+ * @param img Image source (type sil::Image).
+ * @param levels Nombre de niveaux souhaités, niveau 0 compris (par défaut 6).
+ */
+Pyramid laplacian_pyramid(const sil::Image& img, int levels = 6);
+
+/**
+ * Transforme en place une pyramide gaussienne en pyramide laplacienne : L(i) = G(i) - agrandissement(G(i + 1)).
+ */
+void gaussian_to_laplacian(Pyramid& pyramid);
+
+/**
+ * Reconstruit en place une pyramide laplacienne : G(i) = L(i) + agrandissement(G(i + 1)).
+ * Le niveau 0 contient ensuite l'image reconstruite.
+ */
+void collapse_laplacian(Pyramid& pyramid);
+
+/**
+ * Mélange deux images bande de fréquence par bande de fréquence (multi-band blending) : les basses fréquences sont mélangées sur une large zone
+ * et les détails sur une zone étroite, ce qui donne une transition invisible entre les deux images.
+ * Les trois images doivent avoir la même taille.
+ *
+ * @param img Première image (type sil::Image), modifiée en place pour contenir le mélange.
+ * @param other Seconde image (type sil::Image).
+ * @param mask Masque de mélange : 1 garde img, 0 garde other (par canal).
+ * @param levels Nombre de niveaux des pyramides (par défaut 6).
+ */
+void pyramid_blend(sil::Image& img, const sil::Image& other, const sil::Image& mask, int levels = 6);
+
+/**
+ * Applique un flou de grand rayon en réduisant l'image jusqu'au niveau demandé de sa pyramide gaussienne puis en la ré-agrandissant.
+ * Chaque niveau double environ le rayon du flou, pour un coût proche d'un simple parcours de l'image.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param level Niveau de la pyramide à utiliser (par défaut 3).
+ */
+void pyramid_blur(sil::Image& img, int level = 3);
@@ -0,0 +1,28 @@
+#pragma once
+#include <algorithm>
+
+/**
+ * Rectangle de pixels [x0, x1) x [y0, y1).
+ */
+struct Rect
+{
+    int x0{0};
+    int y0{0};
+    int x1{0};
+    int y1{0};
+
+    int width() const { return x1 - x0; }
+    int height() const { return y1 - y0; }
+    bool empty() const { return x1 <= x0 || y1 <= y0; }
+
+    /// Rectangle agrandi de `margin` pixels de chaque côté.
+    Rect expanded(int margin) const { return Rect{x0 - margin, y0 - margin, x1 + margin, y1 + margin}; }
+
+    /// Partie commune aux deux rectangles (vide s'ils ne se touchent pas).
+    Rect intersected(const Rect& other) const
+    {
+        return Rect{std::max(x0, other.x0), std::max(y0, other.y0), std::min(x1, other.x1), std::min(y1, other.y1)};
+    }
+
+    bool contains(const Rect& other) const { return other.x0 >= x0 && other.y0 >= y0 && other.x1 <= x1 && other.y1 <= y1; }
+};
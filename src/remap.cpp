@@ -0,0 +1,312 @@
+#include "remap.hpp"
+#include <sil/metrics.hpp>
+#include <sil/trace.hpp>
+#include "parallel.hpp"
+#include "dispatch.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Taille des blocs de sortie traités d'un coup, pour que les pixels sources lus restent en cache (par exemple pour une rotation)
+constexpr int block_size = 64;
+
+} // namespace
+
+Remap::Remap(int src_width, int src_height, int width, int height, RemapSampling sampling, bool per_channel)
+    : _src_width{src_width}
+    , _src_height{src_height}
+    , _width{width}
+    , _height{height}
+    , _channels{per_channel ? 3 : 1}
+    , _sampling{src_width >= 2 && src_height >= 2 ? sampling : RemapSampling::Nearest}
+{
+    const size_t size = static_cast<size_t>(width) * static_cast<size_t>(height) * _channels;
+    if (_sampling == RemapSampling::Nearest)
+        _nearest.assign(size, -1);
+    else
+        _bilinear.assign(size, BilinearSample{-1, 0, 0});
+}
+
+void Remap::set(int x, int y, glm::vec2 source, int channel)
+{
+    const size_t i = static_cast<size_t>(std::min(channel, _channels - 1)) * _width * _height + x + static_cast<size_t>(y) * _width;
+
+    if (_sampling == RemapSampling::Nearest)
+    {
+        const int sx = static_cast<int>(std::floor(source.x + 0.5f));
+        const int sy = static_cast<int>(std::floor(source.y + 0.5f));
+        const bool inside = sx >= 0 && sx < _src_width && sy >= 0 && sy < _src_height;
+        _nearest[i] = inside ? sx + sy * _src_width : -1;
+        return;
+    }
+
+    // On accepte un demi-pixel autour de l'image, ramené sur le bord
+    if (source.x < -0.5f || source.x > _src_width - 0.5f || source.y < -0.5f || source.y > _src_height - 0.5f)
+    {
+        _bilinear[i] = BilinearSample{-1, 0, 0};
+        return;
+    }
+    source = glm::clamp(source, glm::vec2{0.f}, glm::vec2{_src_width - 1.f, _src_height - 1.f});
+    const int x0 = std::min(static_cast<int>(source.x), _src_width - 2);
+    const int y0 = std::min(static_cast<int>(source.y), _src_height - 2);
+    _bilinear[i] = BilinearSample{
+        x0 + y0 * _src_width,
+        static_cast<uint16_t>(std::lround((source.x - x0) * 32768.f)),
+        static_cast<uint16_t>(std::lround((source.y - y0) * 32768.f)),
+    };
+}
+
+template<bool bilinear, int channels>
+void Remap::apply_blocks(const glm::vec3* in, glm::vec3* out) const
+{
+    const size_t plane = static_cast<size_t>(_width) * _height;
+    const int blocks_y = (_height + block_size - 1) / block_size;
+
+    parallel_for_bands(0, blocks_y, [&](int block_begin, int block_end) {
+        for (int by{block_begin}; by < block_end; by++)
+        {
+            const int y_end = std::min((by + 1) * block_size, _height);
+            for (int bx{0}; bx < _width; bx += block_size)
+            {
+                const int x_end = std::min(bx + block_size, _width);
+                for (int y{by * block_size}; y < y_end; y++)
+                {
+                    for (int x{bx}; x < x_end; x++)
+                    {
+                        const size_t i = x + static_cast<size_t>(y) * _width;
+                        glm::vec3 color{0.f};
+
+                        for (int c{0}; c < channels; c++)
+                        {
+                            glm::vec3 sample{0.f};
+                            if constexpr (bilinear)
+                            {
+                                const BilinearSample s = _bilinear[c * plane + i];
+                                if (s.index >= 0)
+                                {
+                                    const float fx = s.fx * (1.f / 32768.f);
+                                    const float fy = s.fy * (1.f / 32768.f);
+                                    const glm::vec3* p = in + s.index;
+                                    const glm::vec3 bottom = p[0] + fx * (p[1] - p[0]);
+                                    const glm::vec3 top = p[_src_width] + fx * (p[_src_width + 1] - p[_src_width]);
+                                    sample = bottom + fy * (top - bottom);
+                                }
+                            }
+                            else
+                            {
+                                const int32_t index = _nearest[c * plane + i];
+                                if (index >= 0) sample = in[index];
+                            }
+
+                            if constexpr (channels == 1)
+                                color = sample;
+                            else
+                                color[c] = sample[c];
+                        }
+
+                        out[i] = color;
+                    }
+                }
+            }
+        }
+    }, 1);
+}
+
+void Remap::apply(const sil::Image& src, sil::Image& dst) const
+{
+    SIL_TRACE_SCOPE("Remap::apply");
+    SIL_EFFECT_METRICS("Remap::apply", _width * _height);
+    if (src.width() != _src_width || src.height() != _src_height) return;
+    if (dst.width() != _width || dst.height() != _height) dst = sil::Image{_width, _height};
+
+    const glm::vec3* in = src.pixels().data();
+    glm::vec3* out = dst.pixels().data();
+
+    // Une version de la boucle par combinaison (échantillonnage, nombre de canaux)
+    std::visit([&](auto sampling, auto channels) {
+        apply_blocks<sampling == RemapSampling::Bilinear, channels>(in, out);
+    }, as_variant<RemapSampling::Nearest, RemapSampling::Bilinear>(_sampling), as_variant<1, 3>(_channels));
+}
+
+void Remap::apply(sil::Image& img) const
+{
+    const sil::Image src = img;
+    apply(src, img);
+}
+
+Rect Remap::source_bounds(const Rect& output) const
+{
+    const size_t plane = static_cast<size_t>(_width) * _height;
+    const int extent = _sampling == RemapSampling::Bilinear ? 2 : 1; // L'interpolation lit aussi le pixel de droite et celui du dessus
+    Rect bounds{_src_width, _src_height, 0, 0};
+
+    for (int c{0}; c < _channels; c++)
+    {
+        for (int y{output.y0}; y < output.y1; y++)
+        {
+            for (int x{output.x0}; x < output.x1; x++)
+            {
+                const size_t i = c * plane + x + static_cast<size_t>(y) * _width;
+                const int32_t index = _sampling == RemapSampling::Bilinear ? _bilinear[i].index : _nearest[i];
+                if (index < 0) continue;
+
+                const int sx = index % _src_width;
+                const int sy = index / _src_width;
+                bounds = Rect{std::min(bounds.x0, sx), std::min(bounds.y0, sy), std::max(bounds.x1, sx + extent), std::max(bounds.y1, sy + extent)};
+            }
+        }
+    }
+    return bounds;
+}
+
+sil::Image Remap::apply_region(const sil::Image& src, const Rect& src_rect, const Rect& output) const
+{
+    SIL_TRACE_SCOPE("Remap::apply_region");
+    sil::Image out{output.width(), output.height()};
+    const size_t plane = static_cast<size_t>(_width) * _height;
+    const int stride = src.width();
+    const bool bilinear = _sampling == RemapSampling::Bilinear;
+
+    // Pixel de la région source correspondant à un indice de l'image source complète
+    auto source_pixel = [&](int32_t index) {
+        const int sx = index % _src_width - src_rect.x0;
+        const int sy = index / _src_width - src_rect.y0;
+        return src.pixels().data() + sx + static_cast<size_t>(sy) * stride;
+    };
+
+    for (int y{output.y0}; y < output.y1; y++)
+    {
+        for (int x{output.x0}; x < output.x1; x++)
+        {
+            const size_t i = x + static_cast<size_t>(y) * _width;
+            glm::vec3 color{0.f};
+
+            for (int c{0}; c < _channels; c++)
+            {
+                glm::vec3 sample{0.f};
+                if (bilinear)
+                {
+                    const BilinearSample s = _bilinear[c * plane + i];
+                    if (s.index >= 0)
+                    {
+                        const float fx = s.fx * (1.f / 32768.f);
+                        const float fy = s.fy * (1.f / 32768.f);
+                        const glm::vec3* p = source_pixel(s.index);
+                        const glm::vec3 bottom = p[0] + fx * (p[1] - p[0]);
+                        const glm::vec3 top = p[stride] + fx * (p[stride + 1] - p[stride]);
+                        sample = bottom + fy * (top - bottom);
+                    }
+                }
+                else
+                {
+                    const int32_t index = _nearest[c * plane + i];
+                    if (index >= 0) sample = *source_pixel(index);
+                }
+
+                if (_channels == 1)
+                    color = sample;
+                else
+                    color[c] = sample[c];
+            }
+
+            out.pixel(x - output.x0, y - output.y0) = color;
+        }
+    }
+    return out;
+}
+
+Remap rotate90_remap(int width, int height)
+{
+    Remap remap{width, height, height, width};
+    for (int y{0}; y < width; y++)
+    {
+        for (int x{0}; x < height; x++)
+        {
+            // Inverse de (x, y) -> (height - 1 - y, x)
+            remap.set(x, y, glm::vec2{y, height - 1 - x});
+        }
+    }
+    return remap;
+}
+
+Remap flip_remap(int width, int height, bool horizontal, bool vertical)
+{
+    Remap remap{width, height, width, height};
+    for (int y{0}; y < height; y++)
+    {
+        for (int x{0}; x < width; x++)
+        {
+            remap.set(x, y, glm::vec2{horizontal ? width - 1 - x : x, vertical ? height - 1 - y : y});
+        }
+    }
+    return remap;
+}
+
+Remap split_rgb_remap(int width, int height, int offset)
+{
+    Remap remap{width, height, width, height, RemapSampling::Nearest, true};
+    for (int y{0}; y < height; y++)
+    {
+        for (int x{0}; x < width; x++)
+        {
+            remap.set(x, y, glm::vec2{std::max(x - offset, 0), y}, 0);
+            remap.set(x, y, glm::vec2{x, y}, 1);
+            remap.set(x, y, glm::vec2{std::min(x + offset, width - 1), y}, 2);
+        }
+    }
+    return remap;
+}
+
+Remap mosaic_mirror_remap(int width, int height, int copies)
+{
+    Remap remap{width, height, width * copies, height * copies};
+    for (int y{0}; y < height * copies; y++)
+    {
+        for (int x{0}; x < width * copies; x++)
+        {
+            const int src_x = (x / width) % 2 == 1 ? width - 1 - x % width : x % width;
+            const int src_y = (y / height) % 2 == 1 ? height - 1 - y % height : y % height;
+            remap.set(x, y, glm::vec2{src_x, src_y});
+        }
+    }
+    return remap;
+}
+
+Remap lens_distortion_remap(int width, int height, float strength)
+{
+    Remap remap{width, height, width, height, RemapSampling::Bilinear};
+    const glm::vec2 center{(width - 1) / 2.f, (height - 1) / 2.f};
+    const float norm = glm::length(center);
+
+    for (int y{0}; y < height; y++)
+    {
+        for (int x{0}; x < width; x++)
+        {
+            // Une image de 1 x 1 a son centre sur son unique pixel (norm == 0) : il se lit lui-même
+            const glm::vec2 d = norm > 0.f ? (glm::vec2{x, y} - center) / norm : glm::vec2{0.f};
+            const float r2 = glm::dot(d, d);
+            remap.set(x, y, center + d * norm * (1.f + strength * r2));
+        }
+    }
+    return remap;
+}
+
+Remap chromatic_aberration_remap(int width, int height, float amount)
+{
+    Remap remap{width, height, width, height, RemapSampling::Bilinear, true};
+    const glm::vec2 center{(width - 1) / 2.f, (height - 1) / 2.f};
+    const float scales[3] = {1.f + amount, 1.f, 1.f - amount};
+
+    for (int y{0}; y < height; y++)
+    {
+        for (int x{0}; x < width; x++)
+        {
+            for (int c{0}; c < 3; c++)
+            {
+                remap.set(x, y, center + (glm::vec2{x, y} - center) * scales[c], c);
+            }
+        }
+    }
+    return remap;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <sil/sil.hpp>
+#include "rect.hpp"
+#include <cstdint>
+#include <vector>
+
+enum class RemapSampling
+{
+    Nearest, // Pixel source le plus proche : un indice entier par pixel de sortie
+    Bilinear // Interpolation entre 4 pixels sources : un indice et deux poids en virgule fixe par pixel de sortie
+};
+
+/**
+ * Table de correspondance précalculée entre chaque pixel de sortie et sa position dans l'image source.
+ * Elle est construite une seule fois pour une géométrie donnée, puis appliquée à autant d'images (par exemple les images d'une vidéo) que l'on veut :
+ * l'application ne fait plus aucun calcul de coordonnées, seulement des lectures de pixels.
+ * Les pixels de sortie dont la position source est hors de l'image sont noirs.
+ */
+class Remap
+{
+public:
+    /**
+     * Crée une table où tous les pixels de sortie sont noirs.
+     *
+     * @param src_width Largeur des images sources.
+     * @param src_height Hauteur des images sources.
+     * @param width Largeur des images produites.
+     * @param height Hauteur des images produites.
+     * @param sampling Mode d'échantillonnage (Bilinear nécessite une image source d'au moins 2x2 pixels, sinon Nearest est utilisé).
+     * @param per_channel Si true, chaque canal (R, G, B) a sa propre position source.
+     */
+    Remap(int src_width, int src_height, int width, int height, RemapSampling sampling = RemapSampling::Nearest, bool per_channel = false);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    /**
+     * Enregistre la position source (en pixels, (0, 0) étant le centre du premier pixel) lue par le pixel de sortie (x, y).
+     *
+     * @param channel Canal concerné (0, 1 ou 2), ignoré si la table est commune aux trois canaux.
+     */
+    void set(int x, int y, glm::vec2 source, int channel = 0);
+
+    /// Applique la table à src et écrit le résultat dans dst (redimensionnée si besoin). src doit avoir la taille donnée à la construction.
+    void apply(const sil::Image& src, sil::Image& dst) const;
+
+    /// Applique la table à l'image, modifiée en place.
+    void apply(sil::Image& img) const;
+
+    int src_width() const { return _src_width; }
+    int src_height() const { return _src_height; }
+
+    /// Plus petit rectangle de l'image source contenant tous les pixels lus par les pixels de sortie de `output` (vide si aucun n'est lu).
+    Rect source_bounds(const Rect& output) const;
+
+    /**
+     * Calcule seulement les pixels de sortie de `output`, en lisant une partie de l'image source.
+     *
+     * @param src Pixels sources du rectangle `src_rect`, qui doit contenir source_bounds(output).
+     * @param src_rect Position de `src` dans l'image source.
+     * @param output Pixels de sortie à calculer.
+     * @return Image de taille output.width() x output.height().
+     */
+    sil::Image apply_region(const sil::Image& src, const Rect& src_rect, const Rect& output) const;
+
+private:
+    /// Boucle d'application, spécialisée pour chaque mode d'échantillonnage et nombre de tables pour ne pas tester ces paramètres à chaque pixel.
+    template<bool bilinear, int channels>
+    void apply_blocks(const glm::vec3* in, glm::vec3* out) const;
+
+    // Pixel source en bas à gauche des 4 pixels interpolés, et poids horizontal / vertical en Q15 (32768 = 1)
+    struct BilinearSample
+    {
+        int32_t index;
+        uint16_t fx;
+        uint16_t fy;
+    };
+
+    int _src_width;
+    int _src_height;
+    int _width;
+    int _height;
+    int _channels;
+    RemapSampling _sampling;
+    std::vector<int32_t> _nearest;          // _channels tables de width * height indices (-1 = hors de l'image)
+    std::vector<BilinearSample> _bilinear;  // _channels tables de width * height échantillons (index -1 = hors de l'image)
+};
+
+/// Rotation de 90 degrés dans le sens des aiguilles d'une montre, comme rotate90() (l'image produite fait height x width).
+Remap rotate90_remap(int width, int height);
+
+/// Miroir horizontal et / ou vertical.
+Remap flip_remap(int width, int height, bool horizontal, bool vertical);
+
+/// Séparation des canaux RGB, comme splitRGB() : le rouge est lu `offset` pixels à gauche, le bleu `offset` pixels à droite.
+Remap split_rgb_remap(int width, int height, int offset = 25);
+
+/// Mosaïque miroir, comme mosaic_mirror() (l'image produite fait (width * copies) x (height * copies)).
+Remap mosaic_mirror_remap(int width, int height, int copies = 5);
+
+/**
+ * Distorsion radiale d'objectif : chaque pixel lit l'image source à la distance r * (1 + strength * r²) du centre (r normalisé par la demi-diagonale).
+ * strength > 0 donne une distorsion en barillet, strength < 0 une distorsion en coussinet.
+ */
+Remap lens_distortion_remap(int width, int height, float strength);
+
+/**
+ * Aberration chromatique latérale : le rouge et le bleu sont lus à des distances du centre respectivement multipliées par (1 + amount) et (1 - amount).
+ */
+Remap chromatic_aberration_remap(int width, int height, float amount = 0.01f);
@@ -0,0 +1,264 @@
+#include "resize.hpp"
+#include <sil/metrics.hpp>
+#include <sil/trace.hpp>
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define RESIZE_USE_SSE 1
+#else
+#define RESIZE_USE_SSE 0
+#endif
+
+namespace {
+
+/**
+ * Table des poids d'un rééchantillonnage 1D : pour chaque pixel de sortie, l'indice du premier pixel source utilisé
+ * et `taps` poids consécutifs (complétés par des zéros pour que toutes les sorties aient le même nombre de poids).
+ */
+struct WeightTable
+{
+    std::vector<int> first;
+    std::vector<float> weights;
+    int taps{0};
+};
+
+float lanczos3(float x)
+{
+    x = std::abs(x);
+    if (x < 1e-6f) return 1.f;
+    if (x >= 3.f) return 0.f;
+    const float pi_x = std::numbers::pi_v<float> * x;
+    return 3.f * std::sin(pi_x) * std::sin(pi_x / 3.f) / (pi_x * pi_x);
+}
+
+/**
+ * Famille des filtres bicubiques de Mitchell-Netravali, paramétrée par B et C.
+ */
+float cubic(float x, float B, float C)
+{
+    x = std::abs(x);
+    if (x < 1.f)
+        return ((12.f - 9.f * B - 6.f * C) * x * x * x + (-18.f + 12.f * B + 6.f * C) * x * x + (6.f - 2.f * B)) / 6.f;
+    if (x < 2.f)
+        return ((-B - 6.f * C) * x * x * x + (6.f * B + 30.f * C) * x * x + (-12.f * B - 48.f * C) * x + (8.f * B + 24.f * C)) / 6.f;
+    return 0.f;
+}
+
+float filter_support(ResizeFilter filter)
+{
+    switch (filter)
+    {
+    case ResizeFilter::Lanczos3: return 3.f;
+    case ResizeFilter::Mitchell: return 2.f;
+    case ResizeFilter::CatmullRom: return 2.f;
+    case ResizeFilter::Area: return 0.5f;
+    }
+    return 1.f;
+}
+
+float filter_value(ResizeFilter filter, float x)
+{
+    switch (filter)
+    {
+    case ResizeFilter::Lanczos3: return lanczos3(x);
+    case ResizeFilter::Mitchell: return cubic(x, 1.f / 3.f, 1.f / 3.f);
+    case ResizeFilter::CatmullRom: return cubic(x, 0.f, 0.5f);
+    case ResizeFilter::Area: return std::abs(x) <= 0.5f ? 1.f : 0.f;
+    }
+    return 0.f;
+}
+
+/**
+ * Calcule, pour chaque pixel de sortie, les pixels sources qui y contribuent et leurs poids normalisés.
+ * En réduction, le filtre est étiré d'un facteur src_size / dst_size pour éviter l'aliasing.
+ * Pour ResizeFilter::Area, le poids d'un pixel source est la proportion de sa surface recouverte par le pixel de sortie.
+ */
+WeightTable build_weights(int src_size, int dst_size, ResizeFilter filter)
+{
+    const float ratio = static_cast<float>(dst_size) / static_cast<float>(src_size);
+    const float stretch = ratio < 1.f ? 1.f / ratio : 1.f;
+    const float support = filter_support(filter) * stretch;
+
+    std::vector<int> starts(dst_size);
+    std::vector<std::vector<float>> contributions(dst_size);
+
+    for (int j{0}; j < dst_size; j++)
+    {
+        std::vector<float>& weights = contributions[j];
+        int start = 0;
+
+        if (filter == ResizeFilter::Area)
+        {
+            // Intervalle [lo, hi) couvert par le pixel de sortie j, en coordonnées source
+            const float lo = static_cast<float>(j) / ratio;
+            const float hi = static_cast<float>(j + 1) / ratio;
+            start = std::clamp(static_cast<int>(std::floor(lo)), 0, src_size - 1);
+            const int end = std::clamp(static_cast<int>(std::ceil(hi)), start + 1, src_size);
+            for (int i{start}; i < end; i++)
+            {
+                weights.push_back(std::max(0.f, std::min(hi, i + 1.f) - std::max(lo, static_cast<float>(i))));
+            }
+        }
+        else
+        {
+            const float center = (j + 0.5f) / ratio - 0.5f;
+            start = std::max(0, static_cast<int>(std::ceil(center - support)));
+            const int end = std::min(src_size - 1, static_cast<int>(std::floor(center + support)));
+            for (int i{start}; i <= end; i++)
+            {
+                weights.push_back(filter_value(filter, (i - center) / stretch));
+            }
+        }
+
+        float sum = 0.f;
+        for (float w : weights) sum += w;
+        if (weights.empty() || std::abs(sum) < 1e-8f)
+        {
+            // Aucun poids utilisable : on prend le pixel source le plus proche
+            start = std::clamp(static_cast<int>((j + 0.5f) / ratio), 0, src_size - 1);
+            weights.assign(1, 1.f);
+            sum = 1.f;
+        }
+        for (float& w : weights) w /= sum;
+        starts[j] = start;
+    }
+
+    WeightTable table;
+    for (const std::vector<float>& weights : contributions)
+    {
+        table.taps = std::max(table.taps, static_cast<int>(weights.size()));
+    }
+
+    table.first.resize(dst_size);
+    table.weights.assign(static_cast<size_t>(dst_size) * table.taps, 0.f);
+    for (int j{0}; j < dst_size; j++)
+    {
+        // On recule le début de la fenêtre près du bord pour que les `taps` pixels lus restent dans l'image
+        const int first = std::min(starts[j], src_size - table.taps);
+        const int offset = starts[j] - first;
+        table.first[j] = first;
+        std::copy(contributions[j].begin(), contributions[j].end(), table.weights.begin() + static_cast<size_t>(j) * table.taps + offset);
+    }
+
+    return table;
+}
+
+/**
+ * Passe horizontale : rééchantillonne une ligne RGBX (4 floats par pixel) avec la table de poids.
+ * Le 4ème canal sert uniquement à aligner chaque pixel sur un registre SIMD de 4 floats.
+ */
+void resample_row(const float* src, float* dst, const WeightTable& table)
+{
+    const int taps = table.taps;
+    const int dst_size = static_cast<int>(table.first.size());
+
+    for (int j{0}; j < dst_size; j++)
+    {
+        const float* s = src + 4 * static_cast<size_t>(table.first[j]);
+        const float* w = table.weights.data() + static_cast<size_t>(j) * taps;
+#if RESIZE_USE_SSE
+        __m128 acc = _mm_setzero_ps();
+        for (int k{0}; k < taps; k++)
+        {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(s + 4 * k), _mm_set1_ps(w[k])));
+        }
+        _mm_storeu_ps(dst + 4 * static_cast<size_t>(j), acc);
+#else
+        float r = 0.f, g = 0.f, b = 0.f;
+        for (int k{0}; k < taps; k++)
+        {
+            r += s[4 * k + 0] * w[k];
+            g += s[4 * k + 1] * w[k];
+            b += s[4 * k + 2] * w[k];
+        }
+        dst[4 * j + 0] = r;
+        dst[4 * j + 1] = g;
+        dst[4 * j + 2] = b;
+        dst[4 * j + 3] = 0.f;
+#endif
+    }
+}
+
+} // namespace
+
+void resize(sil::Image& img, int new_width, int new_height, ResizeFilter filter)
+{
+    SIL_TRACE_SCOPE("resize");
+    SIL_EFFECT_METRICS("resize", img.width() * img.height());
+    if (new_width <= 0 || new_height <= 0) return;
+    if (new_width == img.width() && new_height == img.height()) return;
+
+    const int src_width = img.width();
+    const WeightTable horizontal = build_weights(src_width, new_width, filter);
+    const WeightTable vertical = build_weights(img.height(), new_height, filter);
+    sil::Image resized{new_width, new_height};
+
+    // Chaque bande de lignes de sortie garde son propre anneau de `vertical.taps` lignes déjà rééchantillonnées horizontalement :
+    // la fenêtre verticale avance de façon monotone, donc chaque ligne source n'est traitée qu'une fois par bande.
+    parallel_for_bands(0, new_height, [&](int y_begin, int y_end) {
+        const size_t row_floats = 4 * static_cast<size_t>(new_width);
+        std::vector<float> source_row(4 * static_cast<size_t>(src_width), 0.f);
+        std::vector<float> ring(row_floats * vertical.taps);
+        std::vector<float> accum(row_floats);
+        int next_row = vertical.first[y_begin];
+
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            const int first = vertical.first[y];
+            next_row = std::max(next_row, first);
+            while (next_row < first + vertical.taps)
+            {
+                const glm::vec3* src = img.pixels().data() + static_cast<size_t>(next_row) * src_width;
+                for (int x{0}; x < src_width; x++)
+                {
+                    source_row[4 * x + 0] = src[x].r;
+                    source_row[4 * x + 1] = src[x].g;
+                    source_row[4 * x + 2] = src[x].b;
+                }
+                resample_row(source_row.data(), ring.data() + row_floats * (next_row % vertical.taps), horizontal);
+                next_row++;
+            }
+
+            // Passe verticale : combinaison linéaire des lignes de l'anneau
+            std::fill(accum.begin(), accum.end(), 0.f);
+            const float* w = vertical.weights.data() + static_cast<size_t>(y) * vertical.taps;
+            for (int k{0}; k < vertical.taps; k++)
+            {
+                if (w[k] == 0.f) continue;
+                const float* row = ring.data() + row_floats * ((first + k) % vertical.taps);
+                for (size_t i{0}; i < row_floats; i++)
+                {
+                    accum[i] += w[k] * row[i];
+                }
+            }
+
+            glm::vec3* dst = resized.pixels().data() + static_cast<size_t>(y) * new_width;
+            for (int x{0}; x < new_width; x++)
+            {
+                dst[x] = glm::vec3{accum[4 * x + 0], accum[4 * x + 1], accum[4 * x + 2]};
+            }
+        }
+    }, 8);
+
+    img = std::move(resized);
+}
+
+void thumbnail(sil::Image& img, int max_size)
+{
+    SIL_TRACE_SCOPE("thumbnail");
+    SIL_EFFECT_METRICS("thumbnail", img.width() * img.height());
+    const int largest = std::max(img.width(), img.height());
+    if (max_size <= 0 || largest <= max_size) return;
+
+    const float scale = static_cast<float>(max_size) / static_cast<float>(largest);
+    const int new_width = std::max(1, static_cast<int>(std::round(img.width() * scale)));
+    const int new_height = std::max(1, static_cast<int>(std::round(img.height() * scale)));
+    const ResizeFilter filter = largest >= 4 * max_size ? ResizeFilter::Area : ResizeFilter::Lanczos3;
+
+    resize(img, new_width, new_height, filter);
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <sil/sil.hpp>
+
+enum class ResizeFilter
+{
+    Lanczos3,   // Sinc fenêtré sur 3 lobes : le plus net, peut créer un léger halo
+    Mitchell,   // Bicubique B = C = 1/3 : bon compromis netteté / halo
+    CatmullRom, // Bicubique B = 0, C = 0.5 : interpolant, plus net que Mitchell
+    Area        // Moyenne des pixels couverts : idéal pour les fortes réductions
+};
+
+/**
+ * Redimensionne l'image avec un rééchantillonnage séparable (une passe horizontale puis une passe verticale).
+ * Les poids du filtre sont précalculés une seule fois pour chaque colonne et chaque ligne de sortie.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param new_width Largeur de l'image redimensionnée (en pixels).
+ * @param new_height Hauteur de l'image redimensionnée (en pixels).
+ * @param filter Filtre de rééchantillonnage (par défaut ResizeFilter::Lanczos3).
+ */
+void resize(sil::Image& img, int new_width, int new_height, ResizeFilter filter = ResizeFilter::Lanczos3);
+
+/**
+ * Crée une miniature dont le plus grand côté mesure max_size pixels, en conservant les proportions.
+ * Utilise ResizeFilter::Area pour les fortes réductions (facteur 4 ou plus) et ResizeFilter::Lanczos3 sinon.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param max_size Taille du plus grand côté de la miniature (par défaut 256).
+ */
+void thumbnail(sil::Image& img, int max_size = 256);
@@ -0,0 +1,219 @@
+#include "rle_image.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numbers>
+
+RleImage::RleImage(int width, int height, glm::vec3 background)
+    : _width{width}
+    , _height{height}
+    , _rows(height, std::vector<Run>{Run{width, background}})
+{
+}
+
+RleImage RleImage::from_image(const sil::Image& img)
+{
+    RleImage rle{img.width(), img.height()};
+    for (int y{0}; y < img.height(); y++)
+    {
+        std::vector<Run>& runs = rle._rows[y];
+        runs.clear();
+        for (int x{0}; x < img.width(); x++)
+        {
+            const glm::vec3& color = img.pixel(x, y);
+            if (!runs.empty() && runs.back().color == color)
+                runs.back().length++;
+            else
+                runs.push_back(Run{1, color});
+        }
+    }
+    return rle;
+}
+
+glm::vec3 RleImage::pixel(int x, int y) const
+{
+    for (const Run& run : _rows[y])
+    {
+        if (x < run.length) return run.color;
+        x -= run.length;
+    }
+    return glm::vec3{0.f};
+}
+
+size_t RleImage::run_count() const
+{
+    size_t count = 0;
+    for (const std::vector<Run>& runs : _rows)
+    {
+        count += runs.size();
+    }
+    return count;
+}
+
+void RleImage::fill_span(int y, int x_begin, int x_end, glm::vec3 color)
+{
+    if (y < 0 || y >= _height) return;
+    x_begin = std::max(x_begin, 0);
+    x_end = std::min(x_end, _width);
+    if (x_begin >= x_end) return;
+
+    const std::vector<Run>& runs = _rows[y];
+    std::vector<Run> result;
+    result.reserve(runs.size() + 2);
+
+    int x = 0;
+    for (const Run& run : runs)
+    {
+        const int run_end = x + run.length;
+
+        // Partie de la plage avant la zone peinte
+        if (x < x_begin) result.push_back(Run{std::min(run_end, x_begin) - x, run.color});
+
+        // La zone peinte est insérée une seule fois, dans la plage où elle commence
+        if (x <= x_begin && x_begin < run_end) result.push_back(Run{x_end - x_begin, color});
+
+        // Partie de la plage après la zone peinte
+        if (run_end > x_end) result.push_back(Run{run_end - std::max(x, x_end), run.color});
+
+        x = run_end;
+    }
+
+    merge_runs(result);
+    _rows[y] = std::move(result);
+}
+
+sil::Image RleImage::to_image() const
+{
+    sil::Image img{_width, _height};
+    for (int y{0}; y < _height; y++)
+    {
+        auto out = img.pixels().begin() + static_cast<size_t>(y) * _width;
+        for (const Run& run : _rows[y])
+        {
+            out = std::fill_n(out, run.length, run.color);
+        }
+    }
+    return img;
+}
+
+void RleImage::save(std::filesystem::path path) const
+{
+    auto data = std::make_unique<uint8_t[]>(static_cast<size_t>(_width) * _height * 3);
+    uint8_t* out = data.get();
+
+    for (const std::vector<Run>& runs : _rows)
+    {
+        for (const Run& run : runs)
+        {
+            const uint8_t rgb[3] = {sil::to_8bit(run.color.r), sil::to_8bit(run.color.g), sil::to_8bit(run.color.b)};
+            if (rgb[0] == rgb[1] && rgb[1] == rgb[2])
+            {
+                // Gris (noir et blanc compris) : les 3 octets sont identiques, un seul memset suffit
+                std::fill_n(out, 3 * static_cast<size_t>(run.length), rgb[0]);
+                out += 3 * static_cast<size_t>(run.length);
+                continue;
+            }
+            for (int i{0}; i < run.length; i++)
+            {
+                out = std::copy_n(rgb, 3, out);
+            }
+        }
+    }
+
+    sil::save_rgb8(std::move(path), _width, _height, std::move(data));
+}
+
+void RleImage::merge_runs(std::vector<Run>& runs)
+{
+    size_t kept = 0;
+    for (size_t i{0}; i < runs.size(); i++)
+    {
+        if (runs[i].length <= 0) continue;
+        if (kept > 0 && runs[kept - 1].color == runs[i].color)
+            runs[kept - 1].length += runs[i].length;
+        else
+            runs[kept++] = runs[i];
+    }
+    runs.resize(kept);
+}
+
+namespace {
+
+/**
+ * Renvoie le plus grand décalage horizontal k >= 0 tel que inside(k) soit vrai, ou -1 si inside(0) est faux.
+ * inside doit être vrai pour les petits décalages et faux au-delà d'une limite (c'est le cas d'une distance au centre).
+ * L'estimation analytique évite de tester tous les pixels : elle n'est corrigée que de quelques pas pour retrouver exactement le test de disk() et circle().
+ */
+template<typename Inside>
+int largest_offset(Inside inside, float estimate)
+{
+    if (!inside(0)) return -1;
+    int k = std::max(0, static_cast<int>(estimate));
+    while (k > 0 && !inside(k)) k--;
+    while (inside(k + 1)) k++;
+    return k;
+}
+
+} // namespace
+
+void rle_disk(RleImage& img, float radius, int centerX, int centerY, glm::vec3 color)
+{
+    if (centerX == -1) centerX = img.width() / 2;
+    if (centerY == -1) centerY = img.height() / 2;
+
+    for (int y{std::max(0, centerY - static_cast<int>(radius) - 1)}; y < std::min(img.height(), centerY + static_cast<int>(radius) + 2); y++)
+    {
+        const float dy = y - centerY;
+        // Même test que disk() : sqrt(dx² + dy²) < radius
+        const int k = largest_offset([&](int dx) { return std::sqrt(static_cast<float>(dx) * dx + dy * dy) < radius; },
+                                     std::sqrt(std::max(0.f, radius * radius - dy * dy)));
+        if (k >= 0) img.fill_span(y, centerX - k, centerX + k + 1, color);
+    }
+}
+
+void rle_circle(RleImage& img, float radius, float thickness, int centerX, int centerY, glm::vec3 color)
+{
+    if (centerX == -1) centerX = img.width() / 2;
+    if (centerY == -1) centerY = img.height() / 2;
+
+    const float outer = radius + thickness;
+    const float inner = radius - thickness;
+
+    for (int y{std::max(0, centerY - static_cast<int>(outer) - 1)}; y < std::min(img.height(), centerY + static_cast<int>(outer) + 2); y++)
+    {
+        const float dy = y - centerY;
+        auto distance = [&](int dx) { return std::sqrt(static_cast<float>(dx) * dx + dy * dy); };
+
+        // Même test que circle() : radius - thickness < distance < radius + thickness
+        const int k_outer = largest_offset([&](int dx) { return distance(dx) < outer; }, std::sqrt(std::max(0.f, outer * outer - dy * dy)));
+        if (k_outer < 0) continue;
+        const int k_inner = largest_offset([&](int dx) { return !(distance(dx) > inner); }, std::sqrt(std::max(0.f, inner * inner - dy * dy)));
+
+        if (k_inner < 0)
+        {
+            img.fill_span(y, centerX - k_outer, centerX + k_outer + 1, color);
+        }
+        else
+        {
+            img.fill_span(y, centerX - k_outer, centerX - k_inner, color);
+            img.fill_span(y, centerX + k_inner + 1, centerX + k_outer + 1, color);
+        }
+    }
+}
+
+void rle_rosette(RleImage& img, int circles, float tightness, float radius)
+{
+    const float centerX = img.width() / 2.f;
+    const float centerY = img.height() / 2.f;
+    const float offset = radius * 2 * tightness;
+
+    for (int i = 0; i < circles; ++i)
+    {
+        const float angle = (2.0f * std::numbers::pi * i) / circles;
+        const float cx = centerX + offset * std::cos(angle);
+        const float cy = centerY + offset * std::sin(angle);
+        rle_circle(img, radius, 3.f, static_cast<int>(cx), static_cast<int>(cy));
+    }
+
+    rle_circle(img, radius, 3.f, static_cast<int>(centerX), static_cast<int>(centerY));
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <sil/sil.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+/**
+ * Suite de `length` pixels consécutifs de la même couleur sur une ligne.
+ */
+struct Run
+{
+    int length;
+    glm::vec3 color;
+};
+
+/**
+ * Image stockée ligne par ligne sous forme de plages de couleur constante (run-length encoding).
+ * Adaptée aux images de synthèse presque entièrement unies (disques, cercles, rosaces...) : une ligne unie ne coûte qu'une plage
+ * au lieu de `width` pixels, et les opérations pixel par pixel ne sont calculées qu'une fois par plage.
+ * Comme pour sil::Image, la ligne y = 0 est en bas de l'image.
+ */
+class RleImage
+{
+public:
+    /// Crée une image unie (noire par défaut) : une seule plage par ligne.
+    RleImage(int width, int height, glm::vec3 background = glm::vec3{0.f});
+
+    /// Compresse une image dense.
+    static RleImage from_image(const sil::Image& img);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    /// Renvoie les plages de la ligne y, de gauche à droite. La somme de leurs longueurs vaut width().
+    std::vector<Run> const& row(int y) const { return _rows[y]; }
+
+    /// Renvoie la couleur du pixel (x, y) (parcourt les plages de la ligne).
+    glm::vec3 pixel(int x, int y) const;
+
+    /// Nombre total de plages, pour mesurer la compression.
+    size_t run_count() const;
+
+    /// Peint les pixels [x_begin, x_end) de la ligne y avec `color` (les bornes sont ramenées dans l'image).
+    void fill_span(int y, int x_begin, int x_end, glm::vec3 color);
+
+    /**
+     * Applique une opération pixel par pixel, une seule fois par plage.
+     * Exemple : img.transform([](glm::vec3 c) { return glm::vec3{1.f} - c; }); pour le négatif.
+     */
+    template<typename Func>
+    void transform(Func&& func)
+    {
+        for (std::vector<Run>& runs : _rows)
+        {
+            for (Run& run : runs)
+            {
+                run.color = func(run.color);
+            }
+            merge_runs(runs);
+        }
+    }
+
+    /**
+     * Combine cette image (dessous) avec `top` (dessus, de la même taille) : chaque pixel devient func(dessous, dessus).
+     * Les deux listes de plages sont parcourues ensemble, func n'est appelée qu'une fois par intersection de plages.
+     * Exemple : img.composite(other, [](glm::vec3 a, glm::vec3 b) { return glm::max(a, b); }); pour superposer deux dessins blancs.
+     */
+    template<typename Func>
+    void composite(const RleImage& top, Func&& func)
+    {
+        if (top.width() != _width || top.height() != _height) return;
+
+        for (int y{0}; y < _height; y++)
+        {
+            const std::vector<Run>& a = _rows[y];
+            const std::vector<Run>& b = top._rows[y];
+            std::vector<Run> result;
+            size_t i{0};
+            size_t j{0};
+            int a_left = a.empty() ? 0 : a[0].length;
+            int b_left = b.empty() ? 0 : b[0].length;
+
+            while (i < a.size() && j < b.size())
+            {
+                const int length = std::min(a_left, b_left);
+                result.push_back(Run{length, func(a[i].color, b[j].color)});
+                a_left -= length;
+                b_left -= length;
+                if (a_left == 0 && ++i < a.size()) a_left = a[i].length;
+                if (b_left == 0 && ++j < b.size()) b_left = b[j].length;
+            }
+
+            merge_runs(result);
+            _rows[y] = std::move(result);
+        }
+    }
+
+    /// Décompresse en image dense.
+    sil::Image to_image() const;
+
+    /// Enregistre l'image en png ou jpeg : chaque plage est convertie une seule fois en 8 bits puis recopiée dans le tampon de l'encodeur.
+    void save(std::filesystem::path path) const;
+
+private:
+    /// Fusionne les plages voisines de même couleur.
+    static void merge_runs(std::vector<Run>& runs);
+
+    int _width;
+    int _height;
+    std::vector<std::vector<Run>> _rows;
+};
+
+/**
+ * Dessine un disque, comme disk(), en émettant directement une plage par ligne.
+ *
+ * @param img Image à modifier (type RleImage), modifiée en place.
+ * @param radius Rayon du disque (par défaut 100.f).
+ * @param centerX Coordonnée x du centre du disque (par défaut -1, ce qui signifie centré horizontalement).
+ * @param centerY Coordonnée y du centre du disque (par défaut -1, ce qui signifie centré verticalement).
+ * @param color Couleur du disque (par défaut blanc).
+ */
+void rle_disk(RleImage& img, float radius = 100.f, int centerX = -1, int centerY = -1, glm::vec3 color = glm::vec3{1.f});
+
+/**
+ * Dessine un cercle, comme circle(), en émettant directement au plus deux plages par ligne.
+ *
+ * @param img Image à modifier (type RleImage), modifiée en place.
+ * @param radius Rayon du cercle (par défaut 100.f).
+ * @param thickness Épaisseur du cercle (par défaut 3.f).
+ * @param centerX Coordonnée x du centre du cercle (par défaut -1, ce qui signifie centré horizontalement).
+ * @param centerY Coordonnée y du centre du cercle (par défaut -1, ce qui signifie centré verticalement).
+ * @param color Couleur du cercle (par défaut blanc).
+ */
+void rle_circle(RleImage& img, float radius = 100.f, float thickness = 3.f, int centerX = -1, int centerY = -1, glm::vec3 color = glm::vec3{1.f});
+
+/**
+ * Dessine une rosace, comme rosette(), avec rle_circle().
+ *
+ * @param img Image à modifier (type RleImage), modifiée en place.
+ * @param circles Nombre de cercles dans la rosette (par défaut 6).
+ * @param tightness Facteur de serréité des cercles (par défaut 0.5f).
+ * @param radius Rayon des cercles (par défaut 100.f).
+ */
+void rle_rosette(RleImage& img, int circles = 6, float tightness = 0.5f, float radius = 100.f);
@@ -0,0 +1,29 @@
+#include "static_convolution.hpp"
+#include <sil/metrics.hpp>
+#include <sil/trace.hpp>
+#include <algorithm>
+
+void convolution_runtime(sil::Image& img, const std::vector<std::vector<float>>& kernel)
+{
+    SIL_TRACE_SCOPE("convolution_runtime");
+    SIL_EFFECT_METRICS("convolution_runtime", img.width() * img.height());
+    const int size = static_cast<int>(kernel.size());
+    if (size % 2 == 0 || std::any_of(kernel.begin(), kernel.end(), [&](const std::vector<float>& row) { return static_cast<int>(row.size()) != size; })) return;
+
+    const int radius = size / 2;
+    const sil::Image original = img;
+
+    for (int y = radius; y < img.height() - radius; ++y) {
+        for (int x = radius; x < img.width() - radius; ++x) {
+            glm::vec3 newColor{0.f, 0.f, 0.f};
+
+            for (int ky = -radius; ky <= radius; ++ky) {
+                for (int kx = -radius; kx <= radius; ++kx) {
+                    newColor += original.pixel(x + kx, y + ky) * kernel[ky + radius][kx + radius];
+                }
+            }
+
+            img.pixel(x, y) = newColor;
+        }
+    }
+}
@@ -0,0 +1,240 @@
+#pragma once
+#include <sil/sil.hpp>
+#include "parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * Noyau carré de taille impaire connu à la compilation, utilisable comme paramètre de template : convolution_static<noyau>(img).
+ * Comme dans convolution(), le poids (i, j) multiplie le pixel (x + i - Size / 2, y + j - Size / 2).
+ */
+template<int Size>
+struct StaticKernel
+{
+    static_assert(Size % 2 == 1, "La taille d'un noyau doit être impaire");
+
+    /// Poids ligne par ligne. Public pour que le noyau soit un type « structurel », utilisable comme paramètre de template.
+    std::array<float, Size * Size> weights;
+
+    static constexpr int size = Size;
+
+    constexpr float at(int i, int j) const { return weights[i + j * Size]; }
+
+    /// Même noyau sous la forme utilisée par getKernel() et convolution_runtime().
+    std::vector<std::vector<float>> to_vector() const
+    {
+        std::vector<std::vector<float>> rows(Size, std::vector<float>(Size));
+        for (int j{0}; j < Size; j++)
+        {
+            for (int i{0}; i < Size; i++) rows[j][i] = at(i, j);
+        }
+        return rows;
+    }
+};
+
+/// Noyaux de getKernel(), déclarés à la compilation.
+namespace kernels {
+inline constexpr StaticKernel<3> identity{{
+    0.f, 0.f, 0.f,
+    0.f, 1.f, 0.f,
+    0.f, 0.f, 0.f,
+}};
+inline constexpr StaticKernel<3> blur{{
+    0.0625f, 0.125f, 0.0625f,
+    0.125f,  0.25f,  0.125f,
+    0.0625f, 0.125f, 0.0625f,
+}};
+inline constexpr StaticKernel<3> sharpen{{
+     0.f, -1.f,  0.f,
+    -1.f,  5.f, -1.f,
+     0.f, -1.f,  0.f,
+}};
+inline constexpr StaticKernel<3> edge_detection{{
+    -1.f, -1.f, -1.f,
+    -1.f,  8.f, -1.f,
+    -1.f, -1.f, -1.f,
+}};
+} // namespace kernels
+
+namespace static_convolution_detail {
+
+/// Poids distinct du noyau et position de ses voisins dans KernelPlan::offsets : [first, first + count).
+struct WeightGroup
+{
+    float weight;
+    int first;
+    int count;
+};
+
+/// Voisin relatif au pixel courant.
+struct Offset
+{
+    int dx;
+    int dy;
+};
+
+/**
+ * Plan de calcul d'un noyau, entièrement évalué à la compilation : les poids nuls sont retirés et les voisins de même poids sont regroupés,
+ * pour être additionnés avant une seule multiplication (un noyau symétrique comme Blur ne coûte que 3 multiplications au lieu de 9).
+ */
+template<StaticKernel K>
+struct KernelPlan
+{
+    static constexpr int nonzero_count()
+    {
+        int count = 0;
+        for (const float weight : K.weights) count += weight != 0.f;
+        return count;
+    }
+
+    static constexpr int group_count()
+    {
+        int count = 0;
+        for (std::size_t i{0}; i < K.weights.size(); i++)
+        {
+            if (K.weights[i] == 0.f) continue;
+            bool seen = false;
+            for (std::size_t j{0}; j < i; j++) seen = seen || K.weights[j] == K.weights[i];
+            count += !seen;
+        }
+        return count;
+    }
+
+    static constexpr std::array<WeightGroup, group_count()> make_groups()
+    {
+        std::array<WeightGroup, group_count()> result{};
+        int group = 0;
+        int first = 0;
+        for (std::size_t i{0}; i < K.weights.size(); i++)
+        {
+            if (K.weights[i] == 0.f) continue;
+            bool seen = false;
+            for (std::size_t j{0}; j < i; j++) seen = seen || K.weights[j] == K.weights[i];
+            if (seen) continue;
+
+            int count = 0;
+            for (const float weight : K.weights) count += weight == K.weights[i];
+            result[group++] = {K.weights[i], first, count};
+            first += count;
+        }
+        return result;
+    }
+
+    static constexpr std::array<WeightGroup, group_count()> groups = make_groups();
+
+    static constexpr std::array<Offset, nonzero_count()> make_offsets()
+    {
+        std::array<Offset, nonzero_count()> result{};
+        for (const WeightGroup& group : groups)
+        {
+            int next = group.first;
+            for (int j{0}; j < K.size; j++)
+            {
+                for (int i{0}; i < K.size; i++)
+                {
+                    if (K.at(i, j) == group.weight) result[next++] = {i - K.size / 2, j - K.size / 2};
+                }
+            }
+        }
+        return result;
+    }
+
+    static constexpr std::array<Offset, nonzero_count()> offsets = make_offsets();
+
+    static constexpr bool is_identity()
+    {
+        if constexpr (nonzero_count() == 1)
+            return groups[0].weight == 1.f && offsets[0].dx == 0 && offsets[0].dy == 0;
+        else
+            return false;
+    }
+};
+
+/// `rows[j]` est la ligne y + j - Size / 2 de l'image d'entrée, et `x` la colonne du pixel calculé.
+template<StaticKernel K, int Group, std::size_t... Tap>
+inline glm::vec3 weighted_group(const glm::vec3* const* rows, int x, std::index_sequence<Tap...>)
+{
+    using Plan = KernelPlan<K>;
+    constexpr WeightGroup group = Plan::groups[Group];
+    constexpr int radius = K.size / 2;
+    const glm::vec3 sum = (rows[Plan::offsets[group.first + Tap].dy + radius][x + Plan::offsets[group.first + Tap].dx] + ...);
+    if constexpr (group.weight == 1.f)
+        return sum;
+    else if constexpr (group.weight == -1.f)
+        return -sum;
+    else
+        return sum * group.weight;
+}
+
+template<StaticKernel K, std::size_t... Group>
+inline glm::vec3 weighted_sum(const glm::vec3* const* rows, int x, std::index_sequence<Group...>)
+{
+    using Plan = KernelPlan<K>;
+    if constexpr (sizeof...(Group) == 0)
+        return glm::vec3{0.f};
+    else
+        return (weighted_group<K, Group>(rows, x, std::make_index_sequence<Plan::groups[Group].count>{}) + ...);
+}
+
+/**
+ * Calcule la ligne `out` à partir des lignes d'entrée rows[0] ... rows[Size - 1] (centrées sur la ligne calculée).
+ * Les `Size / 2` premières et dernières colonnes sont recopiées de la ligne centrale.
+ */
+template<StaticKernel K>
+inline void convolve_row(const glm::vec3* const* rows, glm::vec3* out, int width)
+{
+    using Plan = KernelPlan<K>;
+    constexpr int radius = K.size / 2;
+    const glm::vec3* center = rows[radius];
+    for (int x{0}; x < std::min(radius, width); x++) out[x] = center[x];
+    for (int x{radius}; x < width - radius; x++)
+    {
+        out[x] = weighted_sum<K>(rows, x, std::make_index_sequence<Plan::groups.size()>{});
+    }
+    for (int x{std::max(width - radius, radius)}; x < width; x++) out[x] = center[x];
+}
+
+} // namespace static_convolution_detail
+
+/**
+ * Applique à l'image une convolution dont le noyau est connu à la compilation.
+ * Le calcul de chaque pixel est entièrement déroulé : les poids nuls disparaissent, les voisins de même poids sont additionnés avant d'être multipliés,
+ * et les poids 1 et -1 ne coûtent aucune multiplication. Un noyau identité ne fait rien du tout.
+ * Comme dans convolution(), les pixels à moins de Size / 2 du bord ne sont pas modifiés.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ */
+template<StaticKernel K>
+void convolution_static(sil::Image& img)
+{
+    SIL_TRACE_SCOPE("convolution_static");
+    using Plan = static_convolution_detail::KernelPlan<K>;
+    if constexpr (Plan::is_identity()) return;
+
+    constexpr int radius = K.size / 2;
+    const int w = img.width();
+    const int h = img.height();
+    if (w <= 2 * radius || h <= 2 * radius) return;
+
+    const std::vector<glm::vec3> original = img.pixels();
+    parallel_for_bands(radius, h - radius, [&](int y_begin, int y_end) {
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            const glm::vec3* rows[K.size];
+            for (int j{0}; j < K.size; j++) rows[j] = original.data() + static_cast<std::size_t>(y + j - radius) * w;
+            static_convolution_detail::convolve_row<K>(rows, img.pixels().data() + static_cast<std::size_t>(y) * w, w);
+        }
+    });
+}
+
+/**
+ * Convolution dont le noyau n'est connu qu'à l'exécution (carré de taille impaire) : la boucle générique sur tous les poids.
+ * Sert pour les noyaux qui n'ont pas de version convolution_static<>.
+ *
+ * @param img Image à modifier (type sil::Image), modifiée en place.
+ * @param kernel Noyau, ligne par ligne (un noyau d'une autre forme laisse l'image inchangée).
+ */
+void convolution_runtime(sil::Image& img, const std::vector<std::vector<float>>& kernel);
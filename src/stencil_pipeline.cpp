@@ -0,0 +1,160 @@
+#include "stencil_pipeline.hpp"
+#include <sil/trace.hpp>
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+/**
+ * Anneau de lignes : la ligne y est rangée dans l'emplacement y % rows.
+ */
+struct LineRing
+{
+    int rows{0};
+    int width{0};
+    int available{0}; // Nombre de lignes déjà écrites (les lignes 0 ... available - 1, dont seules les `rows` dernières sont encore là)
+    std::vector<glm::vec3> pixels;
+
+    glm::vec3* row(int y) { return pixels.data() + static_cast<size_t>(y % rows) * width; }
+};
+
+} // namespace
+
+StencilPipeline& StencilPipeline::then(StencilStage stage)
+{
+    stage.above = std::max(stage.above, 0);
+    stage.below = std::max(stage.below, 0);
+    _stages.push_back(std::move(stage));
+    return *this;
+}
+
+std::size_t StencilPipeline::buffer_bytes(int width) const
+{
+    std::size_t bytes = 0;
+    for (const StencilStage& stage : _stages)
+    {
+        bytes += static_cast<std::size_t>(stage.above + stage.below + 1) * width * sizeof(glm::vec3);
+    }
+    return bytes;
+}
+
+void StencilPipeline::run(sil::Image& img)
+{
+    SIL_TRACE_SCOPE("StencilPipeline::run");
+    const int w = img.width();
+    const int h = img.height();
+    if (_stages.empty() || w == 0 || h == 0) return;
+
+    // rings[s] contient les lignes d'entrée de l'étape s (pour s = 0, des copies des lignes de l'image, qui est écrasée au fur et à mesure)
+    std::vector<LineRing> rings(_stages.size());
+    std::vector<std::vector<const glm::vec3*>> windows(_stages.size());
+    for (size_t s{0}; s < _stages.size(); s++)
+    {
+        const int window = _stages[s].above + _stages[s].below + 1;
+        rings[s].rows = std::min(window, h);
+        rings[s].width = w;
+        rings[s].pixels.resize(static_cast<size_t>(rings[s].rows) * w);
+        windows[s].resize(window);
+        if (_stages[s].begin) _stages[s].begin(w, h);
+    }
+
+    // Écrit la ligne y de la sortie de l'étape s dans `out`, après avoir demandé à l'étape précédente les lignes qui manquent
+    auto produce = [&](auto& self, size_t s, int y, glm::vec3* out) -> void {
+        const StencilStage& stage = _stages[s];
+        LineRing& ring = rings[s];
+
+        const int last = std::min(y + stage.below, h - 1);
+        while (ring.available <= last)
+        {
+            glm::vec3* row = ring.row(ring.available);
+            if (s == 0)
+                std::copy_n(&img.pixel(0, ring.available), w, row);
+            else
+                self(self, s - 1, ring.available, row);
+            ring.available++;
+        }
+
+        for (int dy{-stage.above}; dy <= stage.below; dy++)
+        {
+            windows[s][dy + stage.above] = ring.row(std::clamp(y + dy, 0, h - 1));
+        }
+        stage.row(StencilRows{windows[s].data(), stage.above, y, w, h}, out);
+    };
+
+    // Les lignes de l'image ne sont écrasées qu'une fois copiées dans l'anneau de la première étape
+    for (int y{0}; y < h; y++)
+    {
+        produce(produce, _stages.size() - 1, y, &img.pixel(0, y));
+    }
+}
+
+StencilStage box_blur_horizontal_stage(int size)
+{
+    return StencilStage{0, 0, nullptr, [size](const StencilRows& rows, glm::vec3* out) {
+        const glm::vec3* in = rows.row(0);
+        const int w = rows.width;
+        if (size <= 1)
+        {
+            std::copy_n(in, w, out);
+            return;
+        }
+
+        // Mêmes opérations, dans le même ordre, que la première passe de blur_convolution()
+        const int half = size / 2;
+        glm::vec3 sum{0.f};
+        for (int i = -half; i < -half + size; ++i) {
+            sum += in[std::clamp(i, 0, w - 1)];
+        }
+        out[0] = sum / static_cast<float>(size);
+
+        for (int x = 1; x < w; ++x) {
+            sum -= in[std::clamp(x - half - 1, 0, w - 1)];
+            sum += in[std::clamp(x - half + size - 1, 0, w - 1)];
+            out[x] = sum / static_cast<float>(size);
+        }
+    }};
+}
+
+StencilStage box_blur_vertical_stage(int size)
+{
+    if (size <= 1)
+    {
+        return StencilStage{0, 0, nullptr, [](const StencilRows& rows, glm::vec3* out) { std::copy_n(rows.row(0), rows.width, out); }};
+    }
+
+    // Somme glissante de chaque colonne, partagée entre begin et row
+    auto sums = std::make_shared<std::vector<glm::vec3>>();
+    const int half = size / 2;
+    const int first = -half;           // Première ligne de la fenêtre, relativement à la ligne calculée
+    const int last = -half + size - 1; // Dernière ligne de la fenêtre
+
+    return StencilStage{
+        half + 1, // La ligne qui sort de la fenêtre est celle juste au-dessus de la première
+        std::max(last, 0),
+        [sums](int width, int) { sums->assign(width, glm::vec3{0.f}); },
+        [sums, size, first, last](const StencilRows& rows, glm::vec3* out) {
+            std::vector<glm::vec3>& sum = *sums;
+            // Mêmes opérations, dans le même ordre pour chaque colonne, que la deuxième passe de blur_convolution()
+            if (rows.y == 0)
+            {
+                for (int j{first}; j <= last; j++)
+                {
+                    const glm::vec3* in = rows.row(j);
+                    for (int x{0}; x < rows.width; x++) sum[x] += in[x];
+                }
+            }
+            else
+            {
+                const glm::vec3* removed = rows.row(first - 1);
+                const glm::vec3* added = rows.row(last);
+                for (int x{0}; x < rows.width; x++)
+                {
+                    sum[x] -= removed[x];
+                    sum[x] += added[x];
+                }
+            }
+
+            for (int x{0}; x < rows.width; x++) out[x] = sum[x] / static_cast<float>(size);
+        },
+    };
+}
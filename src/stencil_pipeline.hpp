@@ -0,0 +1,84 @@
+#pragma once
+#include <sil/sil.hpp>
+#include "static_convolution.hpp"
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/**
+ * Lignes d'entrée visibles par une étape pendant le calcul de la ligne y : row(dy) est la ligne y + dy, pour dy entre -above et below.
+ * Les lignes hors de l'image sont remplacées par la ligne du bord la plus proche.
+ */
+struct StencilRows
+{
+    const glm::vec3* const* rows; // rows[dy + above]
+    int above;
+    int y;
+    int width;
+    int height;
+
+    const glm::vec3* row(int dy) const { return rows[dy + above]; }
+};
+
+/**
+ * Étape d'un StencilPipeline : calcule une ligne de sortie à partir des lignes y - above ... y + below de son entrée.
+ * Les lignes sont calculées dans l'ordre, de 0 à height - 1, ce qui permet à une étape de garder un état d'une ligne à l'autre (sommes glissantes).
+ */
+struct StencilStage
+{
+    int above{0};
+    int below{0};
+    /// Appelée avant la première ligne avec la taille de l'image (optionnelle), pour (ré)initialiser l'état de l'étape.
+    std::function<void(int width, int height)> begin;
+    /// Écrit la ligne rows.y de la sortie dans `out` (rows.width pixels).
+    std::function<void(const StencilRows& rows, glm::vec3* out)> row;
+};
+
+/**
+ * Enchaînement d'effets de voisinage calculé en un seul passage sur l'image, sans image intermédiaire :
+ * l'entrée de chaque étape n'est gardée que sur les above + below + 1 lignes dont elle a besoin, dans un anneau de lignes.
+ * Pour produire une ligne de sortie, chaque étape demande à la précédente juste les lignes qui lui manquent.
+ * Les résultats sont identiques à ceux des effets appliqués l'un après l'autre sur l'image entière.
+ */
+class StencilPipeline
+{
+public:
+    /// Ajoute une étape à la fin de la chaîne.
+    StencilPipeline& then(StencilStage stage);
+
+    /// Applique toute la chaîne à l'image, modifiée en place.
+    void run(sil::Image& img);
+
+    /// Mémoire occupée par les anneaux de lignes pour une image de largeur `width`, en octets.
+    std::size_t buffer_bytes(int width) const;
+
+private:
+    std::vector<StencilStage> _stages;
+};
+
+/// Première passe de blur_convolution(img, size) : moyenne glissante sur `size` pixels de chaque ligne.
+StencilStage box_blur_horizontal_stage(int size);
+
+/// Deuxième passe de blur_convolution(img, size) : moyenne glissante sur `size` lignes, une somme par colonne mise à jour à chaque ligne.
+StencilStage box_blur_vertical_stage(int size);
+
+/// Les deux passes de blur_convolution(img, size) à la suite.
+inline StencilPipeline& box_blur(StencilPipeline& pipeline, int size)
+{
+    return pipeline.then(box_blur_horizontal_stage(size)).then(box_blur_vertical_stage(size));
+}
+
+/// Convolution par un noyau connu à la compilation, identique à convolution_static<K>() (bords non modifiés).
+template<StaticKernel K>
+StencilStage kernel_stage()
+{
+    constexpr int radius = K.size / 2;
+    return StencilStage{radius, radius, nullptr, [](const StencilRows& rows, glm::vec3* out) {
+        if (rows.y < radius || rows.y >= rows.height - radius || rows.width <= 2 * radius)
+        {
+            std::copy_n(rows.row(0), rows.width, out);
+            return;
+        }
+        static_convolution_detail::convolve_row<K>(rows.rows + rows.above - radius, out, rows.width);
+    }};
+}
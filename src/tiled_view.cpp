@@ -0,0 +1,111 @@
+#include "tiled_view.hpp"
+#include <sil/trace.hpp>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+TiledView::TiledView(const sil::Image& source, int copies_x, int copies_y, Tiling tiling)
+    : _source{source}
+    , _copies_x{std::max(copies_x, 1)}
+    , _copies_y{std::max(copies_y, 1)}
+    , _tiling{tiling}
+{
+}
+
+int TiledView::source_x(int x) const
+{
+    const int width = _source.width();
+    const int src_x = x % width;
+    if (_tiling == Tiling::MirroredRepeat && (x / width) % 2 == 1)
+        return width - 1 - src_x;
+    return src_x;
+}
+
+int TiledView::source_y(int y) const
+{
+    const int height = _source.height();
+    const int src_y = y % height;
+    if (_tiling == Tiling::MirroredRepeat && (y / height) % 2 == 1)
+        return height - 1 - src_y;
+    return src_y;
+}
+
+void TiledView::copy_row(int y, glm::vec3* row) const
+{
+    const int width = _source.width();
+    const glm::vec3* src = _source.pixels().data() + static_cast<size_t>(source_y(y)) * width;
+
+    for (int tile{0}; tile < _copies_x; tile++)
+    {
+        glm::vec3* dst = row + static_cast<size_t>(tile) * width;
+        if (_tiling == Tiling::MirroredRepeat && tile % 2 == 1)
+            std::reverse_copy(src, src + width, dst);
+        else
+            std::copy(src, src + width, dst);
+    }
+}
+
+sil::Image TiledView::materialize() const
+{
+    SIL_TRACE_SCOPE("TiledView::materialize");
+    sil::Image img{width(), height()};
+    const size_t row_size = static_cast<size_t>(width());
+    glm::vec3* pixels = img.pixels().data();
+
+    // Les lignes de la première rangée de tuiles correspondent exactement aux lignes sources (source_y(y) == y)
+    for (int y{0}; y < _source.height(); y++)
+    {
+        copy_row(y, pixels + y * row_size);
+    }
+
+    // Toutes les autres lignes sont des copies de la ligne de la première rangée qui lit la même ligne source
+    for (int y{_source.height()}; y < height(); y++)
+    {
+        std::memcpy(pixels + y * row_size, pixels + static_cast<size_t>(source_y(y)) * row_size, row_size * sizeof(glm::vec3));
+    }
+
+    return img;
+}
+
+void TiledView::save(std::filesystem::path path) const
+{
+    SIL_TRACE_SCOPE("TiledView::save");
+    const int src_width = _source.width();
+    const int src_height = _source.height();
+
+    // Conversion de l'image source en 8 bits, une seule fois
+    auto source_bytes = std::make_unique<uint8_t[]>(static_cast<size_t>(src_width) * src_height * 3);
+    for (size_t i{0}; i < _source.pixels().size(); i++)
+    {
+        source_bytes[3 * i + 0] = sil::to_8bit(_source.pixels()[i].r);
+        source_bytes[3 * i + 1] = sil::to_8bit(_source.pixels()[i].g);
+        source_bytes[3 * i + 2] = sil::to_8bit(_source.pixels()[i].b);
+    }
+
+    const size_t tile_bytes = 3 * static_cast<size_t>(src_width);
+    const size_t row_bytes = tile_bytes * _copies_x;
+    auto data = std::make_unique<uint8_t[]>(row_bytes * height());
+
+    for (int y{0}; y < height(); y++)
+    {
+        const uint8_t* src = source_bytes.get() + static_cast<size_t>(source_y(y)) * tile_bytes;
+        uint8_t* dst = data.get() + static_cast<size_t>(y) * row_bytes;
+
+        for (int tile{0}; tile < _copies_x; tile++, dst += tile_bytes)
+        {
+            if (_tiling == Tiling::MirroredRepeat && tile % 2 == 1)
+            {
+                for (int x{0}; x < src_width; x++)
+                {
+                    std::memcpy(dst + 3 * x, src + 3 * (src_width - 1 - x), 3);
+                }
+            }
+            else
+            {
+                std::memcpy(dst, src, tile_bytes);
+            }
+        }
+    }
+
+    sil::save_rgb8(std::move(path), width(), height(), std::move(data));
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <sil/sil.hpp>
+#include <filesystem>
+
+enum class Tiling
+{
+    Repeat,        // Chaque tuile est une copie de l'image
+    MirroredRepeat // Les tuiles des colonnes impaires sont inversées horizontalement, celles des lignes impaires verticalement
+};
+
+/**
+ * Vue paresseuse sur une image répétée copies_x fois horizontalement et copies_y fois verticalement.
+ * Aucun pixel n'est copié à la création : les coordonnées sources sont calculées à la lecture,
+ * et l'image complète n'est construite que si on appelle materialize().
+ * La vue garde une référence sur l'image source, qui doit donc rester en vie tant que la vue est utilisée.
+ */
+class TiledView
+{
+public:
+    TiledView(const sil::Image& source, int copies_x, int copies_y, Tiling tiling = Tiling::Repeat);
+
+    int width() const { return _source.width() * _copies_x; }
+    int height() const { return _source.height() * _copies_y; }
+
+    /// Renvoie la couleur du pixel (x, y) de la vue, lue directement dans l'image source.
+    glm::vec3 const& pixel(int x, int y) const { return _source.pixel(source_x(x), source_y(y)); }
+
+    /// Coordonnée x dans l'image source correspondant à la colonne x de la vue.
+    int source_x(int x) const;
+    /// Coordonnée y dans l'image source correspondant à la ligne y de la vue.
+    int source_y(int y) const;
+
+    /// Écrit la ligne y de la vue dans `row` (width() pixels), tuile par tuile avec des copies de lignes entières (inversées pour les tuiles miroir).
+    void copy_row(int y, glm::vec3* row) const;
+
+    /// Construit l'image complète. Seules les lignes de la première rangée de tuiles sont assemblées, les suivantes sont des copies de ces lignes.
+    sil::Image materialize() const;
+
+    /// Enregistre la vue en png ou jpeg sans construire l'image complète en flottants :
+    /// l'image source est convertie une seule fois en 8 bits, puis chaque ligne du tampon de l'encodeur est remplie par copies d'octets.
+    void save(std::filesystem::path path) const;
+
+private:
+    const sil::Image& _source;
+    int _copies_x;
+    int _copies_y;
+    Tiling _tiling;
+};
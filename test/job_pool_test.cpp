@@ -0,0 +1,151 @@
+#include "test_helpers.hpp"
+#include <job_pool.hpp>
+#include <effect_chain.hpp>
+#include <effects.hpp>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Test des traitements asynchrones de JobPool : résultat identique à un appel direct, annulation d'un traitement en cours
+ * et d'un traitement en attente, progression croissante jusqu'à 1, et passage d'un traitement interactif devant un lot déjà lancé.
+ * Affiche le délai d'annulation et de préemption, et renvoie 1 si une vérification échoue.
+ *
+ * Usage : job_pool_test
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double milliseconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/// Traitement assez long pour être annulé ou préempté en cours de route (plusieurs secondes sans interruption).
+void heavy_effect(sil::Image& img)
+{
+    mandelbrotFractal(img, 20'000);
+}
+
+/// Attend que le traitement soit lancé par un thread du pool.
+void wait_running(const JobHandle& job)
+{
+    while (job.status() == JobStatus::Queued)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+}
+
+/// Renvoie true si get() lance JobCancelled.
+bool throws_cancelled(JobHandle& job)
+{
+    try
+    {
+        job.get();
+    }
+    catch (const JobCancelled&)
+    {
+        return true;
+    }
+    return false;
+}
+
+void test_same_result()
+{
+    JobPool pool;
+    const sil::Image input = make_input(256, 192);
+
+    sil::Image expected = input;
+    kuwahara(expected, 3);
+    JobHandle job = pool.submit(input, [](sil::Image& img) { kuwahara(img, 3); });
+    check(job.get().pixels() == expected.pixels(), "kuwahara par le pool ne donne pas le même résultat qu'un appel direct");
+
+    const EffectChain chain = EffectChain::parse("blur_convolution:5,negative,mandelbrotFractal:50");
+    expected = input;
+    chain.apply(expected);
+    JobHandle chained = pool.submit(input, chain);
+    check(chained.get().pixels() == expected.pixels(), "la chaîne d'effets par le pool ne donne pas le même résultat qu'un appel direct");
+    check(chained.status() == JobStatus::Finished, "statut Finished attendu après get()");
+}
+
+void test_cancel_running()
+{
+    JobPool pool;
+    JobHandle job = pool.submit(make_input(512, 512), heavy_effect);
+    wait_running(job);
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+
+    const Clock::time_point start = Clock::now();
+    job.cancel();
+    const bool cancelled = throws_cancelled(job);
+    const double delay = milliseconds_since(start);
+    std::cout << "Annulation d'un traitement en cours : " << delay << " ms\n";
+    check(cancelled, "get() doit lancer JobCancelled après cancel()");
+    check(job.status() == JobStatus::Cancelled, "statut Cancelled attendu après l'annulation");
+    check(job.progress() < 1.f, "un traitement annulé ne doit pas atteindre 100 %");
+}
+
+void test_progress()
+{
+    JobPool pool;
+    std::vector<float> reported;
+    JobOptions options;
+    options.on_progress = [&](float value) { reported.push_back(value); };
+    JobHandle job = pool.submit(make_input(512, 512), EffectChain::parse("kuwahara:3,blur_convolution:7"), options);
+    job.get();
+
+    bool increasing = true;
+    for (size_t i{1}; i < reported.size(); i++)
+    {
+        increasing = increasing && reported[i] > reported[i - 1];
+    }
+    check(reported.size() > 10, "la progression doit être signalée plusieurs fois (" + std::to_string(reported.size()) + " appels)");
+    check(increasing, "la progression doit être croissante");
+    check(!reported.empty() && reported.back() == 1.f && job.progress() == 1.f, "la progression doit finir à 1");
+}
+
+void test_priority()
+{
+    JobPool pool{1}; // Un seul thread : le traitement interactif ne peut passer que par préemption
+    JobOptions batch;
+    batch.priority = JobPriority::Batch;
+    JobHandle background = pool.submit(make_input(512, 512), heavy_effect, batch);
+    wait_running(background);
+
+    const Clock::time_point start = Clock::now();
+    JobOptions interactive;
+    interactive.priority = JobPriority::Interactive;
+    JobHandle preview = pool.submit(make_input(128, 128), [](sil::Image& img) { negative(img); }, interactive);
+    const bool done = preview.wait_for(std::chrono::milliseconds{5'000});
+    std::cout << "Traitement interactif pendant un lot : " << milliseconds_since(start) << " ms\n";
+    check(done && preview.status() == JobStatus::Finished, "le traitement interactif doit se terminer pendant le lot");
+    check(background.status() == JobStatus::Running, "le lot doit toujours être en cours après le traitement interactif");
+
+    // Un traitement de même priorité attend son tour, et peut être annulé avant d'être lancé
+    JobHandle queued = pool.submit(make_input(64, 64), [](sil::Image& img) { negative(img); }, batch);
+    check(pool.pending() == 1, "un traitement en attente attendu");
+    queued.cancel();
+    check(queued.wait_for(std::chrono::milliseconds{0}) && throws_cancelled(queued), "un traitement en attente annulé doit se terminer tout de suite");
+    check(queued.status() == JobStatus::Cancelled && pool.pending() == 0, "le traitement annulé ne doit plus être en attente");
+
+    background.cancel();
+    check(throws_cancelled(background), "le lot annulé doit lancer JobCancelled");
+}
+
+} // namespace
+
+int main()
+{
+    test_same_result();
+    test_cancel_running();
+    test_progress();
+    test_priority();
+
+    const int result = test_result();
+    if (result == 0) std::cout << "JobPool : toutes les vérifications sont passées\n";
+    return result;
+}
@@ -0,0 +1,83 @@
+#include "test_helpers.hpp"
+#include <masked.hpp>
+#include <effects.hpp>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * Test de apply_masked : l'effet n'est appliqué qu'à l'intérieur du masque, et un effet qui change la taille de la région,
+ * ou un masque d'une autre taille que l'image, lance std::invalid_argument sans modifier l'image.
+ * Renvoie 1 si une vérification échoue.
+ *
+ * Usage : masked_test
+ */
+
+namespace {
+
+/// Masque de width x height, plein sur la moitié gauche.
+sil::Image left_half(int width, int height)
+{
+    sil::Image mask{width, height};
+    for (int y{0}; y < height; y++)
+    {
+        for (int x{0}; x < width / 2; x++) mask.pixel(x, y) = glm::vec3{1.f};
+    }
+    return mask;
+}
+
+/// Renvoie true si apply_masked lance std::invalid_argument et laisse l'image intacte.
+bool rejects(sil::Image img, const MaskTiles& mask, const std::function<void(sil::Image&)>& effect)
+{
+    const sil::Image original = img;
+    try
+    {
+        apply_masked(img, mask, effect);
+    }
+    catch (const std::invalid_argument&)
+    {
+        return img.pixels() == original.pixels();
+    }
+    return false;
+}
+
+void test_inside_mask_only()
+{
+    const sil::Image input = make_input(96, 64);
+    sil::Image img = input;
+    apply_masked(img, MaskTiles{left_half(96, 64), 16}, [](sil::Image& region) { negative(region); });
+
+    bool inside = true;
+    bool outside = true;
+    for (int y{0}; y < img.height(); y++)
+    {
+        for (int x{0}; x < img.width(); x++)
+        {
+            if (x < img.width() / 2) inside = inside && img.pixel(x, y) == glm::vec3{1.f} - input.pixel(x, y);
+            else outside = outside && img.pixel(x, y) == input.pixel(x, y);
+        }
+    }
+    check(inside, "l'effet doit être appliqué dans le masque");
+    check(outside, "l'image ne doit pas changer hors du masque");
+}
+
+void test_rejected()
+{
+    const sil::Image input = make_input(96, 64);
+    const MaskTiles mask{left_half(96, 64), 16};
+    check(rejects(input, mask, [](sil::Image& region) { region = sil::Image{region.width() / 2, region.height()}; }),
+          "un effet qui change la taille de la région doit être refusé");
+    check(rejects(input, MaskTiles{left_half(32, 32), 16}, [](sil::Image& region) { negative(region); }),
+          "un masque d'une autre taille que l'image doit être refusé");
+}
+
+} // namespace
+
+int main()
+{
+    test_inside_mask_only();
+    test_rejected();
+
+    const int result = test_result();
+    if (result == 0) std::cout << "apply_masked : toutes les vérifications sont passées\n";
+    return result;
+}
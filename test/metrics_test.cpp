@@ -0,0 +1,157 @@
+#include "test_helpers.hpp"
+#include <effects.hpp>
+#include <median.hpp>
+#include <morphology.hpp>
+#include <sil/metrics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Test des métriques de sil/metrics.hpp : précision des seaux des histogrammes, compteurs incrémentés par plusieurs threads,
+ * métriques relevées par les effets, les chargements et les enregistrements, et fichiers écrits par MetricsExporter.
+ * Renvoie 1 si une vérification échoue.
+ *
+ * Usage : metrics_test
+ */
+
+namespace {
+
+bool contains(const std::string& text, const std::string& part)
+{
+    return text.find(part) != std::string::npos;
+}
+
+void test_buckets()
+{
+    bool inside = true;
+    double worst = 0.;
+    for (int64_t value{1}; value < (int64_t{1} << 40); value = value * 9 / 8 + 1)
+    {
+        const int index = sil::LatencyHistogram::bucket_index(value);
+        const int64_t lower = sil::LatencyHistogram::bucket_lower_bound(index);
+        const int64_t upper = sil::LatencyHistogram::bucket_upper_bound(index);
+        inside = inside && lower <= value && value < upper;
+        if (lower >= sil::LatencyHistogram::sub_buckets) worst = std::max(worst, static_cast<double>(upper - lower) / static_cast<double>(lower)); // En dessous, les seaux sont exacts
+    }
+    check(inside, "chaque durée doit tomber dans un seau qui la contient");
+    check(worst <= 1. / 16., "un seau ne doit pas être plus large que 1/16 de sa borne inférieure");
+    check(sil::LatencyHistogram::bucket_index(int64_t{1} << 50) == sil::LatencyHistogram::bucket_count - 1, "les durées trop longues vont dans le dernier seau");
+
+    sil::LatencyHistogram histogram;
+    for (int64_t microseconds{1}; microseconds <= 10'000; microseconds++)
+    {
+        histogram.record(microseconds * 1000);
+    }
+    const sil::LatencyHistogram::Snapshot snapshot = histogram.snapshot();
+    const auto close_to = [](int64_t value, double expected) { return std::abs(static_cast<double>(value) - expected) <= expected / 16.; };
+    check(snapshot.count == 10'000 && snapshot.max == 10'000'000, "nombre de durées et maximum");
+    check(close_to(snapshot.quantile(0.5), 5e6) && close_to(snapshot.quantile(0.99), 9.9e6), "médiane et 99e centile à 1/16 près");
+    check(snapshot.count_at_most(1'000'000) >= 940 && snapshot.count_at_most(1'000'000) <= 1060, "durées d'au plus 1 ms");
+}
+
+void test_concurrent_counter()
+{
+    sil::Counter& counter = sil::metrics_counter("metrics_test_total");
+    std::vector<std::thread> threads;
+    for (int i{0}; i < 4; i++)
+    {
+        threads.emplace_back([&counter]() {
+            for (int n{0}; n < 100'000; n++)
+            {
+                counter.add();
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    check(counter.value() == 400'000, "le compteur doit compter chaque incrément de chaque thread");
+    check(&sil::metrics_counter("metrics_test_total") == &counter, "le même nom doit donner le même compteur");
+}
+
+/// Valeur d'un compteur dans un relevé (0 s'il n'existe pas).
+int64_t counter_value(const sil::MetricsSnapshot& snapshot, const std::string& name, const std::string& labels)
+{
+    for (const sil::MetricsSnapshot::Value& counter : snapshot.counters)
+    {
+        if (counter.name == name && counter.labels == labels) return counter.value;
+    }
+    return 0;
+}
+
+void test_effects_and_files(const std::filesystem::path& directory)
+{
+    const sil::MetricsSnapshot before = sil::take_metrics_snapshot();
+    sil::Image img{64, 32};
+    for (int i{0}; i < 3; i++)
+    {
+        negative(img);
+    }
+    median_filter(img, 1);
+    opening(img);
+    const std::filesystem::path saved = directory / "negative.png";
+    img.save(saved);
+    const sil::Image loaded{saved};
+    const sil::MetricsSnapshot after = sil::take_metrics_snapshot();
+
+    const auto increase = [&](const std::string& name, const std::string& labels) { return counter_value(after, name, labels) - counter_value(before, name, labels); };
+    check(increase("sil_effect_runs_total", "effect=\"negative\"") == 3, "3 appels de negative attendus");
+    check(increase("sil_effect_pixels_total", "effect=\"negative\"") == 3 * 64 * 32, "pixels traités par negative");
+    // Les effets qui en appellent d'autres ne comptent qu'une fois
+    check(increase("sil_effect_runs_total", "effect=\"median_filter\"") == 1, "un appel de median_filter sur une image flottante ne compte qu'une fois");
+    check(increase("sil_effect_runs_total", "effect=\"opening\"") == 1 && increase("sil_effect_runs_total", "effect=\"erode\"") == 0
+              && increase("sil_effect_runs_total", "effect=\"dilate\"") == 0, "opening compte sous son propre nom, sans erode ni dilate");
+    check(increase("sil_save_images_total", "format=\"png\"") == 1 && increase("sil_load_images_total", "") == 1, "un enregistrement et un chargement attendus");
+    const auto file_size = static_cast<int64_t>(std::filesystem::file_size(saved));
+    check(increase("sil_save_bytes_total", "format=\"png\"") == file_size && increase("sil_load_bytes_total", "") == file_size, "octets enregistrés et chargés");
+}
+
+void test_exporter(const std::filesystem::path& directory)
+{
+    {
+        sil::MetricsExporter exporter{directory, std::chrono::milliseconds{20}};
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        check(std::filesystem::exists(directory / "metrics.prom") && std::filesystem::exists(directory / "metrics.json"), "les fichiers doivent être écrits pendant que le programme travaille");
+        sil::Image img{16, 16};
+        negative(img);
+    }
+
+    // La dernière écriture, à la destruction, compte le 4e appel de negative
+    const std::string prometheus = read_file(directory / "metrics.prom");
+    check(contains(prometheus, "# TYPE sil_effect_runs_total counter\n"), "ligne TYPE des compteurs");
+    check(contains(prometheus, "sil_effect_runs_total{effect=\"negative\"} 4\n"), "compteur d'appels de negative");
+    check(contains(prometheus, "# TYPE sil_effect_seconds histogram\n"), "ligne TYPE des histogrammes");
+    check(contains(prometheus, "sil_effect_seconds_bucket{effect=\"negative\",le=\"+Inf\"} 4\n"), "dernier seau de l'histogramme de negative");
+    check(contains(prometheus, "sil_effect_seconds_count{effect=\"negative\"} 4\n"), "nombre de durées de negative");
+
+    const std::string json = read_file(directory / "metrics.json");
+    check(contains(json, "{\"name\": \"sil_effect_runs_total\", \"labels\": {\"effect\": \"negative\"}, \"value\": 4, \"per_second\": "), "compteur de negative dans le JSON");
+    check(contains(json, "\"p99_seconds\": "), "centiles dans le JSON");
+    check(!std::filesystem::exists(directory / "metrics.prom.tmp"), "le fichier temporaire doit être renommé");
+}
+
+} // namespace
+
+int main()
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "image_editor_metrics_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    test_buckets();
+    test_concurrent_counter();
+    test_effects_and_files(directory);
+    test_exporter(directory);
+    std::filesystem::remove_all(directory);
+
+    const int result = test_result();
+    if (result == 0) std::cout << "Métriques : toutes les vérifications sont passées\n";
+    return result;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <sil/sil.hpp>
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+
+/**
+ * Outils communs aux programmes de test (test/, server/) : compte des vérifications échouées, image d'entrée déterministe,
+ * lecture d'un fichier et des options "--nom valeur" de la ligne de commande.
+ */
+
+/// Nombre de vérifications échouées depuis le début du programme.
+inline int failures = 0;
+
+/// Compte un échec et affiche `message` si `condition` est fausse.
+inline void check(bool condition, const std::string& message)
+{
+    if (condition) return;
+    std::cerr << "Échec : " << message << "\n";
+    failures++;
+}
+
+/// Valeur de retour de main() : 1 (après avoir affiché le nombre d'échecs) si une vérification a échoué, 0 sinon.
+inline int test_result()
+{
+    if (failures == 0) return 0;
+    std::cerr << failures << " échec(s)\n";
+    return 1;
+}
+
+/// Image d'entrée déterministe (dégradés et motif), différente pour chaque `variant`.
+inline sil::Image make_input(int width, int height, int variant = 0)
+{
+    sil::Image img{width, height};
+    for (int y{0}; y < height; y++)
+    {
+        for (int x{0}; x < width; x++)
+        {
+            img.pixel(x, y) = glm::vec3{static_cast<float>((x + 29 * variant) % 97) / 96.f, static_cast<float>((y + 17 * variant) % 61) / 60.f,
+                                        static_cast<float>((x * y + variant) % 13) / 12.f};
+        }
+    }
+    return img;
+}
+
+/// Contenu d'un fichier (vide s'il n'existe pas).
+inline std::string read_file(const std::filesystem::path& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+/// Reçoit la valeur d'une option ; lance une exception si elle est invalide.
+using OptionSetter = std::function<void(const std::string&)>;
+
+/// Option entière, ramenée à au moins `minimum`.
+inline OptionSetter int_option(int& value, int minimum = 1)
+{
+    return [&value, minimum](const std::string& text) { value = std::max(std::stoi(text), minimum); };
+}
+
+/// Option texte.
+inline OptionSetter string_option(std::string& value)
+{
+    return [&value](const std::string& text) { value = text; };
+}
+
+/**
+ * Lit les options "--nom valeur" de la ligne de commande.
+ * Renvoie false, après avoir affiché l'erreur, pour une option inconnue, une valeur manquante ou une valeur invalide (main() renvoie alors 2).
+ */
+inline bool parse_options(int argc, char** argv, const std::map<std::string, OptionSetter>& options)
+{
+    for (int i{1}; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const auto option = options.find(arg);
+        if (option == options.end())
+        {
+            std::cerr << "Option inconnue : " << arg << "\n";
+            return false;
+        }
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Valeur manquante après " << arg << "\n";
+            return false;
+        }
+        try
+        {
+            option->second(argv[++i]);
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Valeur invalide pour " << arg << " : " << argv[i] << "\n";
+            return false;
+        }
+    }
+    return true;
+}